@@ -83,10 +83,23 @@ void Config::ReadValues() {
 
     // Core
     Settings::values.use_cpu_jit = sdl2_config->GetBoolean("Core", "use_cpu_jit", true);
+    Settings::values.use_translation_disk_cache =
+        sdl2_config->GetBoolean("Core", "use_translation_disk_cache", false);
+    Settings::values.use_idle_loop_skipping =
+        sdl2_config->GetBoolean("Core", "use_idle_loop_skipping", true);
+    Settings::values.idle_loop_skipping_disabled_titles =
+        sdl2_config->Get("Core", "idle_loop_skipping_disabled_titles", "");
+    Settings::values.use_adaptive_slicing =
+        sdl2_config->GetBoolean("Core", "use_adaptive_slicing", false);
+    Settings::values.use_async_service_requests =
+        sdl2_config->GetBoolean("Core", "use_async_service_requests", false);
 
     // Renderer
     Settings::values.use_hw_renderer = sdl2_config->GetBoolean("Renderer", "use_hw_renderer", true);
     Settings::values.use_shader_jit = sdl2_config->GetBoolean("Renderer", "use_shader_jit", true);
+    Settings::values.use_gpu_thread = sdl2_config->GetBoolean("Renderer", "use_gpu_thread", false);
+    Settings::values.use_shader_disk_cache =
+        sdl2_config->GetBoolean("Renderer", "use_shader_disk_cache", false);
     Settings::values.resolution_factor =
         (float)sdl2_config->GetReal("Renderer", "resolution_factor", 1.0);
     Settings::values.use_vsync = sdl2_config->GetBoolean("Renderer", "use_vsync", false);
@@ -156,6 +169,10 @@ void Config::ReadValues() {
     Settings::values.use_gdbstub = sdl2_config->GetBoolean("Debugging", "use_gdbstub", false);
     Settings::values.gdbstub_port =
         static_cast<u16>(sdl2_config->GetInteger("Debugging", "gdbstub_port", 24689));
+    Settings::values.enable_cpu_profiler =
+        sdl2_config->GetBoolean("Debugging", "enable_cpu_profiler", false);
+    Settings::values.cpu_profiler_sample_rate = static_cast<u32>(
+        sdl2_config->GetInteger("Debugging", "cpu_profiler_sample_rate", 1000));
 
     // Web Service
     Settings::values.enable_telemetry =
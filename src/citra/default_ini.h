@@ -71,6 +71,29 @@ touch_device=
 # 0: Interpreter (slow), 1 (default): JIT (fast)
 use_cpu_jit =
 
+# Whether to keep the blocks decoded by the interpreter on disk, and decode them when the same title
+# is booted again instead of while it runs. Has no effect with the JIT.
+# 0 (default): No, 1: Yes
+use_translation_disk_cache =
+
+# Whether to skip ahead to the next event when the guest spins in a loop that polls memory.
+# Has no effect with the JIT.
+# 0: No, 1 (default): Yes
+use_idle_loop_skipping =
+
+# Comma-separated list of title IDs (in hexadecimal) for which idle loops are never skipped
+idle_loop_skipping_disabled_titles =
+
+# Whether to run the CPU for longer between two timing updates while nothing happens, and for
+# shorter while threads frequently wait for each other.
+# 0 (default): No, 1: Yes
+use_adaptive_slicing =
+
+# Whether services do their file and network I/O on worker threads, with the requesting thread
+# asleep, instead of stalling the emulated CPU.
+# 0 (default): No, 1: Yes
+use_async_service_requests =
+
 [Renderer]
 # Whether to use software or hardware rendering.
 # 0: Software, 1 (default): Hardware
@@ -80,6 +103,15 @@ use_hw_renderer =
 # 0: Interpreter (slow), 1 (default): JIT (fast)
 use_shader_jit =
 
+# Whether to process the GPU command lists on a separate thread. Only used by software rendering.
+# 0 (default): Off, 1: On
+use_gpu_thread =
+
+# Whether to keep the shaders used by a title on disk, and compile them when the same title is
+# booted again instead of when they are first used.
+# 0 (default): No, 1: Yes
+use_shader_disk_cache =
+
 # Resolution scale factor
 # 0: Auto (scales resolution to window size), 1: Native 3DS screen resolution, Otherwise a scale
 # factor for the 3DS resolution
@@ -178,6 +210,11 @@ log_filter = *:Info
 # Port for listening to GDB connections.
 use_gdbstub=false
 gdbstub_port=24689
+# Samples the emulated CPU and writes a report of the hottest code to the log directory on exit
+# 0 (default): Off, 1: On
+enable_cpu_profiler =
+# Number of samples taken per second of emulated time. Default: 1000
+cpu_profiler_sample_rate =
 
 [WebService]
 # Whether or not to enable telemetry
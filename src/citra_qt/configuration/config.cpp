@@ -68,11 +68,24 @@ void Config::ReadValues() {
 
     qt_config->beginGroup("Core");
     Settings::values.use_cpu_jit = qt_config->value("use_cpu_jit", true).toBool();
+    Settings::values.use_translation_disk_cache =
+        qt_config->value("use_translation_disk_cache", false).toBool();
+    Settings::values.use_idle_loop_skipping =
+        qt_config->value("use_idle_loop_skipping", true).toBool();
+    Settings::values.idle_loop_skipping_disabled_titles =
+        qt_config->value("idle_loop_skipping_disabled_titles", "").toString().toStdString();
+    Settings::values.use_adaptive_slicing =
+        qt_config->value("use_adaptive_slicing", false).toBool();
+    Settings::values.use_async_service_requests =
+        qt_config->value("use_async_service_requests", false).toBool();
     qt_config->endGroup();
 
     qt_config->beginGroup("Renderer");
     Settings::values.use_hw_renderer = qt_config->value("use_hw_renderer", true).toBool();
     Settings::values.use_shader_jit = qt_config->value("use_shader_jit", true).toBool();
+    Settings::values.use_gpu_thread = qt_config->value("use_gpu_thread", false).toBool();
+    Settings::values.use_shader_disk_cache =
+        qt_config->value("use_shader_disk_cache", false).toBool();
     Settings::values.resolution_factor = qt_config->value("resolution_factor", 1.0).toFloat();
     Settings::values.use_vsync = qt_config->value("use_vsync", false).toBool();
     Settings::values.toggle_framelimit = qt_config->value("toggle_framelimit", true).toBool();
@@ -138,6 +151,9 @@ void Config::ReadValues() {
     qt_config->beginGroup("Debugging");
     Settings::values.use_gdbstub = qt_config->value("use_gdbstub", false).toBool();
     Settings::values.gdbstub_port = qt_config->value("gdbstub_port", 24689).toInt();
+    Settings::values.enable_cpu_profiler = qt_config->value("enable_cpu_profiler", false).toBool();
+    Settings::values.cpu_profiler_sample_rate =
+        qt_config->value("cpu_profiler_sample_rate", 1000).toUInt();
     qt_config->endGroup();
 
     qt_config->beginGroup("WebService");
@@ -231,11 +247,20 @@ void Config::SaveValues() {
 
     qt_config->beginGroup("Core");
     qt_config->setValue("use_cpu_jit", Settings::values.use_cpu_jit);
+    qt_config->setValue("use_translation_disk_cache", Settings::values.use_translation_disk_cache);
+    qt_config->setValue("use_idle_loop_skipping", Settings::values.use_idle_loop_skipping);
+    qt_config->setValue(
+        "idle_loop_skipping_disabled_titles",
+        QString::fromStdString(Settings::values.idle_loop_skipping_disabled_titles));
+    qt_config->setValue("use_adaptive_slicing", Settings::values.use_adaptive_slicing);
+    qt_config->setValue("use_async_service_requests", Settings::values.use_async_service_requests);
     qt_config->endGroup();
 
     qt_config->beginGroup("Renderer");
     qt_config->setValue("use_hw_renderer", Settings::values.use_hw_renderer);
     qt_config->setValue("use_shader_jit", Settings::values.use_shader_jit);
+    qt_config->setValue("use_gpu_thread", Settings::values.use_gpu_thread);
+    qt_config->setValue("use_shader_disk_cache", Settings::values.use_shader_disk_cache);
     qt_config->setValue("resolution_factor", (double)Settings::values.resolution_factor);
     qt_config->setValue("use_vsync", Settings::values.use_vsync);
     qt_config->setValue("toggle_framelimit", Settings::values.toggle_framelimit);
@@ -298,6 +323,8 @@ void Config::SaveValues() {
     qt_config->beginGroup("Debugging");
     qt_config->setValue("use_gdbstub", Settings::values.use_gdbstub);
     qt_config->setValue("gdbstub_port", Settings::values.gdbstub_port);
+    qt_config->setValue("enable_cpu_profiler", Settings::values.enable_cpu_profiler);
+    qt_config->setValue("cpu_profiler_sample_rate", Settings::values.cpu_profiler_sample_rate);
     qt_config->endGroup();
 
     qt_config->beginGroup("WebService");
@@ -4,18 +4,18 @@
 
 #pragma once
 
+#include <cstring>
 #include <fstream>
 #include "common/common_types.h"
-
-// defined in Version.cpp
-extern const char* scm_rev_git_str;
+#include "common/file_util.h"
+#include "common/scm_rev.h"
 
 // On disk format:
 // header{
 // u32 'DCAC';
-// u32 version;  // svn_rev
 // u16 sizeof(key_type);
 // u16 sizeof(value_type);
+// char version[40];  // git revision
 //}
 
 // key_value_pair{
@@ -102,7 +102,7 @@ public:
         // failed to open file for reading or bad header
         // close and recreate file
         Close();
-        m_file.open(filename, ios_base::out | ios_base::trunc | ios_base::binary);
+        OpenFStream(m_file, filename, ios_base::out | ios_base::trunc | ios_base::binary);
         WriteHeader();
         return 0;
     }
@@ -153,12 +153,12 @@ private:
 
     struct Header {
         Header() : id(*(u32*)"DCAC"), key_t_size(sizeof(K)), value_t_size(sizeof(V)) {
-            memcpy(ver, scm_rev_git_str, 40);
+            std::strncpy(ver, Common::g_scm_rev, sizeof(ver));
         }
 
         const u32 id;
         const u16 key_t_size, value_t_size;
-        char ver[40];
+        char ver[40] = {};
 
     } m_header;
 
@@ -0,0 +1,79 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "common/assert.h"
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * Allocates the memory of objects of type T from slabs of SlabSize contiguous slots, so that the
+ * objects are close to each other and don't go through the heap one by one. Freed slots are handed
+ * out again most recently freed first, while their memory is still in the cache. Slabs are only
+ * released along with the pool.
+ * This class is not thread-safe.
+ */
+template <typename T, size_t SlabSize = 64>
+class ObjectPool : NonCopyable {
+public:
+    /// Returns uninitialized memory for one T
+    void* Allocate() {
+        if (free_list == nullptr)
+            AddSlab();
+
+        Slot* slot = free_list;
+        free_list = slot->next_free;
+        ++num_allocated;
+        return slot;
+    }
+
+    /// Returns the memory of a destroyed T to the pool
+    void Free(void* object) {
+        DEBUG_ASSERT(num_allocated != 0);
+        Slot* slot = static_cast<Slot*>(object);
+        slot->next_free = free_list;
+        free_list = slot;
+        --num_allocated;
+    }
+
+    /// Returns the number of allocated objects
+    size_t GetNumAllocated() const {
+        return num_allocated;
+    }
+
+    /// Returns the number of objects the pool can hold before allocating another slab
+    size_t GetCapacity() const {
+        return slabs.size() * SlabSize;
+    }
+
+private:
+    union Slot {
+        Slot* next_free;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    void AddSlab() {
+        slabs.emplace_back(new Slot[SlabSize]);
+        Slot* slab = slabs.back().get();
+
+        // Link the slots in address order, so that consecutive allocations are contiguous
+        for (size_t i = 0; i < SlabSize - 1; ++i) {
+            slab[i].next_free = &slab[i + 1];
+        }
+        slab[SlabSize - 1].next_free = free_list;
+        free_list = slab;
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> slabs;
+    Slot* free_list = nullptr;
+    size_t num_allocated = 0;
+};
+
+} // namespace Common
@@ -0,0 +1,63 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include "common/assert.h"
+
+namespace Common {
+
+/**
+ * Non-owning view of a contiguous array of T, like the C++20 std::span. The viewed memory must
+ * outlive the span.
+ */
+template <typename T>
+class Span {
+public:
+    Span() = default;
+    Span(T* data, size_t size) : pointer(data), count(size) {}
+
+    /// Views the elements of a container with contiguous storage, like std::vector
+    template <typename Container>
+    Span(Container& container) : pointer(container.data()), count(container.size()) {}
+
+    T* data() const {
+        return pointer;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    T* begin() const {
+        return pointer;
+    }
+
+    T* end() const {
+        return pointer + count;
+    }
+
+    T& operator[](size_t index) const {
+        DEBUG_ASSERT(index < count);
+        return pointer[index];
+    }
+
+    /// Copies the viewed elements into a vector
+    std::vector<typename std::remove_const<T>::type> ToVector() const {
+        return {begin(), end()};
+    }
+
+private:
+    T* pointer = nullptr;
+    size_t count = 0;
+};
+
+} // namespace Common
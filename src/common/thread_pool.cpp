@@ -0,0 +1,64 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/thread.h"
+#include "common/thread_pool.h"
+
+namespace Common {
+
+ThreadPool::ThreadPool(size_t num_threads, const std::string& name) {
+    workers.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this, name);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    task_queued.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    task_queued.notify_one();
+}
+
+void ThreadPool::WaitIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    task_finished.wait(lock, [this] { return tasks.empty() && num_running_tasks == 0; });
+}
+
+void ThreadPool::WorkerLoop(const std::string& name) {
+    SetCurrentThreadName(name.c_str());
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        task_queued.wait(lock, [this] { return stopping || !tasks.empty(); });
+        // The queued tasks are still run when stopping
+        if (tasks.empty())
+            return;
+
+        std::function<void()> task = std::move(tasks.front());
+        tasks.pop_front();
+        ++num_running_tasks;
+
+        lock.unlock();
+        task();
+        lock.lock();
+
+        --num_running_tasks;
+        task_finished.notify_all();
+    }
+}
+
+} // namespace Common
@@ -0,0 +1,51 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Common {
+
+/**
+ * Fixed set of worker threads running the tasks submitted to it, in submission order. The pool
+ * waits for all the submitted tasks to finish before it is destroyed.
+ */
+class ThreadPool final {
+public:
+    /**
+     * Starts the worker threads.
+     * @param num_threads Number of worker threads.
+     * @param name Name of the worker threads, for debugging purposes.
+     */
+    ThreadPool(size_t num_threads, const std::string& name);
+    ~ThreadPool();
+
+    /// Queues a task to be run by the first available worker thread.
+    void Submit(std::function<void()> task);
+
+    /// Blocks until all the submitted tasks have finished.
+    void WaitIdle();
+
+private:
+    void WorkerLoop(const std::string& name);
+
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable task_queued;
+    std::condition_variable task_finished;
+    std::deque<std::function<void()>> tasks;
+    size_t num_running_tasks = 0;
+    bool stopping = false;
+};
+
+} // namespace Common
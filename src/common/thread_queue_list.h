@@ -5,156 +5,177 @@
 #pragma once
 
 #include <array>
-#include <deque>
-#include <boost/range/algorithm_ext/erase.hpp>
+#include "common/assert.h"
+#include "common/bit_set.h"
+#include "common/common_types.h"
 
 namespace Common {
 
-template <class T, unsigned int N>
+/// Links of an element of a ThreadQueueList. Embedded in the element to avoid any allocation.
+template <class T>
+struct ThreadQueueListHook {
+    T* prev = nullptr;
+    T* next = nullptr;
+    bool queued = false;
+};
+
+/**
+ * Queue of threads with one FIFO list per priority level, where lower levels have a higher
+ * priority. The lists are intrusive, linked through the `Hook` member of T, and a bitmap keeps
+ * track of the non-empty levels, so all operations besides `contains` are O(1).
+ * An element can only be in one list at a time.
+ */
+template <class T, unsigned int N, ThreadQueueListHook<T> T::*Hook>
 struct ThreadQueueList {
-    // TODO(yuriks): If performance proves to be a problem, the std::deques can be replaced with
-    //               (dynamically resizable) circular buffers to remove their overhead when
-    //               inserting and popping.
+    static_assert(N <= 64, "The priority bitmap has 64 levels at most");
 
     typedef unsigned int Priority;
 
     // Number of priority levels. (Valid levels are [0..NUM_QUEUES).)
     static const Priority NUM_QUEUES = N;
 
-    ThreadQueueList() {
-        first = nullptr;
-    }
-
     // Only for debugging, returns priority level.
-    Priority contains(const T& uid) {
+    Priority contains(const T* thread) const {
+        if (!(thread->*Hook).queued)
+            return -1;
+
         for (Priority i = 0; i < NUM_QUEUES; ++i) {
-            Queue& cur = queues[i];
-            if (std::find(cur.data.cbegin(), cur.data.cend(), uid) != cur.data.cend()) {
-                return i;
+            for (const T* cur = queues[i].front; cur != nullptr; cur = (cur->*Hook).next) {
+                if (cur == thread)
+                    return i;
             }
         }
 
         return -1;
     }
 
-    T get_first() {
-        Queue* cur = first;
-        while (cur != nullptr) {
-            if (!cur->data.empty()) {
-                return cur->data.front();
-            }
-            cur = cur->next_nonempty;
-        }
+    T* get_first() const {
+        if (nonempty_mask == 0)
+            return nullptr;
+        return queues[FirstNonEmpty()].front;
+    }
 
-        return T();
+    T* pop_first() {
+        if (nonempty_mask == 0)
+            return nullptr;
+        return pop_front(FirstNonEmpty());
     }
 
-    T pop_first() {
-        Queue* cur = first;
-        while (cur != nullptr) {
-            if (!cur->data.empty()) {
-                auto tmp = std::move(cur->data.front());
-                cur->data.pop_front();
-                return tmp;
-            }
-            cur = cur->next_nonempty;
-        }
+    T* pop_first_better(Priority priority) {
+        if (nonempty_mask == 0)
+            return nullptr;
 
-        return T();
+        const Priority first = FirstNonEmpty();
+        if (first >= priority)
+            return nullptr;
+        return pop_front(first);
     }
 
-    T pop_first_better(Priority priority) {
-        Queue* cur = first;
-        Queue* stop = &queues[priority];
-        while (cur < stop) {
-            if (!cur->data.empty()) {
-                auto tmp = std::move(cur->data.front());
-                cur->data.pop_front();
-                return tmp;
-            }
-            cur = cur->next_nonempty;
+    void push_front(Priority priority, T* thread) {
+        ThreadQueueListHook<T>& hook = thread->*Hook;
+        DEBUG_ASSERT_MSG(!hook.queued, "Thread is already queued");
+        Queue& cur = queues[priority];
+
+        hook.prev = nullptr;
+        hook.next = cur.front;
+        hook.queued = true;
+        if (cur.front != nullptr) {
+            (cur.front->*Hook).prev = thread;
+        } else {
+            cur.back = thread;
+            nonempty_mask |= 1ULL << priority;
         }
-
-        return T();
+        cur.front = thread;
     }
 
-    void push_front(Priority priority, const T& thread_id) {
-        Queue* cur = &queues[priority];
-        cur->data.push_front(thread_id);
+    void push_back(Priority priority, T* thread) {
+        ThreadQueueListHook<T>& hook = thread->*Hook;
+        DEBUG_ASSERT_MSG(!hook.queued, "Thread is already queued");
+        Queue& cur = queues[priority];
+
+        hook.prev = cur.back;
+        hook.next = nullptr;
+        hook.queued = true;
+        if (cur.back != nullptr) {
+            (cur.back->*Hook).next = thread;
+        } else {
+            cur.front = thread;
+            nonempty_mask |= 1ULL << priority;
+        }
+        cur.back = thread;
     }
 
-    void push_back(Priority priority, const T& thread_id) {
-        Queue* cur = &queues[priority];
-        cur->data.push_back(thread_id);
+    void move(T* thread, Priority old_priority, Priority new_priority) {
+        remove(old_priority, thread);
+        push_back(new_priority, thread);
     }
 
-    void move(const T& thread_id, Priority old_priority, Priority new_priority) {
-        remove(old_priority, thread_id);
-        prepare(new_priority);
-        push_back(new_priority, thread_id);
-    }
+    /// Removes a thread from the list of the given priority. Does nothing if it isn't queued.
+    void remove(Priority priority, T* thread) {
+        ThreadQueueListHook<T>& hook = thread->*Hook;
+        if (!hook.queued)
+            return;
+
+        Queue& cur = queues[priority];
+        if (hook.prev != nullptr) {
+            (hook.prev->*Hook).next = hook.next;
+        } else {
+            DEBUG_ASSERT_MSG(cur.front == thread, "Thread is queued with another priority");
+            cur.front = hook.next;
+        }
+        if (hook.next != nullptr) {
+            (hook.next->*Hook).prev = hook.prev;
+        } else {
+            cur.back = hook.prev;
+        }
+        if (cur.front == nullptr)
+            nonempty_mask &= ~(1ULL << priority);
 
-    void remove(Priority priority, const T& thread_id) {
-        Queue* cur = &queues[priority];
-        boost::remove_erase(cur->data, thread_id);
+        hook = ThreadQueueListHook<T>();
     }
 
     void rotate(Priority priority) {
-        Queue* cur = &queues[priority];
+        Queue& cur = queues[priority];
 
-        if (cur->data.size() > 1) {
-            cur->data.push_back(std::move(cur->data.front()));
-            cur->data.pop_front();
-        }
+        if (cur.front != cur.back)
+            push_back(priority, pop_front(priority));
     }
 
     void clear() {
-        queues.fill(Queue());
-        first = nullptr;
+        for (Queue& cur : queues) {
+            while (cur.front != nullptr) {
+                T* next = (cur.front->*Hook).next;
+                cur.front->*Hook = ThreadQueueListHook<T>();
+                cur.front = next;
+            }
+            cur.back = nullptr;
+        }
+        nonempty_mask = 0;
     }
 
     bool empty(Priority priority) const {
-        const Queue* cur = &queues[priority];
-        return cur->data.empty();
-    }
-
-    void prepare(Priority priority) {
-        Queue* cur = &queues[priority];
-        if (cur->next_nonempty == UnlinkedTag())
-            link(priority);
+        return (nonempty_mask & (1ULL << priority)) == 0;
     }
 
 private:
     struct Queue {
-        // Points to the next active priority, skipping over ones that have never been used.
-        Queue* next_nonempty = UnlinkedTag();
-        // Double-ended queue of threads in this priority level
-        std::deque<T> data;
+        T* front = nullptr;
+        T* back = nullptr;
     };
 
-    /// Special tag used to mark priority levels that have never been used.
-    static Queue* UnlinkedTag() {
-        return reinterpret_cast<Queue*>(1);
+    Priority FirstNonEmpty() const {
+        return static_cast<Priority>(LeastSignificantSetBit(nonempty_mask));
     }
 
-    void link(Priority priority) {
-        Queue* cur = &queues[priority];
-
-        for (int i = priority - 1; i >= 0; --i) {
-            if (queues[i].next_nonempty != UnlinkedTag()) {
-                cur->next_nonempty = queues[i].next_nonempty;
-                queues[i].next_nonempty = cur;
-                return;
-            }
-        }
-
-        cur->next_nonempty = first;
-        first = cur;
+    T* pop_front(Priority priority) {
+        T* thread = queues[priority].front;
+        remove(priority, thread);
+        return thread;
     }
 
-    // The first queue that's ever been used.
-    Queue* first;
-    // The priority level queues of thread ids.
+    // Bit i is set when the level i has queued threads.
+    u64 nonempty_mask = 0;
+    // The priority level queues of threads.
     std::array<Queue, NUM_QUEUES> queues;
 };
 
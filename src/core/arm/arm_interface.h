@@ -44,6 +44,34 @@ public:
     /// Notify CPU emulation that page tables have changed
     virtual void PageTableChanged() = 0;
 
+    /**
+     * Opens the persistent translation cache of a title. The code cached by previous runs of the
+     * same code is translated before it is executed, and new code is added to the cache.
+     * @param program_id Program ID of the title.
+     * @param code_hash Hash of the code segment of the title.
+     * @param code_address Address of the code segment.
+     * @param code_size Size of the code segment in bytes.
+     */
+    virtual void LoadTranslationCache(u64 program_id, u64 code_hash, VAddr code_address,
+                                      u32 code_size) = 0;
+
+    /// Writes the code translated since LoadTranslationCache() to the persistent cache.
+    virtual void SaveTranslationCache() = 0;
+
+    /**
+     * Enables or disables idle loop skipping. An idle loop is a short loop that only reads memory
+     * and spins until the memory it polls changes. As only an event can change that memory, the
+     * rest of the timeslice is skipped once the CPU is found to be spinning in such a loop.
+     * @param enabled Whether idle loops are skipped.
+     */
+    virtual void SetIdleLoopSkipping(bool enabled) = 0;
+
+    /// Returns the number of times an idle loop was skipped.
+    virtual u64 GetNumSkippedIdleLoops() const = 0;
+
+    /// Returns the number of cycles skipped in idle loops.
+    virtual u64 GetSkippedIdleCycles() const = 0;
+
     /**
      * Set the Program Counter to an address
      * @param addr Address to set PC to
@@ -5,6 +5,7 @@
 #include <cstring>
 #include <dynarmic/dynarmic.h>
 #include "common/assert.h"
+#include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "core/arm/dynarmic/arm_dynarmic.h"
 #include "core/arm/dynarmic/arm_dynarmic_cp15.h"
@@ -189,6 +190,7 @@ void ARM_Dynarmic::ClearInstructionCache() {
 
 void ARM_Dynarmic::InvalidateCacheRange(u32 start_address, size_t length) {
     jit->InvalidateCacheRange(start_address, length);
+    interpreter_state->instruction_cache.InvalidateRange(start_address, length);
 }
 
 void ARM_Dynarmic::PageTableChanged() {
@@ -203,3 +205,23 @@ void ARM_Dynarmic::PageTableChanged() {
     jit = new Dynarmic::Jit(GetUserCallbacks(interpreter_state, current_page_table));
     jits.emplace(current_page_table, std::unique_ptr<Dynarmic::Jit>(jit));
 }
+
+void ARM_Dynarmic::LoadTranslationCache(u64 program_id, u64 code_hash, VAddr code_address,
+                                        u32 code_size) {
+    // Dynarmic can neither serialize the code it emits nor compile code ahead of its execution
+    LOG_WARNING(Core_ARM11, "The translation disk cache is not supported by the JIT");
+}
+
+void ARM_Dynarmic::SaveTranslationCache() {}
+
+void ARM_Dynarmic::SetIdleLoopSkipping(bool) {
+    // Dynarmic has no way to hook the loops of the code it emits, so idle loops are always run
+}
+
+u64 ARM_Dynarmic::GetNumSkippedIdleLoops() const {
+    return 0;
+}
+
+u64 ARM_Dynarmic::GetSkippedIdleCycles() const {
+    return 0;
+}
@@ -43,6 +43,12 @@ public:
     void ClearInstructionCache() override;
     void InvalidateCacheRange(u32 start_address, size_t length) override;
     void PageTableChanged() override;
+    void LoadTranslationCache(u64 program_id, u64 code_hash, VAddr code_address,
+                              u32 code_size) override;
+    void SaveTranslationCache() override;
+    void SetIdleLoopSkipping(bool enabled) override;
+    u64 GetNumSkippedIdleLoops() const override;
+    u64 GetSkippedIdleCycles() const override;
 
 private:
     Dynarmic::Jit* jit = nullptr;
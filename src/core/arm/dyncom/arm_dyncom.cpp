@@ -3,14 +3,21 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cinttypes>
 #include <cstring>
 #include <memory>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/string_util.h"
 #include "core/arm/dyncom/arm_dyncom.h"
+#include "core/arm/dyncom/arm_dyncom_disk_cache.h"
 #include "core/arm/dyncom/arm_dyncom_interpreter.h"
 #include "core/arm/dyncom/arm_dyncom_trans.h"
 #include "core/arm/skyeye_common/armstate.h"
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/gdbstub/gdbstub.h"
+#include "core/memory.h"
 
 ARM_DynCom::ARM_DynCom(PrivilegeMode initial_mode) {
     state = std::make_unique<ARMul_State>(initial_mode);
@@ -27,16 +34,53 @@ void ARM_DynCom::Step() {
 }
 
 void ARM_DynCom::ClearInstructionCache() {
-    state->instruction_cache.clear();
-    trans_cache_buf_top = 0;
+    state->instruction_cache.Clear();
 }
 
-void ARM_DynCom::InvalidateCacheRange(u32, size_t) {
-    ClearInstructionCache();
+void ARM_DynCom::InvalidateCacheRange(u32 start_address, size_t length) {
+    state->instruction_cache.InvalidateRange(start_address, length);
 }
 
 void ARM_DynCom::PageTableChanged() {
     ClearInstructionCache();
+    UpdateFastMemoryAccess();
+}
+
+void ARM_DynCom::LoadTranslationCache(u64 program_id, u64 code_hash, VAddr code_address,
+                                      u32 code_size) {
+    const std::string path =
+        Common::StringFromFormat("%sdyncom/%016" PRIX64 ".bin",
+                                 FileUtil::GetUserPath(D_CACHE_IDX).c_str(), program_id);
+
+    block_disk_cache = std::make_unique<BlockDiskCache>();
+    pending_blocks = block_disk_cache->Open(path, code_hash, code_address, code_size);
+    state->block_disk_cache = block_disk_cache.get();
+
+    LOG_INFO(Core_ARM11, "Loaded %zu blocks from the translation disk cache %s",
+             pending_blocks.size(), path.c_str());
+}
+
+void ARM_DynCom::SaveTranslationCache() {
+    if (block_disk_cache == nullptr)
+        return;
+
+    LOG_INFO(Core_ARM11, "Adding %zu blocks to the translation disk cache",
+             block_disk_cache->GetNumNewBlocks());
+    block_disk_cache->Save();
+}
+
+void ARM_DynCom::SetIdleLoopSkipping(bool enabled) {
+    state->idle_loop_skipping = enabled;
+    // Idle loops are found when blocks are translated
+    ClearInstructionCache();
+}
+
+u64 ARM_DynCom::GetNumSkippedIdleLoops() const {
+    return num_skipped_idle_loops;
+}
+
+u64 ARM_DynCom::GetSkippedIdleCycles() const {
+    return skipped_idle_cycles;
 }
 
 void ARM_DynCom::SetPC(u32 pc) {
@@ -87,10 +131,35 @@ void ARM_DynCom::SetCP15Register(CP15Register reg, u32 value) {
     state->CP15[reg] = value;
 }
 
+void ARM_DynCom::UpdateFastMemoryAccess() {
+    // Memory breakpoints are only checked when accesses go through the memory system
+    Memory::PageTable* page_table = Memory::GetCurrentPageTable();
+    if (page_table == nullptr || GDBStub::IsServerEnabled()) {
+        state->fast_page_pointers = nullptr;
+    } else {
+        state->fast_page_pointers = &page_table->pointers;
+    }
+}
+
 void ARM_DynCom::ExecuteInstructions(int num_instructions) {
+    UpdateFastMemoryAccess();
+
+    // Cached blocks are translated once the memory of the title is mapped and current
+    if (!pending_blocks.empty()) {
+        InterpreterTranslateBlocks(state.get(), pending_blocks);
+        pending_blocks = std::vector<u32>();
+    }
+
     state->NumInstrsToExecute = num_instructions;
     unsigned ticks_executed = InterpreterMainLoop(state.get());
     CoreTiming::AddTicks(ticks_executed);
+
+    if (state->idle_loop_reached) {
+        state->idle_loop_reached = false;
+        ++num_skipped_idle_loops;
+        skipped_idle_cycles += std::max(CoreTiming::GetDowncount(), 0);
+        CoreTiming::Idle();
+    }
 }
 
 void ARM_DynCom::SaveContext(ThreadContext& ctx) {
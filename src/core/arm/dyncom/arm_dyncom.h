@@ -5,11 +5,14 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include "common/common_types.h"
 #include "core/arm/arm_interface.h"
 #include "core/arm/skyeye_common/arm_regformat.h"
 #include "core/arm/skyeye_common/armstate.h"
 
+class BlockDiskCache;
+
 class ARM_DynCom final : public ARM_Interface {
 public:
     explicit ARM_DynCom(PrivilegeMode initial_mode);
@@ -21,6 +24,12 @@ public:
     void ClearInstructionCache() override;
     void InvalidateCacheRange(u32 start_address, size_t length) override;
     void PageTableChanged() override;
+    void LoadTranslationCache(u64 program_id, u64 code_hash, VAddr code_address,
+                              u32 code_size) override;
+    void SaveTranslationCache() override;
+    void SetIdleLoopSkipping(bool enabled) override;
+    u64 GetNumSkippedIdleLoops() const override;
+    u64 GetSkippedIdleCycles() const override;
 
     void SetPC(u32 pc) override;
     u32 GetPC() const override;
@@ -41,7 +50,17 @@ public:
     void PrepareReschedule() override;
 
 private:
+    /// Lets the interpreter access the plain memory of the current page table directly.
+    void UpdateFastMemoryAccess();
     void ExecuteInstructions(int num_instructions);
 
     std::unique_ptr<ARMul_State> state;
+
+    std::unique_ptr<BlockDiskCache> block_disk_cache;
+
+    /// Entry points loaded from the translation disk cache that remain to be translated
+    std::vector<u32> pending_blocks;
+
+    u64 num_skipped_idle_loops = 0;
+    u64 skipped_idle_cycles = 0;
 };
@@ -0,0 +1,155 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/assert.h"
+#include "core/arm/dyncom/arm_dyncom_block_table.h"
+#include "core/arm/dyncom/arm_dyncom_trans.h"
+
+constexpr u32 BlockTable::INVALID_OFFSET;
+
+BlockTable::BlockTable() : pages(Memory::PAGE_TABLE_NUM_ENTRIES) {}
+
+BlockTable::~BlockTable() {
+    Clear();
+    ReleaseRetiredChunks();
+}
+
+BlockTable::Page& BlockTable::GetPage(u32 page_index) {
+    auto& page = pages[page_index];
+    if (page == nullptr) {
+        page = std::make_unique<Page>();
+        page->entries.fill(INVALID_OFFSET);
+        populated_pages.push_back(page_index);
+    }
+    return *page;
+}
+
+void BlockTable::Insert(u32 addr, u32 offset) {
+    Page& page = GetPage(addr >> Memory::PAGE_BITS);
+    page.entries[(addr & Memory::PAGE_MASK) >> 1] = offset;
+}
+
+u32 BlockTable::BeginBlock(u32 addr) {
+    const u32 page_index = addr >> Memory::PAGE_BITS;
+    Page& page = GetPage(page_index);
+
+    std::size_t chunk_end = 0;
+    if (!page.chunks.empty()) {
+        chunk_end = (page.chunks.back() + 1) * TRANS_CACHE_CHUNK_SIZE;
+    }
+
+    if (page.chunks.empty() || chunk_end - page.chunk_top < TRANS_CACHE_MAX_INST_SIZE) {
+        const u32 chunk = AllocateChunk(page_index);
+        page.chunks.push_back(chunk);
+        page.chunk_top = chunk * TRANS_CACHE_CHUNK_SIZE;
+        chunk_end = page.chunk_top + TRANS_CACHE_CHUNK_SIZE;
+    }
+
+    trans_cache_buf_top = page.chunk_top;
+    trans_cache_buf_end = chunk_end;
+    return static_cast<u32>(page.chunk_top);
+}
+
+void BlockTable::EndBlock(u32 addr, u32 offset) {
+    Page& page = GetPage(addr >> Memory::PAGE_BITS);
+    page.chunk_top = trans_cache_buf_top;
+    page.entries[(addr & Memory::PAGE_MASK) >> 1] = offset;
+}
+
+u32 BlockTable::AllocateChunk(u32 requesting_page_index) {
+    u32 chunk = AllocTransCacheChunk();
+    while (chunk == TRANS_CACHE_INVALID_CHUNK) {
+        EvictLeastRecentlyUsedPage(requesting_page_index);
+        chunk = AllocTransCacheChunk();
+    }
+    return chunk;
+}
+
+void BlockTable::EvictLeastRecentlyUsedPage(u32 requesting_page_index) {
+    Page* victim = nullptr;
+    for (u32 page_index : populated_pages) {
+        Page* page = pages[page_index].get();
+        if (page_index == requesting_page_index || page->chunks.empty())
+            continue;
+        if (victim == nullptr || page->last_used < victim->last_used)
+            victim = page;
+    }
+    ASSERT_MSG(victim != nullptr, "Translation cache is full!");
+
+    // Called from the dispatcher, between blocks, so the chunks can be reused right away
+    victim->entries.fill(INVALID_OFFSET);
+    for (u32 chunk : victim->chunks) {
+        FreeTransCacheChunk(chunk);
+    }
+    victim->chunks.clear();
+
+    ++stats.evictions;
+    BreakLinks();
+}
+
+bool BlockTable::InvalidatePage(u32 page_index) {
+    Page* page = pages[page_index].get();
+    if (page == nullptr)
+        return false;
+
+    page->entries.fill(INVALID_OFFSET);
+    if (page->chunks.empty())
+        return false;
+
+    retired_chunks.insert(retired_chunks.end(), page->chunks.begin(), page->chunks.end());
+    page->chunks.clear();
+    return true;
+}
+
+void BlockTable::BreakLinks() {
+    if (++generation == 0)
+        generation = 1;
+}
+
+void BlockTable::InvalidateRange(u32 start_address, std::size_t length) {
+    if (length == 0)
+        return;
+
+    const u64 end_address = static_cast<u64>(start_address) + length;
+    const u32 first_page = start_address >> Memory::PAGE_BITS;
+    const u32 last_page = static_cast<u32>((end_address - 1) >> Memory::PAGE_BITS);
+
+    bool invalidated = false;
+    for (u32 page_index = first_page; page_index <= last_page; ++page_index) {
+        invalidated |= InvalidatePage(page_index);
+    }
+
+    if (invalidated) {
+        BreakLinks();
+    }
+}
+
+void BlockTable::Clear() {
+    for (u32 page_index : populated_pages) {
+        auto& page = pages[page_index];
+        retired_chunks.insert(retired_chunks.end(), page->chunks.begin(), page->chunks.end());
+        page.reset();
+    }
+    populated_pages.clear();
+
+    ++stats.flushes;
+    BreakLinks();
+}
+
+void BlockTable::ReleaseRetiredChunks() {
+    for (u32 chunk : retired_chunks) {
+        FreeTransCacheChunk(chunk);
+    }
+    retired_chunks.clear();
+}
+
+BlockTable::Stats BlockTable::TakeStats() {
+    Stats delta;
+    delta.hits = stats.hits - reported_stats.hits;
+    delta.misses = stats.misses - reported_stats.misses;
+    delta.evictions = stats.evictions - reported_stats.evictions;
+    delta.flushes = stats.flushes - reported_stats.flushes;
+    reported_stats = stats;
+    return delta;
+}
@@ -0,0 +1,174 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "common/common_types.h"
+#include "core/memory.h"
+
+/**
+ * Maps the guest virtual address of a translated basic block to the offset of its first
+ * instruction in the translation cache, and manages the translation cache space of each page.
+ *
+ * Lookups are a two-level indexed fetch: the guest page number selects a lazily allocated
+ * per-page table, which is then indexed by the halfword offset of the address within the page
+ * (Thumb instructions are only halfword aligned). Translated blocks never cross a page boundary,
+ * so invalidating a range of pages drops exactly the blocks decoded from that range.
+ *
+ * The blocks of a page are stored in translation cache chunks owned by that page. When no free
+ * chunk is left, the chunks of the least recently entered page are evicted.
+ */
+class BlockTable final {
+public:
+    /// Returned by Find() when no block is cached at the given address.
+    static constexpr u32 INVALID_OFFSET = 0xFFFFFFFF;
+
+    struct Stats {
+        u64 hits = 0;      ///< Block lookups that found a translated block
+        u64 misses = 0;    ///< Block lookups that required a translation
+        u64 evictions = 0; ///< Pages whose blocks were evicted to make room for new ones
+        u64 flushes = 0;   ///< Full flushes of the table
+    };
+
+    BlockTable();
+    ~BlockTable();
+
+    /**
+     * Looks up the translated block starting at the given address.
+     * @param addr Guest virtual address of the block entry point.
+     * @returns The offset of the block in the translation cache, or INVALID_OFFSET.
+     */
+    u32 Find(u32 addr) const {
+        const Page* page = pages[addr >> Memory::PAGE_BITS].get();
+        if (page == nullptr)
+            return INVALID_OFFSET;
+        return page->entries[(addr & Memory::PAGE_MASK) >> 1];
+    }
+
+    /**
+     * Same as Find(), but also updates the hit/miss statistics and marks the page of the block as
+     * recently used. Used by the dispatcher.
+     */
+    u32 Lookup(u32 addr) {
+        Page* page = pages[addr >> Memory::PAGE_BITS].get();
+        if (page != nullptr) {
+            const u32 offset = page->entries[(addr & Memory::PAGE_MASK) >> 1];
+            if (offset != INVALID_OFFSET) {
+                page->last_used = ++stats.hits;
+                last_used_page_index = addr >> Memory::PAGE_BITS;
+                return offset;
+            }
+        }
+        ++stats.misses;
+        return INVALID_OFFSET;
+    }
+
+    /**
+     * Updates the hit statistics for a block entered through a direct link, which skips Lookup().
+     * The page of the block is marked as recently used when the link leads out of the page marked
+     * last, so that pages only reached through links are not evicted while they are running.
+     * @param page_index Guest page number of the block.
+     */
+    void LinkedHit(u32 page_index) {
+        ++stats.hits;
+        if (page_index != last_used_page_index) {
+            pages[page_index]->last_used = stats.hits;
+            last_used_page_index = page_index;
+        }
+    }
+
+    /**
+     * Registers the translated block starting at the given address.
+     * @param addr Guest virtual address of the block entry point.
+     * @param offset Offset of the block in the translation cache.
+     */
+    void Insert(u32 addr, u32 offset);
+
+    /**
+     * Points trans_cache_buf_top and trans_cache_buf_end at translation cache space owned by the
+     * page containing the given address, with room for at least one instruction. This may evict
+     * the blocks of other pages.
+     * @param addr Guest virtual address of the block about to be translated.
+     * @returns The offset the block will be translated at.
+     */
+    u32 BeginBlock(u32 addr);
+
+    /**
+     * Registers a block translated after BeginBlock() and records the space it used.
+     * @param addr Guest virtual address of the block entry point.
+     * @param offset Offset returned by BeginBlock().
+     */
+    void EndBlock(u32 addr, u32 offset);
+
+    /**
+     * Drops all blocks that start inside the given address range. The range is widened to whole
+     * pages.
+     * @param start_address The starting address of the range to invalidate.
+     * @param length The length (in bytes) of the range to invalidate.
+     */
+    void InvalidateRange(u32 start_address, std::size_t length);
+
+    /// Drops all blocks.
+    void Clear();
+
+    /**
+     * Returns the translation cache chunks of invalidated blocks to the free pool. The blocks of
+     * an invalidated page may still be executing when it is invalidated (e.g. by an SVC), so this
+     * must only be called while no translated block is being executed.
+     */
+    void ReleaseRetiredChunks();
+
+    /**
+     * Returns the current link generation. It changes whenever blocks are invalidated, so that
+     * direct links between translated blocks (see BlockLink) recorded before are no longer
+     * followed. Generation 0 is never current and marks an unpatched link.
+     */
+    u32 GetGeneration() const {
+        return generation;
+    }
+
+    /// Returns the statistics accumulated since the last call, and resets them.
+    Stats TakeStats();
+
+private:
+    struct Page {
+        std::array<u32, Memory::PAGE_SIZE / 2> entries;
+
+        /// Translation cache chunks holding the blocks of this page. The last one is being filled.
+        std::vector<u32> chunks;
+
+        /// Offset of the free space in the last chunk
+        std::size_t chunk_top = 0;
+
+        /// Value of the hit counter when execution last entered this page
+        u64 last_used = 0;
+    };
+
+    Page& GetPage(u32 page_index);
+    bool InvalidatePage(u32 page_index);
+    u32 AllocateChunk(u32 requesting_page_index);
+    void EvictLeastRecentlyUsedPage(u32 requesting_page_index);
+    void BreakLinks();
+
+    /// Per-page tables, indexed by guest page number. Null for pages with no blocks.
+    std::vector<std::unique_ptr<Page>> pages;
+
+    /// Indices of the non-null entries in `pages`, so that Clear() does not walk the whole table.
+    std::vector<u32> populated_pages;
+
+    /// Chunks of invalidated pages that may still be executing, see ReleaseRetiredChunks().
+    std::vector<u32> retired_chunks;
+
+    u32 generation = 1;
+
+    /// Page whose last_used was updated last, see LinkedHit()
+    u32 last_used_page_index = 0xFFFFFFFF;
+
+    Stats stats;
+    Stats reported_stats;
+};
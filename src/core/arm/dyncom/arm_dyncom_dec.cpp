@@ -501,3 +501,10 @@ ARMDecodeStatus DecodeARMInstruction(u32 instr, int* idx) {
     }
     return ret;
 }
+
+const char* GetARMInstructionName(int idx) {
+    const int instr_slots = sizeof(arm_instruction) / sizeof(InstructionSetEncodingItem);
+    if (idx < 0 || idx >= instr_slots)
+        return nullptr;
+    return arm_instruction[idx].name;
+}
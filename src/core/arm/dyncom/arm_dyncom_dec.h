@@ -9,3 +9,7 @@
 enum class ARMDecodeStatus { SUCCESS, FAILURE };
 
 ARMDecodeStatus DecodeARMInstruction(u32 instr, int* idx);
+
+/// Returns the name of the ARM instruction with the given decoder index, or nullptr if there is no
+/// such instruction.
+const char* GetARMInstructionName(int idx);
@@ -0,0 +1,90 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "core/arm/dyncom/arm_dyncom_disk_cache.h"
+
+namespace {
+
+/// Collects the entry points stored for a given code hash, and counts the stale entries.
+class BlockListReader final : public LinearDiskCacheReader<u64, u32> {
+public:
+    explicit BlockListReader(u64 code_hash) : code_hash(code_hash) {}
+
+    void Read(const u64& key, const u32* value, u32 value_size) override {
+        if (key != code_hash) {
+            ++num_stale_entries;
+            return;
+        }
+        blocks.insert(blocks.end(), value, value + value_size);
+    }
+
+    const u64 code_hash;
+    std::vector<u32> blocks;
+    u32 num_stale_entries = 0;
+};
+
+} // Anonymous namespace
+
+BlockDiskCache::~BlockDiskCache() {
+    file.Close();
+}
+
+std::vector<u32> BlockDiskCache::Open(const std::string& path, u64 hash, VAddr code_address,
+                                      u32 code_size) {
+    code_hash = hash;
+    code_begin = code_address;
+    code_end = code_address + code_size;
+    known_blocks.clear();
+    new_blocks.clear();
+
+    FileUtil::CreateFullPath(path);
+
+    BlockListReader reader(code_hash);
+    file.OpenAndRead(path.c_str(), reader);
+    is_open = true;
+
+    std::vector<u32> blocks;
+    for (u32 block : reader.blocks) {
+        if (known_blocks.insert(block).second) {
+            blocks.push_back(block);
+        }
+    }
+
+    // Drop the blocks of other versions of the code, and write the current ones back as one entry
+    if (reader.num_stale_entries != 0) {
+        LOG_INFO(Core_ARM11, "Discarding %u outdated entries of %s", reader.num_stale_entries,
+                 path.c_str());
+        file.Close();
+        FileUtil::Delete(path);
+        BlockListReader empty_reader(code_hash);
+        file.OpenAndRead(path.c_str(), empty_reader);
+        if (!blocks.empty()) {
+            file.Append(code_hash, blocks.data(), static_cast<u32>(blocks.size()));
+            file.Sync();
+        }
+    }
+
+    return blocks;
+}
+
+void BlockDiskCache::Record(VAddr address, bool thumb) {
+    if (!is_open || address < code_begin || address >= code_end)
+        return;
+
+    const u32 block = address | (thumb ? 1 : 0);
+    if (known_blocks.insert(block).second) {
+        new_blocks.push_back(block);
+    }
+}
+
+void BlockDiskCache::Save() {
+    if (!is_open || new_blocks.empty())
+        return;
+
+    file.Append(code_hash, new_blocks.data(), static_cast<u32>(new_blocks.size()));
+    file.Sync();
+    new_blocks.clear();
+}
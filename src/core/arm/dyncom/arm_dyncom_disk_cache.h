@@ -0,0 +1,70 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "common/common_types.h"
+#include "common/linear_disk_cache.h"
+
+/**
+ * Persistent record of the basic blocks the interpreter translated for a title, so that they can
+ * be translated ahead of time on the next boot instead of as they are first executed.
+ *
+ * Translated blocks refer to host addresses (handlers, translation cache offsets), so the blocks
+ * themselves cannot be stored. What is stored instead is the entry point of each block, with bit 0
+ * set for Thumb code. Only blocks of the code segment of the title are recorded, and they are
+ * stored along with a hash of the segment: entries recorded for other versions of the code are
+ * discarded when the cache is opened.
+ *
+ * On disk, the cache of each title is a LinearDiskCache keyed by the code hash. Every run appends
+ * one entry with the entry points it discovered.
+ */
+class BlockDiskCache final {
+public:
+    ~BlockDiskCache();
+
+    /**
+     * Opens the cache of a title, creating it if needed.
+     * @param path Path of the cache file of the title.
+     * @param code_hash Hash of the code segment of the title.
+     * @param code_address Address of the code segment.
+     * @param code_size Size of the code segment in bytes.
+     * @returns The entry points of the blocks recorded for this code by previous runs.
+     */
+    std::vector<u32> Open(const std::string& path, u64 code_hash, VAddr code_address,
+                          u32 code_size);
+
+    /**
+     * Records the entry point of a translated block. Blocks outside of the code segment and blocks
+     * that are already cached are ignored.
+     * @param address Address of the first instruction of the block.
+     * @param thumb Whether the block is Thumb code.
+     */
+    void Record(VAddr address, bool thumb);
+
+    /// Appends the blocks recorded since the last call to the cache file.
+    void Save();
+
+    /// Returns the number of blocks recorded since the last call to Save().
+    size_t GetNumNewBlocks() const {
+        return new_blocks.size();
+    }
+
+private:
+    LinearDiskCache<u64, u32> file;
+    bool is_open = false;
+
+    u64 code_hash = 0;
+    VAddr code_begin = 0;
+    VAddr code_end = 0;
+
+    /// Entry points of the blocks that are cached or recorded, including their Thumb bit
+    std::unordered_set<u32> known_blocks;
+
+    /// Entry points recorded since the last Save()
+    std::vector<u32> new_blocks;
+};
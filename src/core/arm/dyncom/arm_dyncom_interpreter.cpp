@@ -5,12 +5,15 @@
 #define CITRA_IGNORE_EXIT(x)
 
 #include <algorithm>
+#include <array>
 #include <cinttypes>
 #include <cstdio>
+#include <vector>
 #include "common/common_types.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "core/arm/dyncom/arm_dyncom_dec.h"
+#include "core/arm/dyncom/arm_dyncom_disk_cache.h"
 #include "core/arm/dyncom/arm_dyncom_interpreter.h"
 #include "core/arm/dyncom/arm_dyncom_run.h"
 #include "core/arm/dyncom/arm_dyncom_thumb.h"
@@ -33,7 +36,9 @@
 #define ROTATE_RIGHT_32(n, i) ROTATE_RIGHT(n, i, 32)
 #define ROTATE_LEFT_32(n, i) ROTATE_LEFT(n, i, 32)
 
-static bool CondPassed(const ARMul_State* cpu, unsigned int cond) {
+static bool CondPassed(ARMul_State* cpu, unsigned int cond) {
+    cpu->MaterializeFlags();
+
     const bool n_flag = cpu->NFlag != 0;
     const bool z_flag = cpu->ZFlag != 0;
     const bool c_flag = cpu->CFlag != 0;
@@ -76,12 +81,16 @@ static bool CondPassed(const ARMul_State* cpu, unsigned int cond) {
     return false;
 }
 
+// Value of shifter_carry_out when the shifter leaves the carry flag unchanged. The carry flag is not
+// read in that case, as it may still be pending (see ARMul_State::AddWithLazyFlags()).
+constexpr unsigned int SHIFTER_CARRY_UNCHANGED = 2;
+
 static unsigned int DPO(Immediate)(ARMul_State* cpu, unsigned int sht_oper) {
     unsigned int immed_8 = BITS(sht_oper, 0, 7);
     unsigned int rotate_imm = BITS(sht_oper, 8, 11);
     unsigned int shifter_operand = ROTATE_RIGHT_32(immed_8, rotate_imm * 2);
     if (rotate_imm == 0)
-        cpu->shifter_carry_out = cpu->CFlag;
+        cpu->shifter_carry_out = SHIFTER_CARRY_UNCHANGED;
     else
         cpu->shifter_carry_out = BIT(shifter_operand, 31);
     return shifter_operand;
@@ -90,7 +99,7 @@ static unsigned int DPO(Immediate)(ARMul_State* cpu, unsigned int sht_oper) {
 static unsigned int DPO(Register)(ARMul_State* cpu, unsigned int sht_oper) {
     unsigned int rm = CHECK_READ_REG15(cpu, RM);
     unsigned int shifter_operand = rm;
-    cpu->shifter_carry_out = cpu->CFlag;
+    cpu->shifter_carry_out = SHIFTER_CARRY_UNCHANGED;
     return shifter_operand;
 }
 
@@ -100,7 +109,7 @@ static unsigned int DPO(LogicalShiftLeftByImmediate)(ARMul_State* cpu, unsigned
     unsigned int shifter_operand;
     if (shift_imm == 0) {
         shifter_operand = rm;
-        cpu->shifter_carry_out = cpu->CFlag;
+        cpu->shifter_carry_out = SHIFTER_CARRY_UNCHANGED;
     } else {
         shifter_operand = rm << shift_imm;
         cpu->shifter_carry_out = BIT(rm, 32 - shift_imm);
@@ -114,7 +123,7 @@ static unsigned int DPO(LogicalShiftLeftByRegister)(ARMul_State* cpu, unsigned i
     unsigned int rs = CHECK_READ_REG15(cpu, RS);
     if (BITS(rs, 0, 7) == 0) {
         shifter_operand = rm;
-        cpu->shifter_carry_out = cpu->CFlag;
+        cpu->shifter_carry_out = SHIFTER_CARRY_UNCHANGED;
     } else if (BITS(rs, 0, 7) < 32) {
         shifter_operand = rm << BITS(rs, 0, 7);
         cpu->shifter_carry_out = BIT(rm, 32 - BITS(rs, 0, 7));
@@ -148,7 +157,7 @@ static unsigned int DPO(LogicalShiftRightByRegister)(ARMul_State* cpu, unsigned
     unsigned int shifter_operand;
     if (BITS(rs, 0, 7) == 0) {
         shifter_operand = rm;
-        cpu->shifter_carry_out = cpu->CFlag;
+        cpu->shifter_carry_out = SHIFTER_CARRY_UNCHANGED;
     } else if (BITS(rs, 0, 7) < 32) {
         shifter_operand = rm >> BITS(rs, 0, 7);
         cpu->shifter_carry_out = BIT(rm, BITS(rs, 0, 7) - 1);
@@ -185,7 +194,7 @@ static unsigned int DPO(ArithmeticShiftRightByRegister)(ARMul_State* cpu, unsign
     unsigned int shifter_operand;
     if (BITS(rs, 0, 7) == 0) {
         shifter_operand = rm;
-        cpu->shifter_carry_out = cpu->CFlag;
+        cpu->shifter_carry_out = SHIFTER_CARRY_UNCHANGED;
     } else if (BITS(rs, 0, 7) < 32) {
         shifter_operand = static_cast<int>(rm) >> BITS(rs, 0, 7);
         cpu->shifter_carry_out = BIT(rm, BITS(rs, 0, 7) - 1);
@@ -204,6 +213,7 @@ static unsigned int DPO(RotateRightByImmediate)(ARMul_State* cpu, unsigned int s
     unsigned int rm = CHECK_READ_REG15(cpu, RM);
     int shift_imm = BITS(sht_oper, 7, 11);
     if (shift_imm == 0) {
+        cpu->MaterializeFlags();
         shifter_operand = (cpu->CFlag << 31) | (rm >> 1);
         cpu->shifter_carry_out = BIT(rm, 0);
     } else {
@@ -219,7 +229,7 @@ static unsigned int DPO(RotateRightByRegister)(ARMul_State* cpu, unsigned int sh
     unsigned int shifter_operand;
     if (BITS(rs, 0, 7) == 0) {
         shifter_operand = rm;
-        cpu->shifter_carry_out = cpu->CFlag;
+        cpu->shifter_carry_out = SHIFTER_CARRY_UNCHANGED;
     } else if (BITS(rs, 0, 4) == 0) {
         shifter_operand = rm;
         cpu->shifter_carry_out = BIT(rm, 31);
@@ -372,6 +382,7 @@ static void LnSWoUB(ScaledRegisterPreIndexed)(ARMul_State* cpu, unsigned int ins
         break;
     case 3:
         if (shift_imm == 0) {
+            cpu->MaterializeFlags();
             index = (cpu->CFlag << 31) | (rm >> 1);
         } else {
             index = ROTATE_RIGHT_32(rm, shift_imm);
@@ -423,6 +434,7 @@ static void LnSWoUB(ScaledRegisterPostIndexed)(ARMul_State* cpu, unsigned int in
         break;
     case 3:
         if (shift_imm == 0) {
+            cpu->MaterializeFlags();
             index = (cpu->CFlag << 31) | (rm >> 1);
         } else {
             index = ROTATE_RIGHT_32(rm, shift_imm);
@@ -648,6 +660,7 @@ static void LnSWoUB(ScaledRegisterOffset)(ARMul_State* cpu, unsigned int inst,
         break;
     case 3:
         if (shift_imm == 0) {
+            cpu->MaterializeFlags();
             index = (cpu->CFlag << 31) | (rm >> 1);
         } else {
             index = ROTATE_RIGHT_32(rm, shift_imm);
@@ -807,10 +820,44 @@ enum { KEEP_GOING, FETCH_EXCEPTION };
 
 MICROPROFILE_DEFINE(DynCom_Decode, "DynCom", "Decode", MP_RGB(255, 64, 64));
 
+// Maximum number of instructions of an idle loop, including its branch
+constexpr int IDLE_LOOP_MAX_SIZE = 8;
+
+/**
+ * Returns whether an instruction can be part of an idle loop, given its ARM encoding. These are
+ * data processing instructions, sign and zero extensions, and loads without writeback, none of
+ * which write the PC. Their only effects are on the registers and the NZCV flags.
+ */
+static bool IsIdleLoopInstruction(u32 inst) {
+    const u32 rd = BITS(inst, 12, 15);
+    if (BITS(inst, 28, 31) == ConditionCode::NV || rd == 15)
+        return false;
+
+    // SXTB, SXTH, UXTB, UXTH and their 16-bit variants, without accumulation
+    if ((inst & 0x0F8F03F0) == 0x068F0070)
+        return true;
+
+    // LDR and LDRB with an offset, as opposed to pre or post-indexing
+    if (BITS(inst, 26, 27) == 1)
+        return (inst & 0x01300000) == 0x01100000 && !(BIT(inst, 25) && BIT(inst, 4));
+
+    if (BITS(inst, 26, 27) != 0)
+        return false;
+
+    // LDRH, LDRSB and LDRSH with an offset, as opposed to pre or post-indexing
+    if (!BIT(inst, 25) && BIT(inst, 7) && BIT(inst, 4))
+        return BITS(inst, 5, 6) != 0 && (inst & 0x01300000) == 0x01100000;
+
+    // Data processing, except for the miscellaneous instructions (MRS, MSR, BX, QADD...) that are
+    // encoded as comparisons which do not set the flags
+    return BITS(inst, 23, 24) != 2 || BIT(inst, 20);
+}
+
 static unsigned int InterpreterTranslateInstruction(const ARMul_State* cpu, const u32 phys_addr,
-                                                    ARM_INST_PTR& inst_base) {
+                                                    ARM_INST_PTR& inst_base, bool& idle_loop_safe) {
     u32 inst_size = 4;
     u32 inst = Memory::Read32(phys_addr & 0xFFFFFFFC);
+    idle_loop_safe = false;
 
     // If we are in Thumb mode, we'll translate one Thumb instruction to the corresponding ARM
     // instruction
@@ -835,10 +882,178 @@ static unsigned int InterpreterTranslateInstruction(const ARMul_State* cpu, cons
         CITRA_IGNORE_EXIT(-1);
     }
     inst_base = arm_instruction_trans[idx](inst, idx);
+    idle_loop_safe = IsIdleLoopInstruction(inst);
 
     return inst_size;
 }
 
+// Decoder table indices of the instructions that are fused into pairs. Like InstLabel, these have
+// to be kept in sync with the order of arm_instruction in arm_dyncom_dec.cpp.
+enum : unsigned int {
+    CMP_IDX = 130,
+    ADD_IDX = 148,
+    MOV_IDX = 156,
+    LDR_IDX = 180,
+    BBL_IDX = 196,
+    B_COND_THUMB_IDX = 198,
+};
+
+// Handler indices of the fused instruction pairs and of the idle loop branches, which follow
+// DISPATCH, INIT_INST_LENGTH and END in InstLabel.
+enum : unsigned int {
+    CMP_BBL_FUSED_IDX = 205,
+    CMP_B_COND_THUMB_FUSED_IDX,
+    MOV_MOV_FUSED_IDX,
+    LDR_ADD_FUSED_IDX,
+    IDLE_LOOP_BBL_IDX,
+    IDLE_LOOP_B_COND_THUMB_IDX,
+    NUM_INST_HANDLERS,
+};
+
+struct FusedPair {
+    unsigned int first;
+    unsigned int second;
+    unsigned int fused;
+};
+
+constexpr std::array<FusedPair, 4> fused_pairs{{
+    {CMP_IDX, BBL_IDX, CMP_BBL_FUSED_IDX},
+    {CMP_IDX, B_COND_THUMB_IDX, CMP_B_COND_THUMB_FUSED_IDX},
+    {MOV_IDX, MOV_IDX, MOV_MOV_FUSED_IDX},
+    {LDR_IDX, ADD_IDX, LDR_ADD_FUSED_IDX},
+}};
+
+/**
+ * Peephole pass over two consecutive instructions of a block being translated. If they form one of
+ * the fused pairs, the first instruction is given the handler of the pair, which executes both
+ * instructions without an indirect dispatch in between. The creams themselves are left untouched,
+ * so the fused handler can still fall back to the handler of the first instruction.
+ */
+static void FuseInstructionPair(arm_inst* first, const arm_inst* second) {
+    // The first instruction has to fall through to the second one
+    if (first->br != TransExtData::NON_BRANCH)
+        return;
+
+    for (const FusedPair& pair : fused_pairs) {
+        if (first->idx == pair.first && second->idx == pair.second) {
+            first->idx = pair.fused;
+            return;
+        }
+    }
+}
+
+/**
+ * Gives the branch ending a block the handler that detects idle loops, if it branches back to the
+ * start of the block. The rest of the block has to be made of IsIdleLoopInstruction() instructions.
+ */
+static void MarkIdleLoopBranch(arm_inst* inst_base, u32 addr, u32 block_start) {
+    if (inst_base->idx == BBL_IDX) {
+        const bbl_inst* inst_cream = (bbl_inst*)inst_base->component;
+        if (!inst_cream->L && addr + 8 + inst_cream->signed_immed_24 == block_start)
+            inst_base->idx = IDLE_LOOP_BBL_IDX;
+    } else if (inst_base->idx == B_COND_THUMB_IDX) {
+        const b_cond_thumb* inst_cream = (b_cond_thumb*)inst_base->component;
+        if (addr + 4 + inst_cream->imm == block_start)
+            inst_base->idx = IDLE_LOOP_B_COND_THUMB_IDX;
+    }
+}
+
+/**
+ * State of the CPU when the branch of an idle loop was last taken. An idle loop computes the
+ * registers and flags it writes from memory and from registers. Once an iteration leaves them as
+ * they were after the previous one, every following iteration does the same, until something other
+ * than the loop changes the memory it reads.
+ */
+struct IdleLoopIteration {
+    /// Branch of the loop, or null if no iteration was recorded
+    const arm_inst* branch = nullptr;
+    /// Number of instructions executed by the interpreter before the branch was taken
+    unsigned int num_instrs = 0;
+    std::array<u32, 15> regs;
+    u32 nzcv;
+
+    /**
+     * Records an iteration of an idle loop whose branch is being taken.
+     * @param taken_branch The branch of the loop.
+     * @param instrs_executed Number of instructions executed so far, including the branch.
+     * @param loop_size Number of instructions of the loop.
+     * @returns Whether the iteration left the registers and the flags unchanged.
+     */
+    bool Record(ARMul_State* cpu, const arm_inst* taken_branch, unsigned int instrs_executed,
+                unsigned int loop_size) {
+        cpu->MaterializeFlags();
+        const u32 flags = cpu->NFlag << 3 | cpu->ZFlag << 2 | cpu->CFlag << 1 | cpu->VFlag;
+
+        // The recorded iteration has to be the previous one, and not an older run of the loop
+        const bool spinning = branch == taken_branch &&
+                              num_instrs + loop_size == instrs_executed && nzcv == flags &&
+                              std::equal(regs.begin(), regs.end(), cpu->Reg.begin());
+
+        branch = taken_branch;
+        num_instrs = instrs_executed;
+        std::copy_n(cpu->Reg.begin(), regs.size(), regs.begin());
+        nzcv = flags;
+        return spinning;
+    }
+};
+
+#ifdef DYNCOM_BIGRAM_PROFILE
+// Pairs are not fused while profiling, so that the profile shows which pairs are worth fusing
+constexpr bool fuse_instructions = false;
+
+// Number of times each pair of consecutive instructions of a block was executed, indexed by the
+// handler indices of the first and second instruction
+static std::array<std::array<u64, NUM_INST_HANDLERS>, NUM_INST_HANDLERS> bigram_counts{};
+
+static const char* GetInstructionName(unsigned int idx) {
+    static const std::array<const char*, 5> thumb_branch_names{
+        {"b_2_thumb", "b_cond_thumb", "bl_1_thumb", "bl_2_thumb", "blx_1_thumb"}};
+
+    const char* name = GetARMInstructionName(idx);
+    if (name != nullptr)
+        return name;
+    if (idx >= BBL_IDX + 1 && idx < BBL_IDX + 1 + thumb_branch_names.size())
+        return thumb_branch_names[idx - BBL_IDX - 1];
+    return "unknown";
+}
+
+void InterpreterLogBigramProfile(u64 program_id) {
+    constexpr std::size_t num_logged_bigrams = 32;
+
+    struct Bigram {
+        u64 count;
+        unsigned int first;
+        unsigned int second;
+    };
+
+    std::vector<Bigram> bigrams;
+    u64 total = 0;
+    for (unsigned int first = 0; first < NUM_INST_HANDLERS; ++first) {
+        for (unsigned int second = 0; second < NUM_INST_HANDLERS; ++second) {
+            const u64 count = bigram_counts[first][second];
+            if (count != 0) {
+                bigrams.push_back({count, first, second});
+                total += count;
+            }
+        }
+        bigram_counts[first].fill(0);
+    }
+
+    const std::size_t num_logged = std::min(num_logged_bigrams, bigrams.size());
+    std::partial_sort(bigrams.begin(), bigrams.begin() + num_logged, bigrams.end(),
+                      [](const Bigram& a, const Bigram& b) { return a.count > b.count; });
+
+    LOG_INFO(Core_ARM11, "Most executed instruction pairs of title %016" PRIX64 ":", program_id);
+    for (std::size_t i = 0; i < num_logged; ++i) {
+        const Bigram& bigram = bigrams[i];
+        LOG_INFO(Core_ARM11, "%-12s %-12s %12" PRIu64 " (%.2f%%)", GetInstructionName(bigram.first),
+                 GetInstructionName(bigram.second), bigram.count, 100.0 * bigram.count / total);
+    }
+}
+#else
+constexpr bool fuse_instructions = true;
+#endif
+
 static int InterpreterTranslateBlock(ARMul_State* cpu, std::size_t& bb_start, u32 addr) {
     MICROPROFILE_SCOPE(DynCom_Decode);
 
@@ -847,27 +1062,52 @@ static int InterpreterTranslateBlock(ARMul_State* cpu, std::size_t& bb_start, u3
     // Go on next, until terminal instruction
     // Save start addr of basicblock in CreamCache
     ARM_INST_PTR inst_base = nullptr;
+    ARM_INST_PTR prev_inst_base = nullptr;
     TransExtData ret = TransExtData::NON_BRANCH;
     int size = 0; // instruction size of basic block
-    bb_start = trans_cache_buf_top;
 
     u32 phys_addr = addr;
     u32 pc_start = cpu->Reg[15];
 
+    // Whether the instructions so far may be the start of an idle loop
+    bool idle_loop = cpu->idle_loop_skipping && !GDBStub::IsServerEnabled();
+
+    bb_start = cpu->instruction_cache.BeginBlock(pc_start);
+
     while (ret == TransExtData::NON_BRANCH) {
-        unsigned int inst_size = InterpreterTranslateInstruction(cpu, phys_addr, inst_base);
+        bool idle_loop_safe;
+        unsigned int inst_size =
+            InterpreterTranslateInstruction(cpu, phys_addr, inst_base, idle_loop_safe);
+
+        // This comes before fusion, which leaves the pairs ending with an idle loop branch alone
+        if (inst_base->br == TransExtData::NON_BRANCH) {
+            idle_loop = idle_loop && idle_loop_safe && size + 1 < IDLE_LOOP_MAX_SIZE;
+        } else if (idle_loop) {
+            MarkIdleLoopBranch(inst_base, phys_addr, pc_start);
+        }
+
+        if (fuse_instructions && prev_inst_base != nullptr)
+            FuseInstructionPair(prev_inst_base, inst_base);
+        prev_inst_base = inst_base;
 
         size++;
 
         phys_addr += inst_size;
 
-        if ((phys_addr & 0xfff) == 0) {
+        // A block has to fit in a single translation cache chunk. If the next instruction does not
+        // fit, end the block here as if it reached the end of the page. The following instruction
+        // will then start a new block in a new chunk.
+        if ((phys_addr & 0xfff) == 0 ||
+            trans_cache_buf_end - trans_cache_buf_top < TRANS_CACHE_MAX_INST_SIZE) {
             inst_base->br = TransExtData::END_OF_PAGE;
         }
         ret = inst_base->br;
     };
 
-    cpu->instruction_cache[pc_start] = bb_start;
+    cpu->instruction_cache.EndBlock(pc_start, static_cast<u32>(bb_start));
+
+    if (cpu->block_disk_cache != nullptr)
+        cpu->block_disk_cache->Record(pc_start, cpu->TFlag != 0);
 
     return KEEP_GOING;
 }
@@ -876,22 +1116,44 @@ static int InterpreterTranslateSingle(ARMul_State* cpu, std::size_t& bb_start, u
     MICROPROFILE_SCOPE(DynCom_Decode);
 
     ARM_INST_PTR inst_base = nullptr;
-    bb_start = trans_cache_buf_top;
 
     u32 phys_addr = addr;
     u32 pc_start = cpu->Reg[15];
 
-    InterpreterTranslateInstruction(cpu, phys_addr, inst_base);
+    bb_start = cpu->instruction_cache.BeginBlock(pc_start);
+
+    bool idle_loop_safe;
+    InterpreterTranslateInstruction(cpu, phys_addr, inst_base, idle_loop_safe);
 
     if (inst_base->br == TransExtData::NON_BRANCH) {
         inst_base->br = TransExtData::SINGLE_STEP;
     }
 
-    cpu->instruction_cache[pc_start] = bb_start;
+    cpu->instruction_cache.EndBlock(pc_start, static_cast<u32>(bb_start));
 
     return KEEP_GOING;
 }
 
+void InterpreterTranslateBlocks(ARMul_State* cpu, const std::vector<u32>& entry_points) {
+    const u32 pc = cpu->Reg[15];
+    const u32 t_flag = cpu->TFlag;
+
+    for (u32 entry_point : entry_points) {
+        const u32 address = entry_point & ~1u;
+        if (cpu->instruction_cache.Find(address) != BlockTable::INVALID_OFFSET)
+            continue;
+
+        // Translation decodes the instruction set of the current state from Reg[15]
+        cpu->Reg[15] = address;
+        cpu->TFlag = entry_point & 1;
+        std::size_t bb_start;
+        InterpreterTranslateBlock(cpu, bb_start, address);
+    }
+
+    cpu->Reg[15] = pc;
+    cpu->TFlag = t_flag;
+}
+
 static int clz(unsigned int x) {
     int n;
     if (x == 0)
@@ -942,9 +1204,16 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
 #define SET_PC (cpu->Reg[15] = cpu->Reg[15] + 8 + inst_cream->signed_immed_24)
 #define SHIFTER_OPERAND inst_cream->shtop_func(cpu, inst_cream->shifter_operand)
 
+#ifdef DYNCOM_BIGRAM_PROFILE
+#define PROFILE_BIGRAM(first, second) ++bigram_counts[first][second]
+#else
+#define PROFILE_BIGRAM(first, second) (void)0
+#endif
+
 #define FETCH_INST                                                                                 \
     if (inst_base->br != TransExtData::NON_BRANCH)                                                 \
         goto DISPATCH;                                                                             \
+    PROFILE_BIGRAM(inst_base->idx, ((arm_inst*)&trans_cache_buf[ptr])->idx);                       \
     inst_base = (arm_inst*)&trans_cache_buf[ptr]
 
 #define INC_PC(l) ptr += sizeof(arm_inst) + l
@@ -1387,17 +1656,63 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
         goto INIT_INST_LENGTH;                                                                     \
     case 204:                                                                                      \
         goto END;                                                                                  \
+    case 205:                                                                                      \
+        goto CMP_BBL_FUSED;                                                                        \
+    case 206:                                                                                      \
+        goto CMP_B_COND_THUMB_FUSED;                                                               \
+    case 207:                                                                                      \
+        goto MOV_MOV_FUSED;                                                                        \
+    case 208:                                                                                      \
+        goto LDR_ADD_FUSED;                                                                        \
+    case 209:                                                                                      \
+        goto IDLE_LOOP_BBL;                                                                        \
+    case 210:                                                                                      \
+        goto IDLE_LOOP_B_COND_THUMB;                                                               \
     }
 #endif
 
-#define UPDATE_NFLAG(dst) (cpu->NFlag = BIT(dst, 31) ? 1 : 0)
+// Fused handlers execute the first instruction of their pair, then jump straight to the handler of
+// the second one. They fall back to the handler of the first instruction alone when execution has
+// to be able to stop in between, i.e. when the instruction budget runs out after it or a debugger
+// may have set a breakpoint on the second instruction.
+#define FUSED_INST_FALLBACK(label)                                                                 \
+    if (num_instrs >= cpu->NumInstrsToExecute || GDBStub::IsServerEnabled())                       \
+        goto label
+
+#define GOTO_FUSED_SECOND_INST(label)                                                              \
+    inst_base = (arm_inst*)&trans_cache_buf[ptr];                                                  \
+    num_instrs++;                                                                                  \
+    goto label
+
+// Jumps straight to the translated successor block if the link is still valid. Otherwise, DISPATCH
+// looks the successor up and patches the link so that the next run of this branch can skip it.
+// Links are not followed while a debugger is connected, since DISPATCH fetches the breakpoints of
+// every block it enters.
+#define GOTO_LINKED_BLOCK(link)                                                                    \
+    if ((link).generation == cpu->instruction_cache.GetGeneration() &&                             \
+        !GDBStub::IsConnected()) {                                                                 \
+        cpu->instruction_cache.LinkedHit((link).page_index);                                       \
+        ptr = (link).offset;                                                                       \
+        inst_base = (arm_inst*)&trans_cache_buf[ptr];                                              \
+        GOTO_NEXT_INST;                                                                            \
+    }                                                                                              \
+    pending_link = &(link);                                                                        \
+    goto DISPATCH
+
+// Flags set by an AddWithLazyFlags() are materialized before eagerly updating any of them, as the
+// eager updates may leave some flags unchanged. UPDATE_NFLAG always comes first.
+#define UPDATE_NFLAG(dst) (cpu->MaterializeFlags(), cpu->NFlag = BIT(dst, 31) ? 1 : 0)
 #define UPDATE_ZFLAG(dst) (cpu->ZFlag = dst ? 0 : 1)
-#define UPDATE_CFLAG_WITH_SC (cpu->CFlag = cpu->shifter_carry_out)
+#define UPDATE_CFLAG_WITH_SC                                                                       \
+    (cpu->CFlag = cpu->shifter_carry_out != SHIFTER_CARRY_UNCHANGED ? cpu->shifter_carry_out       \
+                                                                    : cpu->CFlag)
 
 #define SAVE_NZCVT                                                                                 \
+    cpu->MaterializeFlags();                                                                       \
     cpu->Cpsr = (cpu->Cpsr & 0x0fffffdf) | (cpu->NFlag << 31) | (cpu->ZFlag << 30) |               \
                 (cpu->CFlag << 29) | (cpu->VFlag << 28) | (cpu->TFlag << 5)
 #define LOAD_NZCVT                                                                                 \
+    cpu->DiscardLazyFlags();                                                                       \
     cpu->NFlag = (cpu->Cpsr >> 31);                                                                \
     cpu->ZFlag = (cpu->Cpsr >> 30) & 1;                                                            \
     cpu->CFlag = (cpu->Cpsr >> 29) & 1;                                                            \
@@ -1614,13 +1929,24 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
                          &&BLX_1_THUMB,
                          &&DISPATCH,
                          &&INIT_INST_LENGTH,
-                         &&END};
+                         &&END,
+                         &&CMP_BBL_FUSED,
+                         &&CMP_B_COND_THUMB_FUSED,
+                         &&MOV_MOV_FUSED,
+                         &&LDR_ADD_FUSED,
+                         &&IDLE_LOOP_BBL,
+                         &&IDLE_LOOP_B_COND_THUMB};
 #endif
     arm_inst* inst_base;
     unsigned int addr;
     unsigned int num_instrs = 0;
 
     std::size_t ptr;
+    BlockLink* pending_link = nullptr;
+    IdleLoopIteration idle_loop_iteration;
+
+    // No translated block is executing yet, so invalidated blocks can be reclaimed
+    cpu->instruction_cache.ReleaseRetiredChunks();
 
     LOAD_NZCVT;
 DISPATCH : {
@@ -1635,10 +1961,13 @@ DISPATCH : {
     else
         cpu->Reg[15] &= 0xfffffffc;
 
+    // Translating a block may evict others, including the one holding the pending link
+    const u32 link_generation = cpu->instruction_cache.GetGeneration();
+
     // Find the cached instruction cream, otherwise translate it...
-    auto itr = cpu->instruction_cache.find(cpu->Reg[15]);
-    if (itr != cpu->instruction_cache.end()) {
-        ptr = itr->second;
+    const u32 cached_offset = cpu->instruction_cache.Lookup(cpu->Reg[15]);
+    if (cached_offset != BlockTable::INVALID_OFFSET) {
+        ptr = cached_offset;
     } else if (cpu->NumInstrsToExecute != 1) {
         if (InterpreterTranslateBlock(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
             goto END;
@@ -1647,6 +1976,16 @@ DISPATCH : {
             goto END;
     }
 
+    // Link the block that branched here directly to this one
+    if (pending_link != nullptr) {
+        if (link_generation == cpu->instruction_cache.GetGeneration()) {
+            pending_link->offset = static_cast<u32>(ptr);
+            pending_link->generation = link_generation;
+            pending_link->page_index = cpu->Reg[15] >> Memory::PAGE_BITS;
+        }
+        pending_link = nullptr;
+    }
+
     // Find breakpoint if one exists within the block
     if (GDBStub::IsConnected()) {
         breakpoint_data =
@@ -1664,9 +2003,14 @@ ADC_INST : {
         if (inst_cream->Rn == 15)
             rn_val += 2 * cpu->GetInstructionSize();
 
-        bool carry;
-        bool overflow;
-        RD = AddWithCarry(rn_val, SHIFTER_OPERAND, cpu->CFlag, &carry, &overflow);
+        u32 rop = SHIFTER_OPERAND;
+        cpu->MaterializeFlags();
+
+        if (inst_cream->S && (inst_cream->Rd != 15)) {
+            RD = cpu->AddWithLazyFlags(rn_val, rop, cpu->CFlag);
+        } else {
+            RD = rn_val + rop + cpu->CFlag;
+        }
 
         if (inst_cream->S && (inst_cream->Rd == 15)) {
             if (cpu->CurrentModeHasSPSR()) {
@@ -1674,11 +2018,6 @@ ADC_INST : {
                 cpu->ChangePrivilegeMode(cpu->Spsr_copy & 0x1F);
                 LOAD_NZCVT;
             }
-        } else if (inst_cream->S) {
-            UPDATE_NFLAG(RD);
-            UPDATE_ZFLAG(RD);
-            cpu->CFlag = carry;
-            cpu->VFlag = overflow;
         }
         if (inst_cream->Rd == 15) {
             INC_PC(sizeof(adc_inst));
@@ -1696,9 +2035,13 @@ ADD_INST : {
 
         u32 rn_val = CHECK_READ_REG15_WA(cpu, inst_cream->Rn);
 
-        bool carry;
-        bool overflow;
-        RD = AddWithCarry(rn_val, SHIFTER_OPERAND, 0, &carry, &overflow);
+        u32 rop = SHIFTER_OPERAND;
+
+        if (inst_cream->S && (inst_cream->Rd != 15)) {
+            RD = cpu->AddWithLazyFlags(rn_val, rop, 0);
+        } else {
+            RD = rn_val + rop;
+        }
 
         if (inst_cream->S && (inst_cream->Rd == 15)) {
             if (cpu->CurrentModeHasSPSR()) {
@@ -1706,11 +2049,6 @@ ADD_INST : {
                 cpu->ChangePrivilegeMode(cpu->Cpsr & 0x1F);
                 LOAD_NZCVT;
             }
-        } else if (inst_cream->S) {
-            UPDATE_NFLAG(RD);
-            UPDATE_ZFLAG(RD);
-            cpu->CFlag = carry;
-            cpu->VFlag = overflow;
         }
         if (inst_cream->Rd == 15) {
             INC_PC(sizeof(add_inst));
@@ -1756,18 +2094,18 @@ AND_INST : {
     GOTO_NEXT_INST;
 }
 BBL_INST : {
+    bbl_inst* inst_cream = (bbl_inst*)inst_base->component;
     if ((inst_base->cond == ConditionCode::AL) || CondPassed(cpu, inst_base->cond)) {
-        bbl_inst* inst_cream = (bbl_inst*)inst_base->component;
         if (inst_cream->L) {
             LINK_RTN_ADDR;
         }
         SET_PC;
         INC_PC(sizeof(bbl_inst));
-        goto DISPATCH;
+        GOTO_LINKED_BLOCK(inst_cream->taken);
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(bbl_inst));
-    goto DISPATCH;
+    GOTO_LINKED_BLOCK(inst_cream->not_taken);
 }
 BIC_INST : {
     bic_inst* inst_cream = (bic_inst*)inst_base->component;
@@ -1902,14 +2240,7 @@ CMN_INST : {
         if (inst_cream->Rn == 15)
             rn_val += 2 * cpu->GetInstructionSize();
 
-        bool carry;
-        bool overflow;
-        u32 result = AddWithCarry(rn_val, SHIFTER_OPERAND, 0, &carry, &overflow);
-
-        UPDATE_NFLAG(result);
-        UPDATE_ZFLAG(result);
-        cpu->CFlag = carry;
-        cpu->VFlag = overflow;
+        cpu->AddWithLazyFlags(rn_val, SHIFTER_OPERAND, 0);
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(cmn_inst));
@@ -1924,14 +2255,7 @@ CMP_INST : {
         if (inst_cream->Rn == 15)
             rn_val += 2 * cpu->GetInstructionSize();
 
-        bool carry;
-        bool overflow;
-        u32 result = AddWithCarry(rn_val, ~SHIFTER_OPERAND, 1, &carry, &overflow);
-
-        UPDATE_NFLAG(result);
-        UPDATE_ZFLAG(result);
-        cpu->CFlag = carry;
-        cpu->VFlag = overflow;
+        cpu->AddWithLazyFlags(rn_val, ~SHIFTER_OPERAND, 1);
     }
     cpu->Reg[15] += cpu->GetInstructionSize();
     INC_PC(sizeof(cmp_inst));
@@ -2827,9 +3151,13 @@ RSB_INST : {
         if (inst_cream->Rn == 15)
             rn_val += 2 * cpu->GetInstructionSize();
 
-        bool carry;
-        bool overflow;
-        RD = AddWithCarry(~rn_val, SHIFTER_OPERAND, 1, &carry, &overflow);
+        u32 rop = SHIFTER_OPERAND;
+
+        if (inst_cream->S && (inst_cream->Rd != 15)) {
+            RD = cpu->AddWithLazyFlags(~rn_val, rop, 1);
+        } else {
+            RD = rop - rn_val;
+        }
 
         if (inst_cream->S && (inst_cream->Rd == 15)) {
             if (cpu->CurrentModeHasSPSR()) {
@@ -2837,11 +3165,6 @@ RSB_INST : {
                 cpu->ChangePrivilegeMode(cpu->Spsr_copy & 0x1F);
                 LOAD_NZCVT;
             }
-        } else if (inst_cream->S) {
-            UPDATE_NFLAG(RD);
-            UPDATE_ZFLAG(RD);
-            cpu->CFlag = carry;
-            cpu->VFlag = overflow;
         }
         if (inst_cream->Rd == 15) {
             INC_PC(sizeof(rsb_inst));
@@ -2861,9 +3184,14 @@ RSC_INST : {
         if (inst_cream->Rn == 15)
             rn_val += 2 * cpu->GetInstructionSize();
 
-        bool carry;
-        bool overflow;
-        RD = AddWithCarry(~rn_val, SHIFTER_OPERAND, cpu->CFlag, &carry, &overflow);
+        u32 rop = SHIFTER_OPERAND;
+        cpu->MaterializeFlags();
+
+        if (inst_cream->S && (inst_cream->Rd != 15)) {
+            RD = cpu->AddWithLazyFlags(~rn_val, rop, cpu->CFlag);
+        } else {
+            RD = ~rn_val + rop + cpu->CFlag;
+        }
 
         if (inst_cream->S && (inst_cream->Rd == 15)) {
             if (cpu->CurrentModeHasSPSR()) {
@@ -2871,11 +3199,6 @@ RSC_INST : {
                 cpu->ChangePrivilegeMode(cpu->Spsr_copy & 0x1F);
                 LOAD_NZCVT;
             }
-        } else if (inst_cream->S) {
-            UPDATE_NFLAG(RD);
-            UPDATE_ZFLAG(RD);
-            cpu->CFlag = carry;
-            cpu->VFlag = overflow;
         }
         if (inst_cream->Rd == 15) {
             INC_PC(sizeof(rsc_inst));
@@ -3003,9 +3326,14 @@ SBC_INST : {
         if (inst_cream->Rn == 15)
             rn_val += 2 * cpu->GetInstructionSize();
 
-        bool carry;
-        bool overflow;
-        RD = AddWithCarry(rn_val, ~SHIFTER_OPERAND, cpu->CFlag, &carry, &overflow);
+        u32 rop = SHIFTER_OPERAND;
+        cpu->MaterializeFlags();
+
+        if (inst_cream->S && (inst_cream->Rd != 15)) {
+            RD = cpu->AddWithLazyFlags(rn_val, ~rop, cpu->CFlag);
+        } else {
+            RD = rn_val + ~rop + cpu->CFlag;
+        }
 
         if (inst_cream->S && (inst_cream->Rd == 15)) {
             if (cpu->CurrentModeHasSPSR()) {
@@ -3013,11 +3341,6 @@ SBC_INST : {
                 cpu->ChangePrivilegeMode(cpu->Spsr_copy & 0x1F);
                 LOAD_NZCVT;
             }
-        } else if (inst_cream->S) {
-            UPDATE_NFLAG(RD);
-            UPDATE_ZFLAG(RD);
-            cpu->CFlag = carry;
-            cpu->VFlag = overflow;
         }
         if (inst_cream->Rd == 15) {
             INC_PC(sizeof(sbc_inst));
@@ -3272,7 +3595,7 @@ SMLAL_INST : {
         RDLO = BITS(rst, 0, 31);
         RDHI = BITS(rst, 32, 63);
         if (inst_cream->S) {
-            cpu->NFlag = BIT(RDHI, 31);
+            UPDATE_NFLAG(RDHI);
             cpu->ZFlag = (RDHI == 0 && RDLO == 0);
         }
     }
@@ -3443,7 +3766,7 @@ SMULL_INST : {
         RDLO = BITS(rst, 0, 31);
 
         if (inst_cream->S) {
-            cpu->NFlag = BIT(RDHI, 31);
+            UPDATE_NFLAG(RDHI);
             cpu->ZFlag = (RDHI == 0 && RDLO == 0);
         }
     }
@@ -3830,9 +4153,13 @@ SUB_INST : {
 
         u32 rn_val = CHECK_READ_REG15_WA(cpu, inst_cream->Rn);
 
-        bool carry;
-        bool overflow;
-        RD = AddWithCarry(rn_val, ~SHIFTER_OPERAND, 1, &carry, &overflow);
+        u32 rop = SHIFTER_OPERAND;
+
+        if (inst_cream->S && (inst_cream->Rd != 15)) {
+            RD = cpu->AddWithLazyFlags(rn_val, ~rop, 1);
+        } else {
+            RD = rn_val - rop;
+        }
 
         if (inst_cream->S && (inst_cream->Rd == 15)) {
             if (cpu->CurrentModeHasSPSR()) {
@@ -3840,11 +4167,6 @@ SUB_INST : {
                 cpu->ChangePrivilegeMode(cpu->Spsr_copy & 0x1F);
                 LOAD_NZCVT;
             }
-        } else if (inst_cream->S) {
-            UPDATE_NFLAG(RD);
-            UPDATE_ZFLAG(RD);
-            cpu->CFlag = carry;
-            cpu->VFlag = overflow;
         }
         if (inst_cream->Rd == 15) {
             INC_PC(sizeof(sub_inst));
@@ -3859,10 +4181,13 @@ SUB_INST : {
 SWI_INST : {
     if (inst_base->cond == ConditionCode::AL || CondPassed(cpu, inst_base->cond)) {
         swi_inst* const inst_cream = (swi_inst*)inst_base->component;
+        // The SVC may save the context of the thread
+        SAVE_NZCVT;
         CoreTiming::AddTicks(num_instrs);
         cpu->NumInstrsToExecute =
             num_instrs >= cpu->NumInstrsToExecute ? 0 : cpu->NumInstrsToExecute - num_instrs;
         num_instrs = 0;
+        idle_loop_iteration.branch = nullptr; // Its instruction count is no longer comparable
         Kernel::CallSVC(inst_cream->num & 0xFFFF);
     }
 
@@ -4283,7 +4608,7 @@ UMLAL_INST : {
         RDHI = BITS(rst, 32, 63);
 
         if (inst_cream->S) {
-            cpu->NFlag = BIT(RDHI, 31);
+            UPDATE_NFLAG(RDHI);
             cpu->ZFlag = (RDHI == 0 && RDLO == 0);
         }
     }
@@ -4302,7 +4627,7 @@ UMULL_INST : {
         RDLO = BITS(rst, 0, 31);
 
         if (inst_cream->S) {
-            cpu->NFlag = BIT(RDHI, 31);
+            UPDATE_NFLAG(RDHI);
             cpu->ZFlag = (RDHI == 0 && RDLO == 0);
         }
     }
@@ -4315,18 +4640,19 @@ B_2_THUMB : {
     b_2_thumb* inst_cream = (b_2_thumb*)inst_base->component;
     cpu->Reg[15] = cpu->Reg[15] + 4 + inst_cream->imm;
     INC_PC(sizeof(b_2_thumb));
-    goto DISPATCH;
+    GOTO_LINKED_BLOCK(inst_cream->taken);
 }
 B_COND_THUMB : {
     b_cond_thumb* inst_cream = (b_cond_thumb*)inst_base->component;
+    INC_PC(sizeof(b_cond_thumb));
 
-    if (CondPassed(cpu, inst_cream->cond))
+    if (CondPassed(cpu, inst_cream->cond)) {
         cpu->Reg[15] = cpu->Reg[15] + 4 + inst_cream->imm;
-    else
-        cpu->Reg[15] += 2;
+        GOTO_LINKED_BLOCK(inst_cream->taken);
+    }
 
-    INC_PC(sizeof(b_cond_thumb));
-    goto DISPATCH;
+    cpu->Reg[15] += 2;
+    GOTO_LINKED_BLOCK(inst_cream->not_taken);
 }
 BL_1_THUMB : {
     bl_1_thumb* inst_cream = (bl_1_thumb*)inst_base->component;
@@ -4570,9 +4896,99 @@ YIELD_INST : {
 #include "core/arm/skyeye_common/vfp/vfpinstr.cpp"
 #undef VFP_INTERPRETER_IMPL
 
+CMP_BBL_FUSED:
+CMP_B_COND_THUMB_FUSED : {
+    FUSED_INST_FALLBACK(CMP_INST);
+
+    if (inst_base->cond == ConditionCode::AL || CondPassed(cpu, inst_base->cond)) {
+        cmp_inst* const inst_cream = (cmp_inst*)inst_base->component;
+
+        u32 rn_val = RN;
+        if (inst_cream->Rn == 15)
+            rn_val += 2 * cpu->GetInstructionSize();
+
+        cpu->AddWithLazyFlags(rn_val, ~SHIFTER_OPERAND, 1);
+    }
+    cpu->Reg[15] += cpu->GetInstructionSize();
+
+    const bool thumb = inst_base->idx == CMP_B_COND_THUMB_FUSED_IDX;
+    INC_PC(sizeof(cmp_inst));
+    if (thumb) {
+        GOTO_FUSED_SECOND_INST(B_COND_THUMB);
+    }
+    GOTO_FUSED_SECOND_INST(BBL_INST);
+}
+MOV_MOV_FUSED : {
+    FUSED_INST_FALLBACK(MOV_INST);
+
+    // The first MOV does not write the PC, as it would end the block otherwise
+    if (inst_base->cond == ConditionCode::AL || CondPassed(cpu, inst_base->cond)) {
+        mov_inst* inst_cream = (mov_inst*)inst_base->component;
+
+        RD = SHIFTER_OPERAND;
+        if (inst_cream->S) {
+            UPDATE_NFLAG(RD);
+            UPDATE_ZFLAG(RD);
+            UPDATE_CFLAG_WITH_SC;
+        }
+    }
+    cpu->Reg[15] += cpu->GetInstructionSize();
+    INC_PC(sizeof(mov_inst));
+    GOTO_FUSED_SECOND_INST(MOV_INST);
+}
+LDR_ADD_FUSED : {
+    FUSED_INST_FALLBACK(LDR_INST);
+
+    // The LDR does not load the PC, as it would end the block otherwise
+    ldst_inst* inst_cream = (ldst_inst*)inst_base->component;
+    inst_cream->get_addr(cpu, inst_cream->inst, addr);
+    cpu->Reg[BITS(inst_cream->inst, 12, 15)] = cpu->ReadMemory32(addr);
+
+    cpu->Reg[15] += cpu->GetInstructionSize();
+    INC_PC(sizeof(ldst_inst));
+    GOTO_FUSED_SECOND_INST(ADD_INST);
+}
+IDLE_LOOP_BBL:
+IDLE_LOOP_B_COND_THUMB : {
+    // Checks whether the loop spins before taking the branch with its usual handler
+    const bool thumb = inst_base->idx == IDLE_LOOP_B_COND_THUMB_IDX;
+    u32 loop_start;
+    unsigned int cond;
+    if (thumb) {
+        const b_cond_thumb* inst_cream = (b_cond_thumb*)inst_base->component;
+        loop_start = cpu->Reg[15] + 4 + inst_cream->imm;
+        cond = inst_cream->cond;
+    } else {
+        const bbl_inst* inst_cream = (bbl_inst*)inst_base->component;
+        loop_start = cpu->Reg[15] + 8 + inst_cream->signed_immed_24;
+        cond = inst_base->cond;
+    }
+
+    if (CondPassed(cpu, cond)) {
+        const u32 loop_size = (cpu->Reg[15] - loop_start) / cpu->GetInstructionSize() + 1;
+        if (idle_loop_iteration.Record(cpu, inst_base, num_instrs, loop_size)) {
+            // Only an event can change the memory the loop reads, so it would spin until the end
+            // of the slice. Execution stops at its next iteration, and the caller skips the rest.
+            cpu->idle_loop_reached = true;
+            cpu->NumInstrsToExecute = num_instrs;
+        }
+    }
+
+    if (thumb)
+        goto B_COND_THUMB;
+    goto BBL_INST;
+}
+
 END : {
     SAVE_NZCVT;
     cpu->NumInstrsToExecute = 0;
+
+    const BlockTable::Stats stats = cpu->instruction_cache.TakeStats();
+    MICROPROFILE_META_CPU("DynCom Block Hits", static_cast<int>(stats.hits));
+    MICROPROFILE_META_CPU("DynCom Block Misses", static_cast<int>(stats.misses));
+    MICROPROFILE_META_CPU("DynCom Page Evictions", static_cast<int>(stats.evictions));
+    MICROPROFILE_META_CPU("DynCom Cache Flushes", static_cast<int>(stats.flushes));
+
     return num_instrs;
 }
 INIT_INST_LENGTH : {
@@ -4,6 +4,25 @@
 
 #pragma once
 
+#include <vector>
+#include "common/common_types.h"
+
 struct ARMul_State;
 
 unsigned InterpreterMainLoop(ARMul_State* state);
+
+/**
+ * Translates the blocks starting at the given entry points ahead of their execution. Blocks that
+ * are already translated are skipped.
+ * @param entry_points Addresses of the first instruction of the blocks, with bit 0 set for Thumb.
+ */
+void InterpreterTranslateBlocks(ARMul_State* state, const std::vector<u32>& entry_points);
+
+#ifdef DYNCOM_BIGRAM_PROFILE
+/**
+ * Logs the pairs of consecutive instructions executed the most by the interpreter since the last
+ * call, and resets the counts.
+ * @param program_id Program ID of the title that was running.
+ */
+void InterpreterLogBigramProfile(u64 program_id);
+#endif
@@ -1,3 +1,4 @@
+#include <array>
 #include <cstdlib>
 #include "common/assert.h"
 #include "common/common_types.h"
@@ -8,11 +9,32 @@
 
 char trans_cache_buf[TRANS_CACHE_SIZE];
 size_t trans_cache_buf_top = 0;
+size_t trans_cache_buf_end = 0;
+
+// Chunks are handed out in ascending order until all of them have been used once, and from the
+// stack of freed chunks afterwards.
+static u32 num_used_chunks = 0;
+static std::array<u32, TRANS_CACHE_NUM_CHUNKS> freed_chunks;
+static size_t num_freed_chunks = 0;
+
+u32 AllocTransCacheChunk() {
+    if (num_freed_chunks != 0)
+        return freed_chunks[--num_freed_chunks];
+    if (num_used_chunks != TRANS_CACHE_NUM_CHUNKS)
+        return num_used_chunks++;
+    return TRANS_CACHE_INVALID_CHUNK;
+}
+
+void FreeTransCacheChunk(u32 chunk) {
+    DEBUG_ASSERT(chunk < num_used_chunks && num_freed_chunks < TRANS_CACHE_NUM_CHUNKS);
+    freed_chunks[num_freed_chunks++] = chunk;
+}
 
 static void* AllocBuffer(size_t size) {
+    DEBUG_ASSERT(size <= TRANS_CACHE_MAX_INST_SIZE);
     size_t start = trans_cache_buf_top;
     trans_cache_buf_top += size;
-    ASSERT_MSG(trans_cache_buf_top <= TRANS_CACHE_SIZE, "Translation cache is full!");
+    ASSERT_MSG(trans_cache_buf_top <= trans_cache_buf_end, "Translation cache chunk overflow!");
     return static_cast<void*>(&trans_cache_buf[start]);
 }
 
@@ -99,6 +121,8 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(bbl)(unsigned int inst, int index) {
 
     inst_cream->L = BIT(inst, 24);
     inst_cream->signed_immed_24 = BIT(inst, 23) ? NEGBRANCH : POSBRANCH;
+    inst_cream->taken = {};
+    inst_cream->not_taken = {};
 
     return inst_base;
 }
@@ -1646,6 +1670,7 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(b_2_thumb)(unsigned int tinst, int ind
     b_2_thumb* inst_cream = (b_2_thumb*)inst_base->component;
 
     inst_cream->imm = ((tinst & 0x3FF) << 1) | ((tinst & (1 << 10)) ? 0xFFFFF800 : 0);
+    inst_cream->taken = {};
 
     inst_base->idx = index;
     inst_base->br = TransExtData::DIRECT_BRANCH;
@@ -1659,6 +1684,8 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(b_cond_thumb)(unsigned int tinst, int
 
     inst_cream->imm = (((tinst & 0x7F) << 1) | ((tinst & (1 << 7)) ? 0xFFFFFF00 : 0));
     inst_cream->cond = ((tinst >> 8) & 0xf);
+    inst_cream->taken = {};
+    inst_cream->not_taken = {};
     inst_base->idx = index;
     inst_base->br = TransExtData::DIRECT_BRANCH;
 
@@ -18,6 +18,17 @@ enum class TransExtData {
     SINGLE_STEP = (1 << 8)
 };
 
+/**
+ * Direct link from the end of a translated block to the translated block it continues into.
+ * A link is only followed while its generation matches the one of the block table, so
+ * invalidating any translated code breaks every link at once.
+ */
+struct BlockLink {
+    u32 offset;
+    u32 generation;
+    u32 page_index; ///< Guest page number of the linked block
+};
+
 struct arm_inst {
     unsigned int idx;
     unsigned int cond;
@@ -82,8 +93,8 @@ struct eor_inst {
 struct bbl_inst {
     unsigned int L;
     int signed_immed_24;
-    unsigned int next_addr;
-    unsigned int jmp_addr;
+    BlockLink taken;
+    BlockLink not_taken;
 };
 
 struct bx_inst {
@@ -447,10 +458,13 @@ struct setend_inst {
 
 struct b_2_thumb {
     unsigned int imm;
+    BlockLink taken;
 };
 struct b_cond_thumb {
     unsigned int imm;
     unsigned int cond;
+    BlockLink taken;
+    BlockLink not_taken;
 };
 
 struct bl_1_thumb {
@@ -489,6 +503,27 @@ typedef ARM_INST_PTR (*transop_fp_t)(unsigned int, int);
 extern const transop_fp_t arm_instruction_trans[];
 extern const size_t arm_instruction_trans_len;
 
-#define TRANS_CACHE_SIZE (64 * 1024 * 2000)
+// The translation cache is split into fixed-size chunks, which are handed out to the guest code
+// pages whose blocks they hold. A translated block never spans more than one chunk.
+constexpr size_t TRANS_CACHE_CHUNK_SIZE = 16 * 1024;
+constexpr size_t TRANS_CACHE_NUM_CHUNKS = 8000;
+constexpr u32 TRANS_CACHE_INVALID_CHUNK = 0xFFFFFFFF;
+
+// Upper bound of the space taken by a single translated instruction.
+constexpr size_t TRANS_CACHE_MAX_INST_SIZE = 128;
+
+#define TRANS_CACHE_SIZE (TRANS_CACHE_CHUNK_SIZE * TRANS_CACHE_NUM_CHUNKS)
 extern char trans_cache_buf[TRANS_CACHE_SIZE];
+
+// Bounds of the chunk space instructions are currently being translated into
 extern size_t trans_cache_buf_top;
+extern size_t trans_cache_buf_end;
+
+/**
+ * Takes a chunk from the pool of free translation cache chunks.
+ * @returns The index of the chunk, or TRANS_CACHE_INVALID_CHUNK if all chunks are in use.
+ */
+u32 AllocTransCacheChunk();
+
+/// Returns a chunk obtained with AllocTransCacheChunk() to the pool of free chunks.
+void FreeTransCacheChunk(u32 chunk);
@@ -188,13 +188,13 @@ static void CheckMemoryBreakpoint(u32 address, GDBStub::BreakpointType type) {
     }
 }
 
-u8 ARMul_State::ReadMemory8(u32 address) const {
+u8 ARMul_State::SlowReadMemory8(u32 address) const {
     CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Read);
 
     return Memory::Read8(address);
 }
 
-u16 ARMul_State::ReadMemory16(u32 address) const {
+u16 ARMul_State::SlowReadMemory16(u32 address) const {
     CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Read);
 
     u16 data = Memory::Read16(address);
@@ -205,7 +205,7 @@ u16 ARMul_State::ReadMemory16(u32 address) const {
     return data;
 }
 
-u32 ARMul_State::ReadMemory32(u32 address) const {
+u32 ARMul_State::SlowReadMemory32(u32 address) const {
     CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Read);
 
     u32 data = Memory::Read32(address);
@@ -216,7 +216,7 @@ u32 ARMul_State::ReadMemory32(u32 address) const {
     return data;
 }
 
-u64 ARMul_State::ReadMemory64(u32 address) const {
+u64 ARMul_State::SlowReadMemory64(u32 address) const {
     CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Read);
 
     u64 data = Memory::Read64(address);
@@ -227,13 +227,13 @@ u64 ARMul_State::ReadMemory64(u32 address) const {
     return data;
 }
 
-void ARMul_State::WriteMemory8(u32 address, u8 data) {
+void ARMul_State::SlowWriteMemory8(u32 address, u8 data) {
     CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Write);
 
     Memory::Write8(address, data);
 }
 
-void ARMul_State::WriteMemory16(u32 address, u16 data) {
+void ARMul_State::SlowWriteMemory16(u32 address, u16 data) {
     CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Write);
 
     if (InBigEndianMode())
@@ -242,7 +242,7 @@ void ARMul_State::WriteMemory16(u32 address, u16 data) {
     Memory::Write16(address, data);
 }
 
-void ARMul_State::WriteMemory32(u32 address, u32 data) {
+void ARMul_State::SlowWriteMemory32(u32 address, u32 data) {
     CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Write);
 
     if (InBigEndianMode())
@@ -251,7 +251,7 @@ void ARMul_State::WriteMemory32(u32 address, u32 data) {
     Memory::Write32(address, data);
 }
 
-void ARMul_State::WriteMemory64(u32 address, u64 data) {
+void ARMul_State::SlowWriteMemory64(u32 address, u64 data) {
     CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Write);
 
     if (InBigEndianMode())
@@ -18,10 +18,13 @@
 #pragma once
 
 #include <array>
-#include <unordered_map>
+#include <cstring>
 #include "common/common_types.h"
+#include "core/arm/dyncom/arm_dyncom_block_table.h"
 #include "core/arm/skyeye_common/arm_regformat.h"
 
+class BlockDiskCache;
+
 // Signal levels
 enum { LOW = 0, HIGH = 1, LOWHIGH = 1, HIGHLOW = 2 };
 
@@ -145,14 +148,69 @@ public:
 
     // Reads/writes data in big/little endian format based on the
     // state of the E (endian) bit in the APSR.
-    u8 ReadMemory8(u32 address) const;
-    u16 ReadMemory16(u32 address) const;
-    u32 ReadMemory32(u32 address) const;
-    u64 ReadMemory64(u32 address) const;
-    void WriteMemory8(u32 address, u8 data);
-    void WriteMemory16(u32 address, u16 data);
-    void WriteMemory32(u32 address, u32 data);
-    void WriteMemory64(u32 address, u64 data);
+    u8 ReadMemory8(u32 address) const {
+        if (const u8* pointer = GetFastMemoryPointer(address))
+            return LoadFromHost<u8>(pointer);
+        return SlowReadMemory8(address);
+    }
+    u16 ReadMemory16(u32 address) const {
+        if (const u8* pointer = GetFastMemoryPointer(address))
+            return LoadFromHost<u16>(pointer);
+        return SlowReadMemory16(address);
+    }
+    u32 ReadMemory32(u32 address) const {
+        if (const u8* pointer = GetFastMemoryPointer(address))
+            return LoadFromHost<u32>(pointer);
+        return SlowReadMemory32(address);
+    }
+    u64 ReadMemory64(u32 address) const {
+        if (const u8* pointer = GetFastMemoryPointer(address))
+            return LoadFromHost<u64>(pointer);
+        return SlowReadMemory64(address);
+    }
+    void WriteMemory8(u32 address, u8 data) {
+        if (u8* pointer = GetFastMemoryPointer(address)) {
+            StoreToHost(pointer, data);
+            return;
+        }
+        SlowWriteMemory8(address, data);
+    }
+    void WriteMemory16(u32 address, u16 data) {
+        if (u8* pointer = GetFastMemoryPointer(address)) {
+            StoreToHost(pointer, data);
+            return;
+        }
+        SlowWriteMemory16(address, data);
+    }
+    void WriteMemory32(u32 address, u32 data) {
+        if (u8* pointer = GetFastMemoryPointer(address)) {
+            StoreToHost(pointer, data);
+            return;
+        }
+        SlowWriteMemory32(address, data);
+    }
+    void WriteMemory64(u32 address, u64 data) {
+        if (u8* pointer = GetFastMemoryPointer(address)) {
+            StoreToHost(pointer, data);
+            return;
+        }
+        SlowWriteMemory64(address, data);
+    }
+
+    /**
+     * Returns a host pointer to the given address if the CPU can access it directly, or nullptr if
+     * the access has to go through the memory system: the page is not plain memory (unmapped,
+     * MMIO or cached by the rasterizer), the CPU is in big endian mode, or no page table is set
+     * for direct accesses (see fast_page_pointers).
+     */
+    u8* GetFastMemoryPointer(u32 address) const {
+        if (fast_page_pointers == nullptr || InBigEndianMode())
+            return nullptr;
+        u8* page_pointer = (*fast_page_pointers)[address >> Memory::PAGE_BITS];
+        if (page_pointer == nullptr)
+            return nullptr;
+        return page_pointer + (address & Memory::PAGE_MASK);
+    }
 
     u32 ReadCP15Register(u32 crn, u32 opcode_1, u32 crm, u32 opcode_2) const;
     void WriteCP15Register(u32 value, u32 crn, u32 opcode_1, u32 crm, u32 opcode_2);
@@ -189,6 +247,40 @@ public:
         return TFlag ? 2 : 4;
     }
 
+    /**
+     * Returns left + right + carry_in, like AddWithCarry(), but only records the operands instead
+     * of setting the NZCV flags. The flags are computed by MaterializeFlags() once something needs
+     * them, which a following flag-setting instruction often makes unnecessary.
+     */
+    u32 AddWithLazyFlags(u32 left, u32 right, u32 carry_in) {
+        lazy_flags_pending = true;
+        lazy_flags_left = left;
+        lazy_flags_right = right;
+        lazy_flags_carry_in = carry_in;
+        return left + right + carry_in;
+    }
+
+    /// Sets NFlag, ZFlag, CFlag and VFlag from the last AddWithLazyFlags() if still pending.
+    void MaterializeFlags() {
+        if (!lazy_flags_pending)
+            return;
+
+        const u64 unsigned_sum =
+            static_cast<u64>(lazy_flags_left) + lazy_flags_right + lazy_flags_carry_in;
+        const u32 result = static_cast<u32>(unsigned_sum);
+
+        NFlag = result >> 31;
+        ZFlag = result == 0;
+        CFlag = static_cast<u32>(unsigned_sum >> 32);
+        VFlag = ((lazy_flags_left ^ result) & (lazy_flags_right ^ result)) >> 31;
+        lazy_flags_pending = false;
+    }
+
+    /// Drops the flags of the last AddWithLazyFlags(), for when all of NZCV are overwritten.
+    void DiscardLazyFlags() {
+        lazy_flags_pending = false;
+    }
+
     std::array<u32, 16> Reg{}; // The current register file
     std::array<u32, 2> Reg_usr{};
     std::array<u32, 2> Reg_svc{};   // R13_SVC R14_SVC
@@ -218,8 +310,20 @@ public:
     u32 NFlag, ZFlag, CFlag, VFlag, IFFlags; // Dummy flags for speed
     unsigned int shifter_carry_out;
 
+    // Operands of the last flag-setting addition whose flags were not computed yet
+    bool lazy_flags_pending = false;
+    u32 lazy_flags_left = 0;
+    u32 lazy_flags_right = 0;
+    u32 lazy_flags_carry_in = 0;
+
     u32 TFlag; // Thumb state
 
+    // Host pointers of the pages of the current page table, used by the memory accesses to skip
+    // the memory system for plain memory. Pages that need special handling have null pointers in
+    // the page table, so they keep going through it. Null when every access has to go through the
+    // memory system, e.g. to check for memory breakpoints.
+    const std::array<u8*, Memory::PAGE_TABLE_NUM_ENTRIES>* fast_page_pointers = nullptr;
+
     unsigned long long NumInstrs; // The number of instructions executed
     unsigned NumInstrsToExecute;
 
@@ -234,11 +338,40 @@ public:
 
     // TODO(bunnei): Move this cache to a better place - it should be per codeset (likely per
     // process for our purposes), not per ARMul_State (which tracks CPU core state).
-    std::unordered_map<u32, std::size_t> instruction_cache;
+    BlockTable instruction_cache;
+
+    /// Records the blocks translated by the interpreter when the translation disk cache is used
+    BlockDiskCache* block_disk_cache = nullptr;
+
+    /// Whether the interpreter looks for idle loops in the blocks it translates
+    bool idle_loop_skipping = false;
+    /// Set by the interpreter when it stops early because the CPU is spinning in an idle loop
+    bool idle_loop_reached = false;
 
 private:
     void ResetMPCoreCP15Registers();
 
+    template <typename T>
+    static T LoadFromHost(const u8* pointer) {
+        T data;
+        std::memcpy(&data, pointer, sizeof(T));
+        return data;
+    }
+
+    template <typename T>
+    static void StoreToHost(u8* pointer, T data) {
+        std::memcpy(pointer, &data, sizeof(T));
+    }
+
+    u8 SlowReadMemory8(u32 address) const;
+    u16 SlowReadMemory16(u32 address) const;
+    u32 SlowReadMemory32(u32 address) const;
+    u64 SlowReadMemory64(u32 address) const;
+    void SlowWriteMemory8(u32 address, u8 data);
+    void SlowWriteMemory16(u32 address, u16 data);
+    void SlowWriteMemory32(u32 address, u32 data);
+    void SlowWriteMemory64(u32 address, u64 data);
+
     // Defines a reservation granule of 2 words, which protects the first 2 words starting at the
     // tag. This is the smallest granule allowed by the v7 spec, and is coincidentally just large
     // enough to support LDR/STREXD.
@@ -2,13 +2,20 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cinttypes>
+#include <cstdlib>
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 #include "audio_core/audio_core.h"
 #include "common/logging/log.h"
+#include "common/string_util.h"
 #include "core/arm/arm_interface.h"
 #include "core/arm/dynarmic/arm_dynarmic.h"
 #include "core/arm/dyncom/arm_dyncom.h"
+#include "core/arm/dyncom/arm_dyncom_interpreter.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/gdbstub/gdbstub.h"
@@ -27,6 +34,21 @@ namespace Core {
 
 /*static*/ System System::s_instance;
 
+/// Returns whether the settings enable idle loop skipping for a title.
+static bool IsIdleLoopSkippingEnabled(u64 program_id) {
+    if (!Settings::values.use_idle_loop_skipping)
+        return false;
+
+    std::vector<std::string> titles;
+    Common::SplitString(Settings::values.idle_loop_skipping_disabled_titles, ',', titles);
+    for (const std::string& title : titles) {
+        const std::string title_id = Common::StripSpaces(title);
+        if (!title_id.empty() && std::strtoull(title_id.c_str(), nullptr, 16) == program_id)
+            return false;
+    }
+    return true;
+}
+
 System::ResultStatus System::RunLoop(bool tight_loop) {
     status = ResultStatus::Success;
     if (!cpu_core) {
@@ -121,6 +143,23 @@ System::ResultStatus System::Load(EmuWindow* emu_window, const std::string& file
         }
     }
     Memory::SetCurrentPageTable(&Kernel::g_current_process->vm_manager.page_table);
+
+    if (cpu_profiler) {
+        std::vector<Loader::Symbol> symbols;
+        if (app_loader->ReadSymbols(symbols) == Loader::ResultStatus::Success) {
+            LOG_INFO(Core, "Loaded %zu symbols for the CPU profiler", symbols.size());
+        }
+        cpu_profiler->SetSymbols(std::move(symbols));
+    }
+
+    u64 program_id = 0;
+    app_loader->ReadProgramId(program_id);
+    cpu_core->SetIdleLoopSkipping(IsIdleLoopSkippingEnabled(program_id));
+
+    if (Settings::values.use_shader_disk_cache) {
+        VideoCore::LoadShaderDiskCache(program_id);
+    }
+
     status = ResultStatus::Success;
     return status;
 }
@@ -131,7 +170,8 @@ void System::PrepareReschedule() {
 }
 
 PerfStats::Results System::GetAndResetPerfStats() {
-    return perf_stats.GetAndResetStats(CoreTiming::GetGlobalTimeUs());
+    return perf_stats.GetAndResetStats(CoreTiming::GetGlobalTimeUs(),
+                                       CoreTiming::GetSliceStats());
 }
 
 void System::Reschedule() {
@@ -155,12 +195,19 @@ System::ResultStatus System::Init(EmuWindow* emu_window, u32 system_mode) {
     telemetry_session = std::make_unique<Core::TelemetrySession>();
 
     CoreTiming::Init();
+    CoreTiming::SetAdaptiveSlicing(Settings::values.use_adaptive_slicing);
     HW::Init();
     Kernel::Init(system_mode);
     Service::Init();
     AudioCore::Init();
     GDBStub::Init();
 
+    if (Settings::values.enable_cpu_profiler && Settings::values.cpu_profiler_sample_rate != 0) {
+        cpu_profiler = std::make_unique<CPUProfiler>();
+        cpu_profiler->Start(std::max<s64>(
+            1, BASE_CLOCK_RATE_ARM11 / Settings::values.cpu_profiler_sample_rate));
+    }
+
     if (!VideoCore::Init(emu_window)) {
         return ResultStatus::ErrorVideoCore;
     }
@@ -184,6 +231,14 @@ void System::Shutdown() {
     Telemetry().AddField(Telemetry::FieldType::Performance, "Shutdown_Frametime",
                          perf_results.frametime * 1000.0);
 
+    if (cpu_profiler) {
+        cpu_profiler->Stop();
+        u64 program_id = 0;
+        app_loader->ReadProgramId(program_id);
+        cpu_profiler->WriteReports(program_id);
+        cpu_profiler = nullptr;
+    }
+
     // Shutdown emulation session
     GDBStub::Shutdown();
     AudioCore::Shutdown();
@@ -192,6 +247,16 @@ void System::Shutdown() {
     Kernel::Shutdown();
     HW::Shutdown();
     CoreTiming::Shutdown();
+#ifdef DYNCOM_BIGRAM_PROFILE
+    u64 program_id = 0;
+    app_loader->ReadProgramId(program_id);
+    InterpreterLogBigramProfile(program_id);
+#endif
+    cpu_core->SaveTranslationCache();
+    if (cpu_core->GetNumSkippedIdleLoops() != 0) {
+        LOG_INFO(Core, "Skipped %" PRIu64 " cycles in %" PRIu64 " idle loops",
+                 cpu_core->GetSkippedIdleCycles(), cpu_core->GetNumSkippedIdleLoops());
+    }
     cpu_core = nullptr;
     app_loader = nullptr;
     telemetry_session = nullptr;
@@ -7,6 +7,7 @@
 #include <memory>
 #include <string>
 #include "common/common_types.h"
+#include "core/cpu_profiler.h"
 #include "core/loader/loader.h"
 #include "core/memory.h"
 #include "core/perf_stats.h"
@@ -144,6 +145,9 @@ private:
     /// Telemetry session for this emulation session
     std::unique_ptr<Core::TelemetrySession> telemetry_session;
 
+    /// Sampling profiler of the ARM11 core, only created when enabled in the settings
+    std::unique_ptr<CPUProfiler> cpu_profiler;
+
     static System s_instance;
 
     ResultStatus status = ResultStatus::Success;
@@ -5,6 +5,8 @@
 #include "core/core_timing.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cinttypes>
 #include <mutex>
 #include <string>
@@ -32,13 +34,10 @@ struct Event {
     u64 fifo_order;
     u64 userdata;
     const EventType* type;
+    u32 handle; ///< Index of this event in event_handles
 };
 
 // Sort by time, unless the times are the same, in which case sort by the order added to the queue
-static bool operator>(const Event& left, const Event& right) {
-    return std::tie(left.time, left.fifo_order) > std::tie(right.time, right.fifo_order);
-}
-
 static bool operator<(const Event& left, const Event& right) {
     return std::tie(left.time, left.fifo_order) < std::tie(right.time, right.fifo_order);
 }
@@ -47,18 +46,64 @@ static bool operator<(const Event& left, const Event& right) {
 // remain stable regardless of rehashes/resizing.
 static std::unordered_map<std::string, EventType> event_types;
 
-// The queue is a min-heap using std::make_heap/push_heap/pop_heap.
+// The queue is an indexed binary min-heap. Each scheduled event has a handle whose entry in
+// event_handles tracks where the event is in the heap, so that any event can be erased in
+// O(log n) once found. Scheduled events are found by type and userdata through events_by_key.
 // We don't use std::priority_queue because we need to be able to serialize, unserialize and
-// erase arbitrary events (RemoveEvent()) regardless of the queue order. These aren't accomodated
-// by the standard adaptor class.
+// erase arbitrary events regardless of the queue order.
 static std::vector<Event> event_queue;
 static u64 event_fifo_id;
+
+static constexpr u32 INVALID_HANDLE = 0xFFFFFFFF;
+
+struct EventHandle {
+    size_t position; ///< Position of the event in event_queue
+    u32 next;        ///< Handle of the next scheduled event with the same type and userdata
+};
+
+// Indexed by handle. Handles of events that left the queue are reused.
+static std::vector<EventHandle> event_handles;
+static std::vector<u32> free_handles;
+
+struct EventKey {
+    const EventType* type;
+    u64 userdata;
+
+    bool operator==(const EventKey& other) const {
+        return type == other.type && userdata == other.userdata;
+    }
+};
+
+struct EventKeyHash {
+    size_t operator()(const EventKey& key) const {
+        return std::hash<const EventType*>()(key.type) ^
+               static_cast<size_t>(key.userdata * 0x9E3779B97F4A7C15);
+    }
+};
+
+// First handle of the scheduled events of each type and userdata. Keys are kept after their last
+// event left the queue, so that events which are often rescheduled (like thread wakeups) do not
+// allocate. They are pruned once they outnumber the scheduled events.
+static std::unordered_map<EventKey, u32, EventKeyHash> events_by_key;
+
 // the queue for storing the events from other threads threadsafe until they will be added
 // to the event_queue by the emu thread
 static Common::MPSCQueue<Event, false> ts_queue;
 
 static constexpr int MAX_SLICE_LENGTH = 20000;
 
+// Bounds of the maximum slice length with adaptive slicing
+static constexpr int MIN_ADAPTIVE_SLICE_LENGTH = MAX_SLICE_LENGTH / 8;
+static constexpr int MAX_ADAPTIVE_SLICE_LENGTH = MAX_SLICE_LENGTH * 16;
+
+static bool adaptive_slicing;
+static int max_slice_length;
+
+// Statistics of the slices, only written by the emu thread
+static std::atomic<u64> num_slices;
+static std::atomic<u64> total_slice_cycles;
+static std::atomic<u64> advance_time_ns;
+
 static s64 idled_cycles;
 
 // Are we in a function that has been called from Advance()
@@ -70,6 +115,102 @@ static EventType* ev_lost = nullptr;
 
 static void EmptyTimedCallback(u64 userdata, s64 cyclesLate) {}
 
+static void PlaceEvent(size_t position, Event&& event) {
+    event_handles[event.handle].position = position;
+    event_queue[position] = std::move(event);
+}
+
+static void SiftUp(size_t position) {
+    Event event = std::move(event_queue[position]);
+    while (position > 0) {
+        const size_t parent = (position - 1) / 2;
+        if (!(event < event_queue[parent]))
+            break;
+        PlaceEvent(position, std::move(event_queue[parent]));
+        position = parent;
+    }
+    PlaceEvent(position, std::move(event));
+}
+
+static void SiftDown(size_t position) {
+    Event event = std::move(event_queue[position]);
+    const size_t size = event_queue.size();
+    while (true) {
+        size_t child = position * 2 + 1;
+        if (child >= size)
+            break;
+        if (child + 1 < size && event_queue[child + 1] < event_queue[child])
+            ++child;
+        if (!(event_queue[child] < event))
+            break;
+        PlaceEvent(position, std::move(event_queue[child]));
+        position = child;
+    }
+    PlaceEvent(position, std::move(event));
+}
+
+static void PruneEventKeys() {
+    for (auto it = events_by_key.begin(); it != events_by_key.end();) {
+        if (it->second == INVALID_HANDLE) {
+            it = events_by_key.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+static void PushEvent(Event&& event) {
+    if (free_handles.empty()) {
+        event.handle = static_cast<u32>(event_handles.size());
+        event_handles.push_back({});
+    } else {
+        event.handle = free_handles.back();
+        free_handles.pop_back();
+    }
+
+    // Looked up before emplacing, as emplace() allocates a node even when the key exists
+    const EventKey key{event.type, event.userdata};
+    auto it = events_by_key.find(key);
+    if (it == events_by_key.end()) {
+        if (events_by_key.size() > 2 * event_queue.size() + 64) {
+            PruneEventKeys();
+        }
+        it = events_by_key.emplace(key, INVALID_HANDLE).first;
+    }
+    event_handles[event.handle].next = it->second;
+    it->second = event.handle;
+
+    event_queue.emplace_back(std::move(event));
+    SiftUp(event_queue.size() - 1);
+}
+
+/// Removes the event at the given position of the queue, and returns it.
+static Event EraseEvent(size_t position) {
+    Event event = std::move(event_queue[position]);
+
+    u32* link = &events_by_key.find(EventKey{event.type, event.userdata})->second;
+    while (*link != event.handle) {
+        link = &event_handles[*link].next;
+    }
+    *link = event_handles[event.handle].next;
+    free_handles.push_back(event.handle);
+
+    // Fill the hole with the last event, which can then belong above or below it
+    Event last = std::move(event_queue.back());
+    event_queue.pop_back();
+    if (position < event_queue.size()) {
+        const bool move_up = position > 0 && last < event_queue[(position - 1) / 2];
+        PlaceEvent(position, std::move(last));
+        if (move_up) {
+            SiftUp(position);
+        } else {
+            SiftDown(position);
+        }
+    }
+
+    return event;
+}
+
 EventType* RegisterEvent(const std::string& name, TimedCallback callback) {
     // check for existing type with same name.
     // we want event type names to remain unique so that we can use them for serialization.
@@ -95,6 +236,12 @@ void Init() {
     global_timer = 0;
     idled_cycles = 0;
 
+    adaptive_slicing = false;
+    max_slice_length = MAX_SLICE_LENGTH;
+    num_slices = 0;
+    total_slice_cycles = 0;
+    advance_time_ns = 0;
+
     // The time between CoreTiming being intialized and the first call to Advance() is considered
     // the slice boundary between slice -1 and slice 0. Dispatcher loops must call Advance() before
     // executing the first cycle of each slice to prepare the slice length and downcount for
@@ -131,6 +278,9 @@ u64 GetIdleTicks() {
 
 void ClearPendingEvents() {
     event_queue.clear();
+    event_handles.clear();
+    free_handles.clear();
+    events_by_key.clear();
 }
 
 void ScheduleEvent(s64 cycles_into_future, const EventType* event_type, u64 userdata) {
@@ -141,34 +291,34 @@ void ScheduleEvent(s64 cycles_into_future, const EventType* event_type, u64 user
     if (!is_global_timer_sane)
         ForceExceptionCheck(cycles_into_future);
 
-    event_queue.emplace_back(Event{timeout, event_fifo_id++, userdata, event_type});
-    std::push_heap(event_queue.begin(), event_queue.end(), std::greater<Event>());
+    PushEvent(Event{timeout, event_fifo_id++, userdata, event_type, 0});
 }
 
 void ScheduleEventThreadsafe(s64 cycles_into_future, const EventType* event_type, u64 userdata) {
-    ts_queue.Push(Event{global_timer + cycles_into_future, 0, userdata, event_type});
+    ts_queue.Push(Event{global_timer + cycles_into_future, 0, userdata, event_type, 0});
 }
 
 void UnscheduleEvent(const EventType* event_type, u64 userdata) {
-    auto itr = std::remove_if(event_queue.begin(), event_queue.end(), [&](const Event& e) {
-        return e.type == event_type && e.userdata == userdata;
-    });
+    auto it = events_by_key.find(EventKey{event_type, userdata});
+    if (it == events_by_key.end())
+        return;
 
-    // Removing random items breaks the invariant so we have to re-establish it.
-    if (itr != event_queue.end()) {
-        event_queue.erase(itr, event_queue.end());
-        std::make_heap(event_queue.begin(), event_queue.end(), std::greater<Event>());
+    while (it->second != INVALID_HANDLE) {
+        EraseEvent(event_handles[it->second].position);
     }
 }
 
 void RemoveEvent(const EventType* event_type) {
-    auto itr = std::remove_if(event_queue.begin(), event_queue.end(),
-                              [&](const Event& e) { return e.type == event_type; });
+    std::vector<u32> handles;
+    for (const Event& event : event_queue) {
+        if (event.type == event_type) {
+            handles.push_back(event.handle);
+        }
+    }
 
-    // Removing random items breaks the invariant so we have to re-establish it.
-    if (itr != event_queue.end()) {
-        event_queue.erase(itr, event_queue.end());
-        std::make_heap(event_queue.begin(), event_queue.end(), std::greater<Event>());
+    // Erasing an event moves others around, so look up each one again
+    for (u32 handle : handles) {
+        EraseEvent(event_handles[handle].position);
     }
 }
 
@@ -190,24 +340,53 @@ void ForceExceptionCheck(s64 cycles) {
 void MoveEvents() {
     for (Event ev; ts_queue.Pop(ev);) {
         ev.fifo_order = event_fifo_id++;
-        event_queue.emplace_back(std::move(ev));
-        std::push_heap(event_queue.begin(), event_queue.end(), std::greater<Event>());
+        PushEvent(std::move(ev));
     }
 }
 
+/**
+ * Adapts the maximum slice length to the way the slice that just ended went. Slices that end before
+ * their downcount runs out, which happens on every reschedule (e.g. on IPC), and events scheduled
+ * by other threads shorten it, so that the slices end more often. Slices that run to the maximum
+ * length without any event lengthen it, so that fewer of them are needed while nothing happens.
+ */
+static void AdaptMaxSliceLength(int cycles_executed, bool threadsafe_events) {
+    // Empty slices, like slice -1, say nothing about the load
+    if (cycles_executed == 0)
+        return;
+
+    if (downcount > 0 || threadsafe_events) {
+        max_slice_length = std::max(MIN_ADAPTIVE_SLICE_LENGTH, max_slice_length / 2);
+    } else if (slice_length == max_slice_length) {
+        max_slice_length = std::min(MAX_ADAPTIVE_SLICE_LENGTH, max_slice_length * 2);
+    }
+}
+
+/// Adds to a statistic. Only the emu thread writes them, so this does not need to be atomic.
+static void AddToStat(std::atomic<u64>& stat, u64 value) {
+    stat.store(stat.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
 void Advance() {
+    const auto advance_start = std::chrono::steady_clock::now();
+
+    const bool threadsafe_events = !ts_queue.Empty();
     MoveEvents();
 
     int cycles_executed = slice_length - downcount;
     global_timer += cycles_executed;
-    slice_length = MAX_SLICE_LENGTH;
+    AddToStat(num_slices, 1);
+    AddToStat(total_slice_cycles, cycles_executed);
+
+    if (adaptive_slicing) {
+        AdaptMaxSliceLength(cycles_executed, threadsafe_events);
+    }
+    slice_length = max_slice_length;
 
     is_global_timer_sane = true;
 
     while (!event_queue.empty() && event_queue.front().time <= global_timer) {
-        Event evt = std::move(event_queue.front());
-        std::pop_heap(event_queue.begin(), event_queue.end(), std::greater<Event>());
-        event_queue.pop_back();
+        Event evt = EraseEvent(0);
         evt.type->callback(evt.userdata, global_timer - evt.time);
     }
 
@@ -216,10 +395,33 @@ void Advance() {
     // Still events left (scheduled in the future)
     if (!event_queue.empty()) {
         slice_length = static_cast<int>(
-            std::min<s64>(event_queue.front().time - global_timer, MAX_SLICE_LENGTH));
+            std::min<s64>(event_queue.front().time - global_timer, max_slice_length));
     }
 
     downcount = slice_length;
+
+    const auto advance_time = std::chrono::steady_clock::now() - advance_start;
+    AddToStat(advance_time_ns,
+              std::chrono::duration_cast<std::chrono::nanoseconds>(advance_time).count());
+}
+
+void SetAdaptiveSlicing(bool enabled) {
+    adaptive_slicing = enabled;
+    if (!enabled) {
+        max_slice_length = MAX_SLICE_LENGTH;
+    }
+}
+
+int GetMaxSliceLength() {
+    return max_slice_length;
+}
+
+SliceStats GetSliceStats() {
+    SliceStats stats;
+    stats.num_slices = num_slices.load(std::memory_order_relaxed);
+    stats.total_cycles = total_slice_cycles.load(std::memory_order_relaxed);
+    stats.advance_time_ns = advance_time_ns.load(std::memory_order_relaxed);
+    return stats;
 }
 
 void Idle() {
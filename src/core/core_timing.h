@@ -157,7 +157,7 @@ void ScheduleEvent(s64 cycles_into_future, const EventType* event_type, u64 user
  * This is to be called when outside of hle threads, such as the graphics thread, wants to
  * schedule things to be executed on the main thread.
  * Not that this doesn't change slice_length and thus events scheduled by this might be called
- * with a delay of up to MAX_SLICE_LENGTH
+ * with a delay of up to the maximum slice length
  */
 void ScheduleEventThreadsafe(s64 cycles_into_future, const EventType* event_type, u64 userdata);
 
@@ -179,6 +179,29 @@ void MoveEvents();
 /// Pretend that the main CPU has executed enough cycles to reach the next event.
 void Idle();
 
+/**
+ * Enables or disables adaptive slicing. Slices normally end at the next event, or after 20000
+ * cycles at most. With adaptive slicing, that maximum length grows while slices run to it without
+ * being interrupted, up to 16 times as long, and shrinks down to 8 times as short when slices are
+ * cut short by reschedules or events come from other threads.
+ */
+void SetAdaptiveSlicing(bool enabled);
+
+/// Returns the current maximum length of a slice, in cycles.
+int GetMaxSliceLength();
+
+struct SliceStats {
+    /// Number of slices ended by Advance()
+    u64 num_slices;
+    /// Total number of cycles of these slices
+    u64 total_cycles;
+    /// Walltime spent in Advance(), including the callbacks of the events, in nanoseconds
+    u64 advance_time_ns;
+};
+
+/// Returns the statistics of the slices since Init(). Unlike the rest, this is thread-safe.
+SliceStats GetSliceStats();
+
 /// Clear all pending events. This should ONLY be done on exit.
 void ClearPendingEvents();
 
@@ -0,0 +1,170 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cinttypes>
+#include <map>
+#include <utility>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/string_util.h"
+#include "core/arm/arm_interface.h"
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/cpu_profiler.h"
+#include "core/hle/kernel/thread.h"
+
+namespace Core {
+
+/// Number of functions and blocks logged when the reports are written
+constexpr std::size_t NUM_LOGGED_ENTRIES = 10;
+
+void CPUProfiler::SetSymbols(std::vector<Loader::Symbol> new_symbols) {
+    symbols = std::move(new_symbols);
+    std::sort(symbols.begin(), symbols.end(),
+              [](const Loader::Symbol& a, const Loader::Symbol& b) {
+                  return a.address < b.address;
+              });
+}
+
+void CPUProfiler::AddSample(VAddr pc, VAddr lr) {
+    ++block_samples[pc];
+    ++call_samples[static_cast<u64>(lr) << 32 | pc];
+    ++total_samples;
+}
+
+void CPUProfiler::AddIdleSample() {
+    ++idle_samples;
+    ++total_samples;
+}
+
+void CPUProfiler::Start(s64 period) {
+    sample_period = period;
+    sample_event = CoreTiming::RegisterEvent("CPUProfiler::Sample", [this](u64, int cycles_late) {
+        if (Kernel::GetCurrentThread() == nullptr) {
+            AddIdleSample();
+        } else {
+            AddSample(Core::CPU().GetPC(), Core::CPU().GetReg(14));
+        }
+        CoreTiming::ScheduleEvent(sample_period - cycles_late, sample_event);
+    });
+    CoreTiming::ScheduleEvent(sample_period, sample_event);
+}
+
+void CPUProfiler::Stop() {
+    if (sample_event != nullptr) {
+        CoreTiming::RemoveEvent(sample_event);
+        sample_event = nullptr;
+    }
+}
+
+const Loader::Symbol* CPUProfiler::FindSymbol(VAddr address) const {
+    auto it = std::upper_bound(
+        symbols.begin(), symbols.end(), address,
+        [](VAddr addr, const Loader::Symbol& symbol) { return addr < symbol.address; });
+    if (it == symbols.begin())
+        return nullptr;
+    --it;
+
+    // Symbols of unknown size extend up to the next one
+    if (it->size != 0 && address - it->address >= it->size)
+        return nullptr;
+    return &*it;
+}
+
+std::string CPUProfiler::GetFunctionName(VAddr address) const {
+    const Loader::Symbol* symbol = FindSymbol(address);
+    if (symbol == nullptr)
+        return Common::StringFromFormat("0x%08X", address);
+    return symbol->name;
+}
+
+/// Returns the entries of a histogram sorted by decreasing count, then by increasing key
+template <typename Key>
+static std::vector<std::pair<Key, u64>> SortByCount(
+    const std::unordered_map<Key, u64>& histogram) {
+    std::vector<std::pair<Key, u64>> entries(histogram.begin(), histogram.end());
+    std::sort(entries.begin(), entries.end(),
+              [](const std::pair<Key, u64>& a, const std::pair<Key, u64>& b) {
+                  return a.second != b.second ? a.second > b.second : a.first < b.first;
+              });
+    return entries;
+}
+
+std::string CPUProfiler::GetFlatReport(u64 program_id) const {
+    const double percent_per_sample = total_samples != 0 ? 100.0 / total_samples : 0.0;
+
+    std::string report = Common::StringFromFormat(
+        "CPU profile of title %016" PRIX64 "\n%" PRIu64 " samples, %" PRIu64 " idle (%.2f%%)\n",
+        program_id, total_samples, idle_samples, idle_samples * percent_per_sample);
+
+    if (!symbols.empty()) {
+        std::unordered_map<std::string, u64> function_samples;
+        for (const auto& block : block_samples) {
+            function_samples[GetFunctionName(block.first)] += block.second;
+        }
+
+        report += "\nFunctions:\n  samples  percent  function\n";
+        for (const auto& function : SortByCount(function_samples)) {
+            report += Common::StringFromFormat("%9" PRIu64 "  %6.2f%%  %s\n", function.second,
+                                               function.second * percent_per_sample,
+                                               function.first.c_str());
+        }
+    }
+
+    report += "\nBlocks:\n  samples  percent  address     location\n";
+    for (const auto& block : SortByCount(block_samples)) {
+        std::string location;
+        if (const Loader::Symbol* symbol = FindSymbol(block.first)) {
+            location = Common::StringFromFormat("%s+0x%X", symbol->name.c_str(),
+                                                block.first - symbol->address);
+        }
+        report += Common::StringFromFormat("%9" PRIu64 "  %6.2f%%  0x%08X  %s\n", block.second,
+                                           block.second * percent_per_sample, block.first,
+                                           location.c_str());
+    }
+
+    return report;
+}
+
+std::string CPUProfiler::GetCollapsedStacks() const {
+    // Sorted so that the output does not depend on the order of the hash map
+    std::map<std::string, u64> stacks;
+    for (const auto& call : call_samples) {
+        const VAddr lr = static_cast<VAddr>(call.first >> 32);
+        const VAddr pc = static_cast<VAddr>(call.first);
+        stacks[GetFunctionName(lr) + ';' + GetFunctionName(pc)] += call.second;
+    }
+    if (idle_samples != 0) {
+        stacks["[idle]"] = idle_samples;
+    }
+
+    std::string collapsed;
+    for (const auto& stack : stacks) {
+        collapsed +=
+            Common::StringFromFormat("%s %" PRIu64 "\n", stack.first.c_str(), stack.second);
+    }
+    return collapsed;
+}
+
+void CPUProfiler::WriteReports(u64 program_id) const {
+    const std::string& log_dir = FileUtil::GetUserPath(D_LOGS_IDX);
+    const std::string base_path =
+        Common::StringFromFormat("%scpu_profile_%016" PRIX64, log_dir.c_str(), program_id);
+    FileUtil::CreateFullPath(log_dir);
+    FileUtil::WriteStringToFile(true, GetFlatReport(program_id), (base_path + ".txt").c_str());
+    FileUtil::WriteStringToFile(true, GetCollapsedStacks(), (base_path + ".folded").c_str());
+
+    LOG_INFO(Core, "Wrote CPU profile of %" PRIu64 " samples to %s.txt", total_samples,
+             base_path.c_str());
+    const auto blocks = SortByCount(block_samples);
+    const std::size_t num_logged = std::min(NUM_LOGGED_ENTRIES, blocks.size());
+    for (std::size_t i = 0; i < num_logged; ++i) {
+        LOG_INFO(Core, "0x%08X %-40s %9" PRIu64 " (%.2f%%)", blocks[i].first,
+                 GetFunctionName(blocks[i].first).c_str(), blocks[i].second,
+                 100.0 * blocks[i].second / total_samples);
+    }
+}
+
+} // namespace Core
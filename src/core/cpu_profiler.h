@@ -0,0 +1,102 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+#include "core/loader/loader.h"
+
+namespace CoreTiming {
+struct EventType;
+}
+
+namespace Core {
+
+/**
+ * Sampling profiler for the emulated ARM11 core. While running, it records the guest PC of the
+ * current thread at a fixed interval of emulated time. Samples are taken between CPU time slices,
+ * where the CPU cores always stop at a basic block boundary, so the PC is the entry point of the
+ * next block to run. The link register is recorded along with it as an approximation of the
+ * calling function.
+ *
+ * The histograms can be exported as a flat report, symbolized with the symbols of the executable
+ * when the loader provides them, and as collapsed stacks for flamegraph tools.
+ */
+class CPUProfiler {
+public:
+    /**
+     * Gives the profiler the symbols used to name the sampled addresses.
+     * @param symbols Function symbols of the running application, in any order.
+     */
+    void SetSymbols(std::vector<Loader::Symbol> symbols);
+
+    /**
+     * Records a sample of a running thread.
+     * @param pc Address of the next block to be executed.
+     * @param lr Value of the link register.
+     */
+    void AddSample(VAddr pc, VAddr lr);
+
+    /// Records a sample taken while no thread was running.
+    void AddIdleSample();
+
+    /**
+     * Starts taking samples from Core::CPU(). Must be called after CoreTiming::Init().
+     * @param sample_period Emulated time between samples, in ARM11 cycles.
+     */
+    void Start(s64 sample_period);
+
+    /// Stops taking samples. The samples taken so far are kept.
+    void Stop();
+
+    /// Returns the number of samples taken, including idle ones.
+    u64 GetSampleCount() const {
+        return total_samples;
+    }
+
+    /**
+     * Returns a text report of the sampled functions and blocks, hottest first.
+     * @param program_id Program ID of the profiled title, written in the header of the report.
+     */
+    std::string GetFlatReport(u64 program_id) const;
+
+    /**
+     * Returns the samples as collapsed stacks ("caller;callee count" lines), the input format of
+     * flamegraph.pl and compatible tools.
+     */
+    std::string GetCollapsedStacks() const;
+
+    /**
+     * Writes the flat report and the collapsed stacks of the title to the log directory, as
+     * cpu_profile_<program id>.txt and cpu_profile_<program id>.folded.
+     */
+    void WriteReports(u64 program_id) const;
+
+private:
+    /// Returns the symbol containing the given address, or nullptr.
+    const Loader::Symbol* FindSymbol(VAddr address) const;
+
+    /// Returns the name of the function containing the given address, or the address in hex.
+    std::string GetFunctionName(VAddr address) const;
+
+    /// Symbols sorted by address
+    std::vector<Loader::Symbol> symbols;
+
+    /// Number of samples per block entry point
+    std::unordered_map<VAddr, u64> block_samples;
+
+    /// Number of samples per pair of link register (upper 32 bits) and PC (lower 32 bits)
+    std::unordered_map<u64, u64> call_samples;
+
+    u64 total_samples = 0;
+    u64 idle_samples = 0;
+
+    CoreTiming::EventType* sample_event = nullptr;
+    s64 sample_period = 0;
+};
+
+} // namespace Core
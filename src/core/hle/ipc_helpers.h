@@ -352,13 +352,14 @@ public:
 
     /**
      * @brief Pops a static buffer from the IPC request buffer.
-     * @return The buffer that was copied from the IPC request originator.
+     * @return The buffer sent by the IPC request originator. It stays valid until the request is
+     *         replied to.
      *
      * In real services, static buffers must be set up before any IPC request using those is sent.
      * It is the duty of the process (usually services) to allocate and set up the receiving static
      * buffer information. Our HLE services do not need to set up the buffers beforehand.
      */
-    const std::vector<u8>& PopStaticBuffer();
+    Common::Span<const u8> PopStaticBuffer();
 
     /**
      * @brief Pops the mapped buffer vaddr
@@ -515,7 +516,7 @@ inline VAddr RequestParser::PopStaticBuffer(size_t* data_size) {
     return Pop<VAddr>();
 }
 
-inline const std::vector<u8>& RequestParser::PopStaticBuffer() {
+inline Common::Span<const u8> RequestParser::PopStaticBuffer() {
     const u32 sbuffer_descriptor = Pop<u32>();
     // Pop the address from the incoming request buffer
     Pop<VAddr>();
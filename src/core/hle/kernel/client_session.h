@@ -16,7 +16,7 @@ class ServerSession;
 class Session;
 class Thread;
 
-class ClientSession final : public Object {
+class ClientSession final : public Object, public PooledObject<ClientSession> {
 public:
     friend class ServerSession;
 
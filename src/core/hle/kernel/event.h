@@ -10,7 +10,7 @@
 
 namespace Kernel {
 
-class Event final : public WaitObject {
+class Event final : public WaitObject, public PooledObject<Event> {
 public:
     /**
      * Creates an event
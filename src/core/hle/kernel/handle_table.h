@@ -24,17 +24,17 @@ enum KernelHandle : Handle {
  * approximately the same restrictions as the handle manager in the CTR-OS.
  *
  * Handles contain two sub-fields: a slot index (bits 31:15) and a generation value (bits 14:0).
- * The slot index is used to index into the arrays in this class to access the data corresponding
- * to the Handle.
+ * The slot index is used to index into the slot array in this class to access the data
+ * corresponding to the Handle.
  *
  * To prevent accidental use of a freed Handle whose slot has already been reused, a global counter
  * is kept and incremented every time a Handle is created. This is the Handle's "generation". The
  * value of the counter is stored into the Handle as well as in the handle table (in the
- * "generations" array). When looking up a handle, the Handle's generation must match with the
- * value stored on the class, otherwise the Handle is considered invalid.
+ * "generation" field of the slot). When looking up a handle, the Handle's generation must match
+ * with the value stored on the class, otherwise the Handle is considered invalid.
  *
- * To find free slots when allocating a Handle without needing to scan the entire object array, the
- * generations field of unallocated slots is re-purposed as a linked list of indices to free slots.
+ * To find free slots when allocating a Handle without needing to scan the entire slot array, the
+ * generation field of unallocated slots is re-purposed as a linked list of indices to free slots.
  * When a Handle is created, an index is popped off the list and used for the new Handle. When it
  * is destroyed, it is again pushed onto the list to be re-used by the next allocation. It is
  * likely that this allocation strategy differs from the one used in CTR-OS, but this hasn't been
@@ -102,17 +102,22 @@ private:
         return handle & 0x7FFF;
     }
 
-    /// Stores the Object referenced by the handle or null if the slot is empty.
-    std::array<SharedPtr<Object>, MAX_COUNT> objects;
+    /// A handle slot. Both fields are read by every lookup, so they are stored next to each other.
+    struct Slot {
+        /// The Object referenced by the handle or null if the slot is empty.
+        SharedPtr<Object> object;
 
-    /**
-     * The value of `next_generation` when the handle was created, used to check for validity. For
-     * empty slots, contains the index of the next free slot in the list.
-     */
-    std::array<u16, MAX_COUNT> generations;
+        /**
+         * The value of `next_generation` when the handle was created, used to check for validity.
+         * For empty slots, contains the index of the next free slot in the list.
+         */
+        u16 generation;
+    };
+
+    std::array<Slot, MAX_COUNT> slots;
 
     /**
-     * Global counter of the number of created handles. Stored in `generations` when a handle is
+     * Global counter of the number of created handles. Stored in the slot when a handle is
      * created, and wraps around to 1 when it hits 0x8000.
      */
     u16 next_generation;
@@ -10,6 +10,7 @@
 #include "core/hle/kernel/hle_ipc.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/process.h"
+#include "core/memory.h"
 
 namespace Kernel {
 
@@ -51,13 +52,19 @@ void HLERequestContext::ClearIncomingObjects() {
     request_handles.clear();
 }
 
-const std::vector<u8>& HLERequestContext::GetStaticBuffer(u8 buffer_id) const {
-    ASSERT_MSG(!static_buffers[buffer_id].empty(), "Empty static buffer!");
-    return static_buffers[buffer_id];
+Common::Span<const u8> HLERequestContext::GetStaticBuffer(u8 buffer_id) const {
+    const StaticBuffer& buffer = static_buffers[buffer_id];
+    ASSERT_MSG(buffer.size != 0, "Empty static buffer!");
+    if (buffer.guest_data != nullptr)
+        return {buffer.guest_data, buffer.size};
+    return buffer.storage;
 }
 
 void HLERequestContext::AddStaticBuffer(u8 buffer_id, std::vector<u8> data) {
-    static_buffers[buffer_id] = std::move(data);
+    StaticBuffer& buffer = static_buffers[buffer_id];
+    buffer.guest_data = nullptr;
+    buffer.size = data.size();
+    buffer.storage = std::move(data);
 }
 
 ResultCode HLERequestContext::PopulateFromIncomingCommandBuffer(const u32_le* src_cmdbuf,
@@ -103,12 +110,18 @@ ResultCode HLERequestContext::PopulateFromIncomingCommandBuffer(const u32_le* sr
         case IPC::DescriptorType::StaticBuffer: {
             VAddr source_address = src_cmdbuf[i];
             IPC::StaticBufferDescInfo buffer_info{descriptor};
+            StaticBuffer& buffer = static_buffers[buffer_info.buffer_id];
+
+            // View the input buffer in place, or copy it into our own vector if it is scattered.
+            buffer.guest_data =
+                Memory::GetContiguousPointer(src_process, source_address, buffer_info.size);
+            buffer.size = buffer_info.size;
+            if (buffer.guest_data == nullptr) {
+                buffer.storage.resize(buffer_info.size);
+                Memory::ReadBlock(src_process, source_address, buffer.storage.data(),
+                                  buffer.storage.size());
+            }
 
-            // Copy the input buffer into our own vector and store it.
-            std::vector<u8> data(buffer_info.size);
-            Memory::ReadBlock(src_process, source_address, data.data(), data.size());
-
-            AddStaticBuffer(buffer_info.buffer_id, std::move(data));
             cmd_buf[i++] = source_address;
             break;
         }
@@ -161,7 +174,7 @@ ResultCode HLERequestContext::WriteToOutgoingCommandBuffer(u32_le* dst_cmdbuf, P
         case IPC::DescriptorType::StaticBuffer: {
             IPC::StaticBufferDescInfo buffer_info{descriptor};
 
-            const auto& data = GetStaticBuffer(buffer_info.buffer_id);
+            const Common::Span<const u8> data = GetStaticBuffer(buffer_info.buffer_id);
 
             // Grab the address that the target thread set up to receive the response static buffer
             // and write our data there. The static buffers area is located right after the command
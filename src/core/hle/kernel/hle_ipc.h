@@ -10,6 +10,7 @@
 #include <vector>
 #include <boost/container/small_vector.hpp>
 #include "common/common_types.h"
+#include "common/span.h"
 #include "common/swap.h"
 #include "core/hle/ipc.h"
 #include "core/hle/kernel/kernel.h"
@@ -186,8 +187,10 @@ public:
     /**
      * Retrieves the static buffer identified by the input buffer_id. The static buffer *must* have
      * been created in PopulateFromIncomingCommandBuffer by way of an input StaticBuffer descriptor.
+     * When the buffer is contiguous in the memory of the requesting process, the span views that
+     * memory directly instead of a copy.
      */
-    const std::vector<u8>& GetStaticBuffer(u8 buffer_id) const;
+    Common::Span<const u8> GetStaticBuffer(u8 buffer_id) const;
 
     /**
      * Sets up a static buffer that will be copied to the target process when the request is
@@ -201,6 +204,16 @@ public:
      */
     MappedBuffer& GetMappedBuffer(u32 id_from_cmdbuf);
 
+    /// Returns whether the reply is sent later by an async request instead of after the handler.
+    bool IsReplyDeferred() const {
+        return reply_deferred;
+    }
+
+    /// Marks the reply as sent later by an async request. See Service::RunAsync.
+    void DeferReply() {
+        reply_deferred = true;
+    }
+
     /// Populates this context with data from the requesting process/thread.
     ResultCode PopulateFromIncomingCommandBuffer(const u32_le* src_cmdbuf, Process& src_process,
                                                  HandleTable& src_table);
@@ -209,14 +222,23 @@ public:
                                             HandleTable& dst_table) const;
 
 private:
+    struct StaticBuffer {
+        /// Memory of the requesting process viewed by an incoming buffer, or null if it is stored.
+        const u8* guest_data = nullptr;
+        size_t size = 0;
+        /// Copy of an incoming buffer which isn't contiguous in host memory, or outgoing data.
+        std::vector<u8> storage;
+    };
+
     std::array<u32, IPC::COMMAND_BUFFER_LENGTH> cmd_buf;
     SharedPtr<ServerSession> session;
     // TODO(yuriks): Check common usage of this and optimize size accordingly
     boost::container::small_vector<SharedPtr<Object>, 8> request_handles;
     // The static buffers will be created when the IPC request is translated.
-    std::array<std::vector<u8>, IPC::MAX_STATIC_BUFFERS> static_buffers;
+    std::array<StaticBuffer, IPC::MAX_STATIC_BUFFERS> static_buffers;
     // The mapped buffers will be created when the IPC request is translated
     boost::container::small_vector<MappedBuffer, 8> request_mapped_buffers;
+    bool reply_deferred = false;
 };
 
 } // namespace Kernel
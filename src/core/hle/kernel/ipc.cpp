@@ -85,9 +85,6 @@ ResultCode TranslateCommandBuffer(SharedPtr<Thread> src_thread, SharedPtr<Thread
             IPC::StaticBufferDescInfo bufferInfo{descriptor};
             VAddr static_buffer_src_address = cmd_buf[i];
 
-            std::vector<u8> data(bufferInfo.size);
-            Memory::ReadBlock(*src_process, static_buffer_src_address, data.data(), data.size());
-
             // Grab the address that the target thread set up to receive the response static buffer
             // and write our data there. The static buffers area is located right after the command
             // buffer area.
@@ -107,10 +104,20 @@ ResultCode TranslateCommandBuffer(SharedPtr<Thread> src_thread, SharedPtr<Thread
 
             // Note: The real kernel doesn't seem to have any error recovery mechanisms for this
             // case.
-            ASSERT_MSG(target_buffer.descriptor.size >= data.size(),
+            ASSERT_MSG(target_buffer.descriptor.size >= bufferInfo.size,
                        "Static buffer data is too big");
 
-            Memory::WriteBlock(*dst_process, target_buffer.address, data.data(), data.size());
+            // Copy straight from the source process when the buffer is contiguous in host memory
+            const u8* src_data = Memory::GetContiguousPointer(
+                *src_process, static_buffer_src_address, bufferInfo.size);
+            if (src_data != nullptr) {
+                Memory::WriteBlock(*dst_process, target_buffer.address, src_data, bufferInfo.size);
+            } else {
+                std::vector<u8> data(bufferInfo.size);
+                Memory::ReadBlock(*src_process, static_buffer_src_address, data.data(),
+                                  data.size());
+                Memory::WriteBlock(*dst_process, target_buffer.address, data.data(), data.size());
+            }
 
             cmd_buf[i++] = target_buffer.address;
             break;
@@ -10,6 +10,7 @@
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 #include "common/assert.h"
 #include "common/common_types.h"
+#include "common/object_pool.h"
 
 namespace Kernel {
 
@@ -114,6 +115,35 @@ inline void intrusive_ptr_release(Object* object) {
 template <typename T>
 using SharedPtr = boost::intrusive_ptr<T>;
 
+/**
+ * Base of the kernel object classes which are created and destroyed at high rates, like events and
+ * sessions. Their objects are allocated from a pool per class instead of the heap.
+ */
+template <typename T>
+class PooledObject {
+public:
+    static void* operator new(size_t size) {
+        DEBUG_ASSERT(size == sizeof(T));
+        return GetPool().Allocate();
+    }
+
+    static void operator delete(void* object) {
+        GetPool().Free(object);
+    }
+
+    /// Returns the number of objects of type T currently allocated
+    static size_t GetNumAllocated() {
+        return GetPool().GetNumAllocated();
+    }
+
+private:
+    static Common::ObjectPool<T>& GetPool() {
+        // Never destroyed, as objects held by static variables can outlive it
+        static auto& pool = *new Common::ObjectPool<T>;
+        return pool;
+    }
+};
+
 /**
  * Attempts to downcast the given Object pointer to a pointer to T.
  * @return Derived pointer to the object, or `nullptr` if `object` isn't of type T.
@@ -64,6 +64,8 @@ void MemoryInit(u32 mem_type) {
     // We must've allocated the entire FCRAM by the end
     ASSERT(base == Memory::FCRAM_SIZE);
 
+    Memory::UpdatePhysicalPageTable();
+
     using ConfigMem::config_mem;
     config_mem.app_mem_type = mem_type;
     // app_mem_malloc does not always match the configured size for memory_region[0]: in case the
@@ -80,6 +82,8 @@ void MemoryShutdown() {
         region.used = 0;
         region.linear_heap_memory = nullptr;
     }
+
+    Memory::UpdatePhysicalPageTable();
 }
 
 MemoryRegionInfo* GetMemoryRegion(MemoryRegion region) {
@@ -13,7 +13,7 @@
 
 namespace Kernel {
 
-class Semaphore final : public WaitObject {
+class Semaphore final : public WaitObject, public PooledObject<Semaphore> {
 public:
     /**
      * Creates a semaphore.
@@ -34,7 +34,7 @@ class Thread;
  * After the server replies to the request, the response is marshalled back to the caller's
  * TLS buffer and control is transferred back to it.
  */
-class ServerSession final : public WaitObject {
+class ServerSession final : public WaitObject, public PooledObject<ServerSession> {
 public:
     std::string GetName() const override {
         return name;
@@ -1400,8 +1400,8 @@ MICROPROFILE_DEFINE(Kernel_SVC, "Kernel", "SVC", MP_RGB(70, 200, 70));
 void CallSVC(u32 immediate) {
     MICROPROFILE_SCOPE(Kernel_SVC);
 
-    // Lock the global kernel mutex when we enter the kernel HLE.
-    std::lock_guard<std::recursive_mutex> lock(HLE::g_hle_lock);
+    // Lock the kernel mutex when we enter the kernel HLE.
+    std::lock_guard<HLE::ProfiledMutex> lock(HLE::g_kernel_lock);
 
     ASSERT_MSG(g_current_process->status == ProcessStatus::Running,
                "Running threads from exiting processes is unimplemented");
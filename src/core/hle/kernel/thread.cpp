@@ -45,7 +45,8 @@ static Kernel::HandleTable wakeup_callback_handle_table;
 static std::vector<SharedPtr<Thread>> thread_list;
 
 // Lists only ready thread ids.
-static Common::ThreadQueueList<Thread*, THREADPRIO_LOWEST + 1> ready_queue;
+static Common::ThreadQueueList<Thread, THREADPRIO_LOWEST + 1, &Thread::ready_queue_hook>
+    ready_queue;
 
 static SharedPtr<Thread> current_thread;
 
@@ -345,7 +346,6 @@ ResultVal<SharedPtr<Thread>> Thread::Create(std::string name, VAddr entry_point,
     SharedPtr<Thread> thread(new Thread);
 
     thread_list.push_back(thread);
-    ready_queue.prepare(priority);
 
     thread->thread_id = NewThreadId();
     thread->status = THREADSTATUS_DORMANT;
@@ -421,8 +421,6 @@ void Thread::SetPriority(u32 priority) {
     // If thread was ready, adjust queues
     if (status == THREADSTATUS_READY)
         ready_queue.move(this, current_priority, priority);
-    else
-        ready_queue.prepare(priority);
 
     nominal_priority = current_priority = priority;
 }
@@ -440,8 +438,6 @@ void Thread::BoostPriority(u32 priority) {
     // If thread was ready, adjust queues
     if (status == THREADSTATUS_READY)
         ready_queue.move(this, current_priority, priority);
-    else
-        ready_queue.prepare(priority);
     current_priority = priority;
 }
 
@@ -514,8 +510,8 @@ void ThreadingShutdown() {
     for (auto& t : thread_list) {
         t->Stop();
     }
-    thread_list.clear();
     ready_queue.clear();
+    thread_list.clear();
     ClearProcessList();
 }
 
@@ -10,6 +10,7 @@
 #include <boost/container/flat_map.hpp>
 #include <boost/container/flat_set.hpp>
 #include "common/common_types.h"
+#include "common/thread_queue_list.h"
 #include "core/arm/arm_interface.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/wait_object.h"
@@ -53,7 +54,7 @@ namespace Kernel {
 class Mutex;
 class Process;
 
-class Thread final : public WaitObject {
+class Thread final : public WaitObject, public PooledObject<Thread> {
 public:
     /**
      * Creates and returns a new thread. The new thread is immediately scheduled
@@ -194,6 +195,9 @@ public:
 
     u64 last_running_ticks; ///< CPU tick when thread was last running
 
+    /// Links of the thread in the ready queue, valid while the thread is ready
+    Common::ThreadQueueListHook<Thread> ready_queue_hook;
+
     s32 processor_id;
 
     VAddr tls_address; ///< Virtual address of the Thread Local Storage of the thread
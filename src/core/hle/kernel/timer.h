@@ -10,7 +10,7 @@
 
 namespace Kernel {
 
-class Timer final : public WaitObject {
+class Timer final : public WaitObject, public PooledObject<Timer> {
 public:
     /**
      * Creates a timer
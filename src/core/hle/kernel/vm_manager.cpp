@@ -59,6 +59,7 @@ void VMManager::Reset() {
     page_table.pointers.fill(nullptr);
     page_table.attributes.fill(Memory::PageType::Unmapped);
     page_table.cached_res_count.fill(0);
+    page_table.special_regions.clear();
 
     UpdatePageTableForVMA(initial_vma);
 }
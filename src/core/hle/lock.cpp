@@ -2,8 +2,25 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include <core/hle/lock.h>
+#include "common/microprofile.h"
+#include "core/hle/lock.h"
 
 namespace HLE {
-std::recursive_mutex g_hle_lock;
+
+MICROPROFILE_DEFINE(HLE_KernelLockWait, "HLE", "Kernel lock wait", MP_RGB(255, 100, 100));
+MICROPROFILE_DEFINE(HLE_MMIOLockWait, "HLE", "MMIO lock wait", MP_RGB(255, 160, 100));
+
+static void WaitForKernelLock(std::recursive_mutex& mutex) {
+    MICROPROFILE_SCOPE(HLE_KernelLockWait);
+    mutex.lock();
+}
+
+static void WaitForMMIOLock(std::recursive_mutex& mutex) {
+    MICROPROFILE_SCOPE(HLE_MMIOLockWait);
+    mutex.lock();
+}
+
+ProfiledMutex g_kernel_lock(WaitForKernelLock);
+ProfiledMutex g_mmio_lock(WaitForMMIOLock);
+
 } // namespace HLE
@@ -7,12 +7,62 @@
 #include <mutex>
 
 namespace HLE {
+
+/**
+ * Recursive mutex which reports the time spent waiting for it in MicroProfile. An uncontended
+ * lock costs the same as a plain std::recursive_mutex, only waits are profiled.
+ */
+class ProfiledMutex {
+public:
+    using WaitFunction = void (*)(std::recursive_mutex& mutex);
+
+    /// @param wait Locks the mutex when it is held by another thread, within a MicroProfile scope
+    explicit ProfiledMutex(WaitFunction wait) : wait(wait) {}
+
+    void lock() {
+        if (!mutex.try_lock()) {
+            wait(mutex);
+        }
+    }
+
+    bool try_lock() {
+        return mutex.try_lock();
+    }
+
+    void unlock() {
+        mutex.unlock();
+    }
+
+private:
+    std::recursive_mutex mutex;
+    WaitFunction wait;
+};
+
 /*
- * Synchronizes access to the internal HLE kernel structures, it is acquired when a guest
- * application thread performs a syscall. It should be acquired by any host threads that read or
- * modify the HLE kernel state. Note: Any operation that directly or indirectly reads from or writes
- * to the emulated memory is not protected by this mutex, and should be avoided in any threads other
- * than the CPU thread.
+ * The HLE state is split between the following locks. When several of them are needed, they must
+ * be acquired in this order, and released in the reverse order:
+ *
+ *  1. g_kernel_lock
+ *  2. The lock of a service's own state shared with host threads (e.g. the connection status of
+ *     NWM::UDS, which is updated by the network thread)
+ *  3. g_mmio_lock
+ *
+ * Note: Any operation that directly or indirectly reads from or writes to the emulated memory is
+ * not protected by these locks, and should be avoided in any threads other than the CPU thread.
  */
-extern std::recursive_mutex g_hle_lock;
+
+/*
+ * Synchronizes access to the HLE kernel structures: the object tables, the thread scheduler and
+ * the service sessions. It is acquired when a guest application thread performs a syscall, and
+ * should be acquired by any host threads that read or modify kernel objects, like signaling an
+ * event.
+ */
+extern ProfiledMutex g_kernel_lock;
+
+/*
+ * Synchronizes the accesses to MMIO regions and to the memory cached by the rasterizer made
+ * through Memory::Read and Memory::Write.
+ */
+extern ProfiledMutex g_mmio_lock;
+
 } // namespace HLE
@@ -5,6 +5,7 @@
 #include <vector>
 #include "common/common_types.h"
 #include "common/logging/log.h"
+#include "common/span.h"
 #include "core/hle/ipc.h"
 #include "core/hle/ipc_helpers.h"
 #include "core/hle/kernel/event.h"
@@ -102,7 +103,7 @@ void Module::Interface::GetWifiStatus(Kernel::HLERequestContext& ctx) {
 
 void Module::Interface::GetInfraPriority(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x27, 0, 2);
-    const std::vector<u8>& ac_config = rp.PopStaticBuffer();
+    rp.PopStaticBuffer(); // ACConfig, unused
 
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 0);
     rb.Push(RESULT_SUCCESS);
@@ -117,13 +118,13 @@ void Module::Interface::SetRequestEulaVersion(Kernel::HLERequestContext& ctx) {
     u32 major = rp.Pop<u8>();
     u32 minor = rp.Pop<u8>();
 
-    const std::vector<u8>& ac_config = rp.PopStaticBuffer();
+    Common::Span<const u8> ac_config = rp.PopStaticBuffer();
 
     // TODO(Subv): Copy over the input ACConfig to the stored ACConfig.
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
     rb.Push(RESULT_SUCCESS);
-    rb.PushStaticBuffer(std::move(ac_config), 0);
+    rb.PushStaticBuffer(ac_config.ToVector(), 0);
 
     LOG_WARNING(Service_AC, "(STUBBED) called, major=%u, minor=%u", major, minor);
 }
@@ -7,6 +7,7 @@
 #include <cinttypes>
 #include <cstddef>
 #include <cstring>
+#include <mutex>
 #include "common/file_util.h"
 #include "common/logging/log.h"
 #include "common/string_util.h"
@@ -977,6 +978,7 @@ void GetProgramInfoFromCia(Service::Interface* self) {
     }
 
     auto file = file_res.Unwrap();
+    std::lock_guard<std::mutex> lock(file->backend_mutex);
     FileSys::CIAContainer container;
     if (container.Load(*file->backend) != Loader::ResultStatus::Success) {
         IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
@@ -1019,6 +1021,7 @@ void GetSystemMenuDataFromCia(Service::Interface* self) {
     output_buffer_size = std::min(output_buffer_size, sizeof(Loader::SMDH));
 
     auto file = file_res.Unwrap();
+    std::lock_guard<std::mutex> lock(file->backend_mutex);
     FileSys::CIAContainer container;
     if (container.Load(*file->backend) != Loader::ResultStatus::Success) {
         IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
@@ -1062,6 +1065,7 @@ void GetDependencyListFromCia(Service::Interface* self) {
     output_buffer_size = std::min(output_buffer_size, FileSys::CIA_DEPENDENCY_SIZE);
 
     auto file = file_res.Unwrap();
+    std::lock_guard<std::mutex> lock(file->backend_mutex);
     FileSys::CIAContainer container;
     if (container.Load(*file->backend) != Loader::ResultStatus::Success) {
         IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
@@ -1089,6 +1093,7 @@ void GetTransferSizeFromCia(Service::Interface* self) {
     }
 
     auto file = file_res.Unwrap();
+    std::lock_guard<std::mutex> lock(file->backend_mutex);
     FileSys::CIAContainer container;
     if (container.Load(*file->backend) != Loader::ResultStatus::Success) {
         IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
@@ -1114,6 +1119,7 @@ void GetCoreVersionFromCia(Service::Interface* self) {
     }
 
     auto file = file_res.Unwrap();
+    std::lock_guard<std::mutex> lock(file->backend_mutex);
     FileSys::CIAContainer container;
     if (container.Load(*file->backend) != Loader::ResultStatus::Success) {
         IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
@@ -1140,6 +1146,7 @@ void GetRequiredSizeFromCia(Service::Interface* self) {
     }
 
     auto file = file_res.Unwrap();
+    std::lock_guard<std::mutex> lock(file->backend_mutex);
     FileSys::CIAContainer container;
     if (container.Load(*file->backend) != Loader::ResultStatus::Success) {
         IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
@@ -1168,6 +1175,7 @@ void GetMetaSizeFromCia(Service::Interface* self) {
     }
 
     auto file = file_res.Unwrap();
+    std::lock_guard<std::mutex> lock(file->backend_mutex);
     FileSys::CIAContainer container;
     if (container.Load(*file->backend) != Loader::ResultStatus::Success) {
 
@@ -1202,6 +1210,7 @@ void GetMetaDataFromCia(Service::Interface* self) {
     output_size = std::min(static_cast<u32>(output_buffer_size), output_size);
 
     auto file = file_res.Unwrap();
+    std::lock_guard<std::mutex> lock(file->backend_mutex);
     FileSys::CIAContainer container;
     if (container.Load(*file->backend) != Loader::ResultStatus::Success) {
         IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
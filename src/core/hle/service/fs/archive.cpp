@@ -102,25 +102,36 @@ void File::Read(Kernel::HLERequestContext& ctx) {
     // This file session might have a specific offset from where to start reading, apply it.
     offset += file->offset;
 
-    if (offset + length > backend->GetSize()) {
+    const u64 file_size = GetBackendSize();
+    if (offset + length > file_size) {
         LOG_ERROR(Service_FS, "Reading from out of bounds offset=0x%" PRIx64
                               " length=0x%08X file_size=0x%" PRIx64,
-                  offset, length, backend->GetSize());
+                  offset, length, file_size);
     }
 
-    IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
-
-    std::vector<u8> data(length);
-    ResultVal<size_t> read = backend->Read(offset, data.size(), data.data());
-    if (read.Failed()) {
-        rb.Push(read.Code());
-        rb.Push<u32>(0);
-    } else {
-        buffer.Write(data.data(), 0, *read);
-        rb.Push(RESULT_SUCCESS);
-        rb.Push<u32>(*read);
-    }
-    rb.PushMappedBuffer(buffer);
+    // The host file is read on a worker thread, and the data copied to the buffer once it is done
+    auto self = std::static_pointer_cast<File>(shared_from_this());
+    auto data = std::make_shared<std::vector<u8>>(length);
+    auto read = std::make_shared<ResultVal<size_t>>(RESULT_SUCCESS);
+    const u32 buffer_id = buffer.GetId();
+    Service::RunAsync(ctx, "FS File Read",
+                      [self, data, read, offset] {
+                          std::lock_guard<std::mutex> lock(self->backend_mutex);
+                          *read = self->backend->Read(offset, data->size(), data->data());
+                      },
+                      [data, read, buffer_id](Kernel::HLERequestContext& ctx) {
+                          auto& buffer = ctx.GetMappedBuffer(buffer_id);
+                          IPC::RequestBuilder rb(ctx, 0x0802, 2, 2);
+                          if (read->Failed()) {
+                              rb.Push(read->Code());
+                              rb.Push<u32>(0);
+                          } else {
+                              buffer.Write(data->data(), 0, **read);
+                              rb.Push(RESULT_SUCCESS);
+                              rb.Push<u32>(**read);
+                          }
+                          rb.PushMappedBuffer(buffer);
+                      });
 }
 
 void File::Write(Kernel::HLERequestContext& ctx) {
@@ -132,29 +143,41 @@ void File::Write(Kernel::HLERequestContext& ctx) {
     LOG_TRACE(Service_FS, "Write %s: offset=0x%" PRIx64 " length=%d, flush=0x%x", GetName().c_str(),
               offset, length, flush);
 
-    IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
-
     const FileSessionSlot* file = GetSessionData(ctx.Session());
 
     // Subfiles can not be written to
     if (file->subfile) {
+        IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
         rb.Push(FileSys::ERROR_UNSUPPORTED_OPEN_FLAGS);
         rb.Push<u32>(0);
         rb.PushMappedBuffer(buffer);
         return;
     }
 
-    std::vector<u8> data(length);
-    buffer.Read(data.data(), 0, data.size());
-    ResultVal<size_t> written = backend->Write(offset, data.size(), flush != 0, data.data());
-    if (written.Failed()) {
-        rb.Push(written.Code());
-        rb.Push<u32>(0);
-    } else {
-        rb.Push(RESULT_SUCCESS);
-        rb.Push<u32>(*written);
-    }
-    rb.PushMappedBuffer(buffer);
+    // The data is copied from the buffer right away, and written to the host file on a worker
+    // thread. This is also where CIAs are installed, through AM's CIAFile backend.
+    auto self = std::static_pointer_cast<File>(shared_from_this());
+    auto data = std::make_shared<std::vector<u8>>(length);
+    auto written = std::make_shared<ResultVal<size_t>>(RESULT_SUCCESS);
+    buffer.Read(data->data(), 0, data->size());
+    const u32 buffer_id = buffer.GetId();
+    Service::RunAsync(
+        ctx, "FS File Write",
+        [self, data, written, offset, flush] {
+            std::lock_guard<std::mutex> lock(self->backend_mutex);
+            *written = self->backend->Write(offset, data->size(), flush != 0, data->data());
+        },
+        [written, buffer_id](Kernel::HLERequestContext& ctx) {
+            IPC::RequestBuilder rb(ctx, 0x0803, 2, 2);
+            if (written->Failed()) {
+                rb.Push(written->Code());
+                rb.Push<u32>(0);
+            } else {
+                rb.Push(RESULT_SUCCESS);
+                rb.Push<u32>(**written);
+            }
+            rb.PushMappedBuffer(ctx.GetMappedBuffer(buffer_id));
+        });
 }
 
 void File::GetSize(Kernel::HLERequestContext& ctx) {
@@ -182,6 +205,7 @@ void File::SetSize(Kernel::HLERequestContext& ctx) {
     }
 
     file->size = size;
+    std::lock_guard<std::mutex> lock(backend_mutex);
     backend->SetSize(size);
     rb.Push(RESULT_SUCCESS);
 }
@@ -194,6 +218,7 @@ void File::Close(Kernel::HLERequestContext& ctx) {
         LOG_WARNING(Service_FS, "Closing File backend but %zu clients still connected",
                     connected_sessions.size());
 
+    std::lock_guard<std::mutex> lock(backend_mutex);
     backend->Close();
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(RESULT_SUCCESS);
@@ -212,6 +237,7 @@ void File::Flush(Kernel::HLERequestContext& ctx) {
         return;
     }
 
+    std::lock_guard<std::mutex> lock(backend_mutex);
     backend->Flush();
     rb.Push(RESULT_SUCCESS);
 }
@@ -251,7 +277,7 @@ void File::OpenLinkFile(Kernel::HLERequestContext& ctx) {
 
     slot->priority = original_file->priority;
     slot->offset = 0;
-    slot->size = backend->GetSize();
+    slot->size = GetBackendSize();
     slot->subfile = false;
 
     rb.Push(RESULT_SUCCESS);
@@ -304,6 +330,11 @@ void File::OpenSubFile(Kernel::HLERequestContext& ctx) {
     rb.PushMoveObjects(std::get<SharedPtr<ClientSession>>(sessions));
 }
 
+u64 File::GetBackendSize() {
+    std::lock_guard<std::mutex> lock(backend_mutex);
+    return backend->GetSize();
+}
+
 Kernel::SharedPtr<Kernel::ClientSession> File::Connect() {
     auto sessions = Kernel::ServerSession::CreateSessionPair(GetName());
     auto server = std::get<Kernel::SharedPtr<Kernel::ServerSession>>(sessions);
@@ -312,7 +343,7 @@ Kernel::SharedPtr<Kernel::ClientSession> File::Connect() {
     FileSessionSlot* slot = GetSessionData(server);
     slot->priority = 0;
     slot->offset = 0;
-    slot->size = backend->GetSize();
+    slot->size = GetBackendSize();
     slot->subfile = false;
 
     return std::get<Kernel::SharedPtr<Kernel::ClientSession>>(sessions);
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include "common/common_types.h"
@@ -71,10 +72,15 @@ public:
     FileSys::Path path;                            ///< Path of the file
     std::unique_ptr<FileSys::FileBackend> backend; ///< File backend interface
 
+    /// Must be held to access the backend, which async requests use from worker threads
+    std::mutex backend_mutex;
+
     /// Creates a new session to this File and returns the ClientSession part of the connection.
     Kernel::SharedPtr<Kernel::ClientSession> Connect();
 
 private:
+    u64 GetBackendSize();
+
     void Read(Kernel::HLERequestContext& ctx);
     void Write(Kernel::HLERequestContext& ctx);
     void GetSize(Kernel::HLERequestContext& ctx);
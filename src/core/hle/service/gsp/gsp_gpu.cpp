@@ -5,6 +5,7 @@
 #include <vector>
 #include "common/bit_field.h"
 #include "common/microprofile.h"
+#include "common/span.h"
 #include "common/swap.h"
 #include "core/core.h"
 #include "core/hle/ipc.h"
@@ -91,10 +92,10 @@ static void WriteSingleHWReg(u32 base_address, u32 data) {
  *
  * @param base_address The address of the first register in the sequence
  * @param size_in_bytes The number of registers to update (size of data)
- * @param data A vector containing the source data
+ * @param data The source data
  * @return RESULT_SUCCESS if the parameters are valid, error code otherwise
  */
-static ResultCode WriteHWRegs(u32 base_address, u32 size_in_bytes, const std::vector<u8>& data) {
+static ResultCode WriteHWRegs(u32 base_address, u32 size_in_bytes, Common::Span<const u8> data) {
     // This magic number is verified to be done by the gsp module
     const u32 max_size_in_bytes = 0x80;
 
@@ -133,12 +134,12 @@ static ResultCode WriteHWRegs(u32 base_address, u32 size_in_bytes, const std::ve
  *
  * @param base_address  The address of the first register in the sequence
  * @param size_in_bytes The number of registers to update (size of data)
- * @param data    A vector containing the data to write
- * @param masks   A vector containing the masks
+ * @param data    The data to write
+ * @param masks   The masks
  * @return RESULT_SUCCESS if the parameters are valid, error code otherwise
  */
 static ResultCode WriteHWRegsWithMask(u32 base_address, u32 size_in_bytes,
-                                      const std::vector<u8>& data, const std::vector<u8>& masks) {
+                                      Common::Span<const u8> data, Common::Span<const u8> masks) {
     // This magic number is verified to be done by the gsp module
     const u32 max_size_in_bytes = 0x80;
 
@@ -185,7 +186,7 @@ void GSP_GPU::WriteHWRegs(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x1, 2, 2);
     u32 reg_addr = rp.Pop<u32>();
     u32 size = rp.Pop<u32>();
-    std::vector<u8> src_data = rp.PopStaticBuffer();
+    Common::Span<const u8> src_data = rp.PopStaticBuffer();
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(GSP::WriteHWRegs(reg_addr, size, src_data));
@@ -196,8 +197,8 @@ void GSP_GPU::WriteHWRegsWithMask(Kernel::HLERequestContext& ctx) {
     u32 reg_addr = rp.Pop<u32>();
     u32 size = rp.Pop<u32>();
 
-    std::vector<u8> src_data = rp.PopStaticBuffer();
-    std::vector<u8> mask_data = rp.PopStaticBuffer();
+    Common::Span<const u8> src_data = rp.PopStaticBuffer();
+    Common::Span<const u8> mask_data = rp.PopStaticBuffer();
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(GSP::WriteHWRegsWithMask(reg_addr, size, src_data, mask_data));
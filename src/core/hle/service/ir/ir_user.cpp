@@ -347,7 +347,7 @@ void IR_USER::FinalizeIrNop(Kernel::HLERequestContext& ctx) {
 void IR_USER::SendIrNop(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x0D, 1, 2);
     const u32 size = rp.Pop<u32>();
-    std::vector<u8> buffer = rp.PopStaticBuffer();
+    std::vector<u8> buffer = rp.PopStaticBuffer().ToVector();
     ASSERT(size == buffer.size());
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
@@ -180,9 +180,8 @@ void HandleAssociationResponseFrame(const Network::WifiPacket& packet) {
 }
 
 static void HandleEAPoLPacket(const Network::WifiPacket& packet) {
-    std::unique_lock<std::recursive_mutex> hle_lock(HLE::g_hle_lock, std::defer_lock);
-    std::unique_lock<std::mutex> lock(connection_status_mutex, std::defer_lock);
-    std::lock(hle_lock, lock);
+    std::lock_guard<HLE::ProfiledMutex> kernel_lock(HLE::g_kernel_lock);
+    std::lock_guard<std::mutex> lock(connection_status_mutex);
 
     if (GetEAPoLFrameType(packet.data) == EAPoLStartMagic) {
         if (connection_status.status != static_cast<u32>(NetworkStatus::ConnectedAsHost)) {
@@ -265,9 +264,8 @@ static void HandleEAPoLPacket(const Network::WifiPacket& packet) {
 
 static void HandleSecureDataPacket(const Network::WifiPacket& packet) {
     auto secure_data = ParseSecureDataHeader(packet.data);
-    std::unique_lock<std::recursive_mutex> hle_lock(HLE::g_hle_lock, std::defer_lock);
-    std::unique_lock<std::mutex> lock(connection_status_mutex, std::defer_lock);
-    std::lock(hle_lock, lock);
+    std::lock_guard<HLE::ProfiledMutex> kernel_lock(HLE::g_kernel_lock);
+    std::lock_guard<std::mutex> lock(connection_status_mutex);
 
     if (secure_data.src_node_id == connection_status.network_node_id) {
         // Ignore packets that came from ourselves.
@@ -312,7 +310,7 @@ static void HandleSecureDataPacket(const Network::WifiPacket& packet) {
     // Add the received packet to the data queue.
     channel_info->second.received_packets.emplace_back(packet.data);
 
-    // Signal the data event. We can do this directly because we locked g_hle_lock
+    // Signal the data event. We can do this directly because we locked g_kernel_lock
     channel_info->second.event->Signal();
 }
 
@@ -3,16 +3,21 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <memory>
 #include <fmt/format.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "common/string_util.h"
+#include "common/thread_pool.h"
+#include "core/core_timing.h"
 #include "core/hle/ipc.h"
 #include "core/hle/kernel/client_port.h"
 #include "core/hle/kernel/event.h"
+#include "core/hle/kernel/handle_table.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/server_port.h"
 #include "core/hle/kernel/server_session.h"
+#include "core/hle/kernel/thread.h"
 #include "core/hle/service/ac/ac.h"
 #include "core/hle/service/act/act.h"
 #include "core/hle/service/am/am.h"
@@ -51,6 +56,8 @@
 #include "core/hle/service/soc_u.h"
 #include "core/hle/service/ssl_c.h"
 #include "core/hle/service/y2r_u.h"
+#include "core/memory.h"
+#include "core/settings.h"
 
 using Kernel::ClientPort;
 using Kernel::ServerPort;
@@ -61,6 +68,18 @@ namespace Service {
 
 std::unordered_map<std::string, SharedPtr<ClientPort>> g_kernel_named_ports;
 
+/// Number of worker threads running the host work of async requests, by AsyncWorkers kind
+constexpr size_t NUM_ASYNC_WORKERS = 2;
+constexpr size_t NUM_BLOCKING_ASYNC_WORKERS = 4;
+
+static std::unique_ptr<Common::ThreadPool> async_workers;
+static std::unique_ptr<Common::ThreadPool> blocking_async_workers;
+/// Event signaling the completion of the work of an async request, from a worker thread
+static CoreTiming::EventType* async_request_completed_event;
+/// Threads waiting for their async request to complete, by request id. Only used by the CPU thread.
+static std::unordered_map<u64, ThreadContinuationToken> async_requests;
+static u64 next_async_request_id;
+
 /**
  * Creates a function string for logging, complete with the name (or header code, depending
  * on what's passed in) the port name, and all the cmd_buff arguments.
@@ -182,6 +201,8 @@ void ServiceFrameworkBase::HandleSyncRequest(SharedPtr<ServerSession> server_ses
     LOG_TRACE(Service, "%s",
               MakeFunctionString(info->name, GetServiceName().c_str(), cmd_buf).c_str());
     handler_invoker(this, info->handler_callback, context);
+    if (context.IsReplyDeferred())
+        return;
     context.WriteToOutgoingCommandBuffer(cmd_buf, *Kernel::g_current_process,
                                          Kernel::g_handle_table);
 }
@@ -253,8 +274,76 @@ void ContinueClientThread(ThreadContinuationToken& token) {
     token.callback = nullptr;
 }
 
+static void AsyncRequestCompleted(u64 request_id, int cycles_late) {
+    auto itr = async_requests.find(request_id);
+    ASSERT(itr != async_requests.end());
+    ThreadContinuationToken token = std::move(itr->second);
+    async_requests.erase(itr);
+
+    // The thread may have been terminated while the work was running
+    if (token.GetThread()->status != THREADSTATUS_WAIT_HLE_EVENT)
+        return;
+    ContinueClientThread(token);
+}
+
+void RunAsync(const std::string& reason, std::function<void()> work,
+              ThreadContinuationToken::Callback callback, AsyncWorkers workers) {
+    if (!Settings::values.use_async_service_requests) {
+        work();
+        callback(Kernel::GetCurrentThread());
+        return;
+    }
+
+    const u64 request_id = next_async_request_id++;
+    async_requests.emplace(request_id, SleepClientThread(reason, std::move(callback)));
+    Common::ThreadPool& pool =
+        workers == AsyncWorkers::Blocking ? *blocking_async_workers : *async_workers;
+    pool.Submit([ work = std::move(work), request_id ] {
+        work();
+        CoreTiming::ScheduleEventThreadsafe(0, async_request_completed_event, request_id);
+    });
+}
+
+void RunAsync(Kernel::HLERequestContext& ctx, const std::string& reason,
+              std::function<void()> work,
+              std::function<void(Kernel::HLERequestContext& ctx)> callback) {
+    if (!Settings::values.use_async_service_requests) {
+        work();
+        callback(ctx);
+        return;
+    }
+
+    // The handler returns before the reply is written, so it is written to a copy of the context
+    ctx.DeferReply();
+    auto context = std::make_shared<Kernel::HLERequestContext>(ctx);
+    RunAsync(reason, std::move(work),
+             [ context, callback = std::move(callback) ](SharedPtr<Kernel::Thread> thread) {
+                 callback(*context);
+                 WriteDeferredReply(*context, *thread);
+             });
+}
+
+void WriteDeferredReply(const Kernel::HLERequestContext& ctx, Kernel::Thread& thread) {
+    // The command buffer and the static buffer descriptors following it are in the TLS of the
+    // thread, which is regular memory
+    constexpr size_t size =
+        (IPC::COMMAND_BUFFER_LENGTH + 2 * IPC::MAX_STATIC_BUFFERS) * sizeof(u32);
+    u8* cmd_buf =
+        Memory::GetContiguousPointer(*thread.owner_process, thread.GetCommandBufferAddress(), size);
+    ASSERT(cmd_buf != nullptr);
+    ctx.WriteToOutgoingCommandBuffer(reinterpret_cast<u32_le*>(cmd_buf), *thread.owner_process,
+                                     Kernel::g_handle_table);
+}
+
 /// Initialize ServiceManager
 void Init() {
+    async_workers = std::make_unique<Common::ThreadPool>(NUM_ASYNC_WORKERS, "HLE async worker");
+    blocking_async_workers = std::make_unique<Common::ThreadPool>(NUM_BLOCKING_ASYNC_WORKERS,
+                                                                  "HLE blocking async worker");
+    async_request_completed_event =
+        CoreTiming::RegisterEvent("AsyncRequestCompleted", AsyncRequestCompleted);
+    next_async_request_id = 0;
+
     SM::g_service_manager = std::make_shared<SM::ServiceManager>();
     SM::ServiceManager::InstallInterfaces(SM::g_service_manager);
 
@@ -302,6 +391,13 @@ void Init() {
 
 /// Shutdown ServiceManager
 void Shutdown() {
+    // Let the running async requests finish, the threads waiting for them are not resumed. The
+    // blocking ones could wait forever, so the sockets they wait on are shut down first.
+    SOC::InterruptBlockingCalls();
+    blocking_async_workers.reset();
+    async_workers.reset();
+    async_requests.clear();
+
     PTM::Shutdown();
     NFC::Shutdown();
     NIM::Shutdown();
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <boost/container/flat_map.hpp>
@@ -21,6 +22,7 @@ class ClientPort;
 class ServerPort;
 class ServerSession;
 class Event;
+class Thread;
 } // namespace Kernel
 
 namespace Service {
@@ -277,6 +279,11 @@ public:
 
     bool IsValid();
 
+    /// Returns the thread paused by this token.
+    const Kernel::SharedPtr<Kernel::Thread>& GetThread() const {
+        return thread;
+    }
+
 private:
     Kernel::SharedPtr<Kernel::Event> event;
     Kernel::SharedPtr<Kernel::Thread> thread;
@@ -301,6 +308,45 @@ ThreadContinuationToken SleepClientThread(const std::string& reason,
  */
 void ContinueClientThread(ThreadContinuationToken& token);
 
+/// Worker threads running the host work of an async request
+enum class AsyncWorkers {
+    /// Work which completes on its own, like file I/O
+    Default,
+    /// Work which may wait indefinitely, like receiving from a socket. It runs on separate workers
+    /// so that it can't hold up the other requests.
+    Blocking,
+};
+
+/**
+ * Runs the blocking host work of a request, like file or socket I/O, on a worker thread instead of
+ * stalling the emulated CPU. The requesting guest thread is put to sleep, as it would be while a
+ * real service processes the request, and once the work is done the callback is invoked on the CPU
+ * thread to write the reply as the guest thread resumes. When async requests are disabled, the work
+ * and the callback run right away.
+ * The work must not access the HLE kernel state nor the emulated memory.
+ * @param reason Reason for pausing the thread, to be used for debugging purposes.
+ * @param work Host work of the request.
+ * @param callback Callback invoked with the requesting thread once the work is done.
+ * @param workers Worker threads to run the work on.
+ */
+void RunAsync(const std::string& reason, std::function<void()> work,
+              ThreadContinuationToken::Callback callback,
+              AsyncWorkers workers = AsyncWorkers::Default);
+
+/**
+ * Same as above for ServiceFramework handlers: the callback writes the reply into a copy of the
+ * request context, which is then sent to the requesting thread.
+ */
+void RunAsync(Kernel::HLERequestContext& ctx, const std::string& reason,
+              std::function<void()> work,
+              std::function<void(Kernel::HLERequestContext& ctx)> callback);
+
+/**
+ * Writes the reply of a request deferred by RunAsync to the command buffer of the requesting
+ * thread, as the kernel does when a handler returns.
+ */
+void WriteDeferredReply(const Kernel::HLERequestContext& ctx, Kernel::Thread& thread);
+
 /// Initialize ServiceManager
 void Init();
 
@@ -3,7 +3,9 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <cstring>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 #include "common/assert.h"
@@ -12,7 +14,9 @@
 #include "common/logging/log.h"
 #include "common/scope_exit.h"
 #include "core/hle/ipc.h"
+#include "core/hle/kernel/process.h"
 #include "core/hle/kernel/server_session.h"
+#include "core/hle/kernel/thread.h"
 #include "core/hle/result.h"
 #include "core/hle/service/soc_u.h"
 #include "core/memory.h"
@@ -590,9 +594,9 @@ static void SendTo(Interface* self) {
 }
 
 static void RecvFrom(Interface* self) {
-    // TODO(Subv): Calling this function on a blocking socket will block the emu thread,
-    // preventing graceful shutdown when closing the emulator, this can be fixed by always
-    // performing nonblocking operations and spinlock until the data is available
+    // TODO(Subv): With async requests disabled, calling this function on a blocking socket blocks
+    // the emu thread, preventing graceful shutdown when closing the emulator. This can be fixed by
+    // always performing nonblocking operations and spinlock until the data is available
     u32* cmd_buffer = Kernel::GetCommandBuffer();
     u32 socket_handle = cmd_buffer[1];
     u32 len = cmd_buffer[2];
@@ -617,32 +621,55 @@ static void RecvFrom(Interface* self) {
         return;
     }
 
-    std::vector<u8> output_buff(len);
-    sockaddr src_addr;
-    socklen_t src_addr_len = sizeof(src_addr);
-    int ret = ::recvfrom(socket_handle, reinterpret_cast<char*>(output_buff.data()), len, flags,
-                         &src_addr, &src_addr_len);
-
-    if (ret >= 0 && buffer_parameters.output_src_address_buffer != 0 && src_addr_len > 0) {
-        CTRSockAddr ctr_src_addr = CTRSockAddr::FromPlatform(src_addr);
-        Memory::WriteBlock(buffer_parameters.output_src_address_buffer, &ctr_src_addr,
-                           sizeof(ctr_src_addr));
-    }
-
-    int result = 0;
-    int total_received = ret;
-    if (ret == SOCKET_ERROR_VALUE) {
-        ret = TranslateError(GET_ERRNO);
-        total_received = 0;
-    } else {
-        // Write only the data we received to avoid overwriting parts of the buffer with zeros
-        Memory::WriteBlock(buffer_parameters.output_buffer_addr, output_buff.data(),
-                           total_received);
-    }
-
-    cmd_buffer[1] = result;
-    cmd_buffer[2] = ret;
-    cmd_buffer[3] = total_received;
+    struct ReceivedData {
+        std::vector<u8> output_buff;
+        sockaddr src_addr;
+        socklen_t src_addr_len = sizeof(src_addr);
+        int ret;
+        int error;
+    };
+    auto received = std::make_shared<ReceivedData>();
+    received->output_buff.resize(len);
+
+    // The data is received on a worker thread, and copied to the guest buffers once it is done
+    Service::RunAsync(
+        "SOC RecvFrom",
+        [received, socket_handle, len, flags] {
+            received->ret = ::recvfrom(socket_handle,
+                                       reinterpret_cast<char*>(received->output_buff.data()), len,
+                                       flags, &received->src_addr, &received->src_addr_len);
+            // The error has to be read on the thread which made the call
+            received->error = received->ret == SOCKET_ERROR_VALUE ? GET_ERRNO : 0;
+        },
+        [received, buffer_parameters](Kernel::SharedPtr<Kernel::Thread> thread) {
+            // The requesting process isn't necessarily the current one by the time this runs
+            const Kernel::Process& process = *thread->owner_process;
+            int ret = received->ret;
+            if (ret >= 0 && buffer_parameters.output_src_address_buffer != 0 &&
+                received->src_addr_len > 0) {
+                CTRSockAddr ctr_src_addr = CTRSockAddr::FromPlatform(received->src_addr);
+                Memory::WriteBlock(process, buffer_parameters.output_src_address_buffer,
+                                   &ctr_src_addr, sizeof(ctr_src_addr));
+            }
+
+            int result = 0;
+            int total_received = ret;
+            if (ret == SOCKET_ERROR_VALUE) {
+                ret = TranslateError(received->error);
+                total_received = 0;
+            } else {
+                // Write only the data we received to avoid overwriting parts of the buffer with
+                // zeros
+                Memory::WriteBlock(process, buffer_parameters.output_buffer_addr,
+                                   received->output_buff.data(), total_received);
+            }
+
+            const std::array<u32, 3> reply{{static_cast<u32>(result), static_cast<u32>(ret),
+                                            static_cast<u32>(total_received)}};
+            Memory::WriteBlock(process, thread->GetCommandBufferAddress() + 1 * sizeof(u32),
+                               reply.data(), reply.size() * sizeof(u32));
+        },
+        Service::AsyncWorkers::Blocking);
 }
 
 static void Poll(Interface* self) {
@@ -894,6 +921,16 @@ const Interface::FunctionInfo FunctionTable[] = {
     {0x00230040, nullptr, "AddGlobalSocket"},
 };
 
+void InterruptBlockingCalls() {
+#ifdef _WIN32
+    // Shutting down a socket doesn't interrupt the calls waiting on it, closing it does
+    CleanupSockets();
+#else
+    for (const auto& sock : open_sockets)
+        ::shutdown(sock.second.socket_fd, SHUT_RDWR);
+#endif
+}
+
 SOC_U::SOC_U() {
     Register(FunctionTable);
 
@@ -20,5 +20,11 @@ public:
     }
 };
 
+/**
+ * Shuts down the open sockets, so that the blocking calls on them return. Called before the async
+ * request workers are joined.
+ */
+void InterruptBlockingCalls();
+
 } // namespace SOC
 } // namespace Service
@@ -5,6 +5,7 @@
 #include <cstring>
 #include <memory>
 #include <string>
+#include <vector>
 #include "common/common_types.h"
 #include "common/file_util.h"
 #include "common/logging/log.h"
@@ -102,6 +103,18 @@ enum ElfSectionFlags {
 #define PF_R 0x4
 #define PF_MASKPROC 0xF0000000
 
+// Special section indices
+#define SHN_UNDEF 0
+
+// Symbol types
+#define STT_NOTYPE 0
+#define STT_OBJECT 1
+#define STT_FUNC 2
+#define STT_SECTION 3
+#define STT_FILE 4
+
+#define ELF32_ST_TYPE(info) ((info)&0xF)
+
 typedef unsigned int Elf32_Addr;
 typedef unsigned short Elf32_Half;
 typedef unsigned int Elf32_Off;
@@ -209,6 +222,7 @@ public:
         return (u32)(header->e_flags);
     }
     SharedPtr<CodeSet> LoadInto(u32 vaddr);
+    void ReadSymbols(u32 vaddr, std::vector<Loader::Symbol>& symbols) const;
 
     int GetNumSegments() const {
         return (int)(header->e_phnum);
@@ -348,6 +362,36 @@ SharedPtr<CodeSet> ElfReader::LoadInto(u32 vaddr) {
     return codeset;
 }
 
+void ElfReader::ReadSymbols(u32 vaddr, std::vector<Loader::Symbol>& symbols) const {
+    // Executables that are not prerelocated are loaded at vaddr, see LoadInto
+    const u32 base_addr = header->e_type != ET_EXEC ? vaddr : 0;
+
+    for (int i = 0; i < header->e_shnum; ++i) {
+        const Elf32_Shdr& section = sections[i];
+        if (section.sh_type != SHT_SYMTAB || section.sh_link >= header->e_shnum)
+            continue;
+
+        const Elf32_Sym* symbol_table = reinterpret_cast<const Elf32_Sym*>(GetSectionDataPtr(i));
+        const char* string_table =
+            reinterpret_cast<const char*>(GetSectionDataPtr(section.sh_link));
+        if (symbol_table == nullptr || string_table == nullptr)
+            continue;
+
+        const u32 string_table_size = sections[section.sh_link].sh_size;
+        const u32 num_symbols = section.sh_size / sizeof(Elf32_Sym);
+        for (u32 j = 0; j < num_symbols; ++j) {
+            const Elf32_Sym& symbol = symbol_table[j];
+            if (ELF32_ST_TYPE(symbol.st_info) != STT_FUNC || symbol.st_shndx == SHN_UNDEF ||
+                symbol.st_name >= string_table_size)
+                continue;
+
+            // The lowest bit of the address of Thumb functions is set
+            symbols.push_back({base_addr + (symbol.st_value & ~1u), symbol.st_size,
+                               std::string(string_table + symbol.st_name)});
+        }
+    }
+}
+
 SectionID ElfReader::GetSectionByName(const char* name, int firstSection) const {
     for (int i = firstSection; i < header->e_shnum; i++) {
         const char* secname = GetSectionName(i);
@@ -408,4 +452,20 @@ ResultStatus AppLoader_ELF::Load(Kernel::SharedPtr<Kernel::Process>& process) {
     return ResultStatus::Success;
 }
 
+ResultStatus AppLoader_ELF::ReadSymbols(std::vector<Symbol>& symbols) {
+    if (!file.IsOpen())
+        return ResultStatus::Error;
+
+    file.Seek(0, SEEK_SET);
+
+    size_t size = file.GetSize();
+    std::unique_ptr<u8[]> buffer(new u8[size]);
+    if (file.ReadBytes(&buffer[0], size) != size)
+        return ResultStatus::Error;
+
+    ElfReader elf_reader(&buffer[0]);
+    elf_reader.ReadSymbols(Memory::PROCESS_IMAGE_VADDR, symbols);
+    return ResultStatus::Success;
+}
+
 } // namespace Loader
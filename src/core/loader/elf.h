@@ -32,6 +32,8 @@ public:
 
     ResultStatus Load(Kernel::SharedPtr<Kernel::Process>& process) override;
 
+    ResultStatus ReadSymbols(std::vector<Symbol>& symbols) override;
+
 private:
     std::string filename;
 };
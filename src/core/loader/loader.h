@@ -81,6 +81,13 @@ constexpr u32 MakeMagic(char a, char b, char c, char d) {
     return a | b << 8 | c << 16 | d << 24;
 }
 
+/// A function or object of an executable, used to symbolize guest addresses
+struct Symbol {
+    VAddr address; ///< Address of the symbol in the address space of the loaded process
+    u32 size;      ///< Size of the symbol in bytes, 0 if unknown
+    std::string name;
+};
+
 /// Interface for loading an application
 class AppLoader : NonCopyable {
 public:
@@ -191,6 +198,15 @@ public:
         return ResultStatus::ErrorNotImplemented;
     }
 
+    /**
+     * Get the function symbols of the application, if the file format has any
+     * @param symbols Reference to store the symbols into
+     * @return ResultStatus result of function
+     */
+    virtual ResultStatus ReadSymbols(std::vector<Symbol>& symbols) {
+        return ResultStatus::ErrorNotImplemented;
+    }
+
 protected:
     FileUtil::IOFile file;
     bool is_loaded = false;
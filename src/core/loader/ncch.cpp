@@ -8,9 +8,11 @@
 #include <cstring>
 #include <locale>
 #include <memory>
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/string_util.h"
 #include "common/swap.h"
+#include "core/arm/arm_interface.h"
 #include "core/core.h"
 #include "core/file_sys/archive_selfncch.h"
 #include "core/file_sys/ncch_container.h"
@@ -23,6 +25,7 @@
 #include "core/loader/ncch.h"
 #include "core/loader/smdh.h"
 #include "core/memory.h"
+#include "core/settings.h"
 #include "network/network.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -100,6 +103,17 @@ ResultStatus AppLoader_NCCH::LoadExec(Kernel::SharedPtr<Kernel::Process>& proces
         codeset->entrypoint = codeset->code.addr;
         codeset->memory = std::make_shared<std::vector<u8>>(std::move(code));
 
+        if (Settings::values.use_translation_disk_cache) {
+            // Blocks cached for other versions of the code are discarded
+            const std::vector<u8>& memory = *codeset->memory;
+            const size_t code_size =
+                std::min<size_t>(codeset->code.size, memory.size() - codeset->code.offset);
+            const u64 code_hash =
+                Common::ComputeHash64(memory.data() + codeset->code.offset, code_size);
+            Core::CPU().LoadTranslationCache(program_id, code_hash, codeset->code.addr,
+                                             codeset->code.size);
+        }
+
         process = Kernel::Process::Create(std::move(codeset));
 
         // Attach a resource limit to the process based on the resource limit category
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <cstring>
 #include "audio_core/audio_core.h"
@@ -16,6 +17,7 @@
 #include "core/hle/lock.h"
 #include "core/memory.h"
 #include "core/memory_setup.h"
+#include "video_core/gpu_thread.h"
 #include "video_core/renderer_base.h"
 #include "video_core/video_core.h"
 
@@ -44,6 +46,11 @@ static void MapPages(PageTable& page_table, u32 base, u32 size, u8* memory, Page
     RasterizerFlushVirtualRegion(base << PAGE_BITS, size * PAGE_SIZE,
                                  FlushMode::FlushAndInvalidate);
 
+    // Code translated from the previous contents of these pages is no longer valid
+    if (&page_table == current_page_table && Core::System::GetInstance().IsPoweredOn()) {
+        Core::CPU().InvalidateCacheRange(base << PAGE_BITS, size * PAGE_SIZE);
+    }
+
     u32 end = base + size;
     while (base != end) {
         ASSERT_MSG(base < PAGE_TABLE_NUM_ENTRIES, "out of range mapping at %08X", base);
@@ -69,7 +76,17 @@ void MapIoRegion(PageTable& page_table, VAddr base, u32 size, MMIORegionPointer
     ASSERT_MSG((base & PAGE_MASK) == 0, "non-page aligned base: %08X", base);
     MapPages(page_table, base / PAGE_SIZE, size / PAGE_SIZE, nullptr, PageType::Special);
 
-    page_table.special_regions.emplace_back(SpecialRegion{base, size, mmio_handler});
+    // A handler mapped several times is only stored once
+    auto& regions = page_table.special_regions;
+    auto region = std::find(regions.begin(), regions.end(), mmio_handler);
+    if (region == regions.end()) {
+        ASSERT_MSG(regions.size() <= UINT16_MAX, "Too many MMIO handlers");
+        region = regions.insert(regions.end(), std::move(mmio_handler));
+    }
+
+    const auto first_page = page_table.special_region_indices.begin() + base / PAGE_SIZE;
+    std::fill(first_page, first_page + size / PAGE_SIZE,
+              static_cast<u16>(region - regions.begin()));
 }
 
 void UnmapRegion(PageTable& page_table, VAddr base, u32 size) {
@@ -118,23 +135,20 @@ static u8* GetPointerFromVMA(VAddr vaddr) {
 /**
  * This function should only be called for virtual addreses with attribute `PageType::Special`.
  */
-static MMIORegionPointer GetMMIOHandler(const PageTable& page_table, VAddr vaddr) {
-    for (const auto& region : page_table.special_regions) {
-        if (vaddr >= region.base && vaddr < (region.base + region.size)) {
-            return region.handler;
-        }
-    }
-    ASSERT_MSG(false, "Mapped IO page without a handler @ %08X", vaddr);
-    return nullptr; // Should never happen
+static const MMIORegionPointer& GetMMIOHandler(const PageTable& page_table, VAddr vaddr) {
+    const u16 index = page_table.special_region_indices[vaddr >> PAGE_BITS];
+    ASSERT_MSG(index < page_table.special_regions.size(),
+               "Mapped IO page without a handler @ %08X", vaddr);
+    return page_table.special_regions[index];
 }
 
-static MMIORegionPointer GetMMIOHandler(VAddr vaddr) {
+static const MMIORegionPointer& GetMMIOHandler(VAddr vaddr) {
     const PageTable& page_table = Kernel::g_current_process->vm_manager.page_table;
     return GetMMIOHandler(page_table, vaddr);
 }
 
 template <typename T>
-T ReadMMIO(MMIORegionPointer mmio_handler, VAddr addr);
+T ReadMMIO(const MMIORegionPointer& mmio_handler, VAddr addr);
 
 template <typename T>
 T Read(const VAddr vaddr) {
@@ -146,9 +160,7 @@ T Read(const VAddr vaddr) {
         return value;
     }
 
-    // The memory access might do an MMIO or cached access, so we have to lock the HLE kernel state
-    std::lock_guard<std::recursive_mutex> lock(HLE::g_hle_lock);
-
+    // Only the MMIO and cached accesses below touch HLE state, so only they lock it
     PageType type = current_page_table->attributes[vaddr >> PAGE_BITS];
     switch (type) {
     case PageType::Unmapped:
@@ -158,15 +170,19 @@ T Read(const VAddr vaddr) {
         ASSERT_MSG(false, "Mapped memory page without a pointer @ %08X", vaddr);
         break;
     case PageType::RasterizerCachedMemory: {
+        std::lock_guard<HLE::ProfiledMutex> lock(HLE::g_mmio_lock);
         RasterizerFlushVirtualRegion(vaddr, sizeof(T), FlushMode::Flush);
 
         T value;
         std::memcpy(&value, GetPointerFromVMA(vaddr), sizeof(T));
         return value;
     }
-    case PageType::Special:
+    case PageType::Special: {
+        std::lock_guard<HLE::ProfiledMutex> lock(HLE::g_mmio_lock);
         return ReadMMIO<T>(GetMMIOHandler(vaddr), vaddr);
+    }
     case PageType::RasterizerCachedSpecial: {
+        std::lock_guard<HLE::ProfiledMutex> lock(HLE::g_mmio_lock);
         RasterizerFlushVirtualRegion(vaddr, sizeof(T), FlushMode::Flush);
         return ReadMMIO<T>(GetMMIOHandler(vaddr), vaddr);
     }
@@ -176,7 +192,7 @@ T Read(const VAddr vaddr) {
 }
 
 template <typename T>
-void WriteMMIO(MMIORegionPointer mmio_handler, VAddr addr, const T data);
+void WriteMMIO(const MMIORegionPointer& mmio_handler, VAddr addr, const T data);
 
 template <typename T>
 void Write(const VAddr vaddr, const T data) {
@@ -187,9 +203,7 @@ void Write(const VAddr vaddr, const T data) {
         return;
     }
 
-    // The memory access might do an MMIO or cached access, so we have to lock the HLE kernel state
-    std::lock_guard<std::recursive_mutex> lock(HLE::g_hle_lock);
-
+    // Only the MMIO and cached accesses below touch HLE state, so only they lock it
     PageType type = current_page_table->attributes[vaddr >> PAGE_BITS];
     switch (type) {
     case PageType::Unmapped:
@@ -200,14 +214,18 @@ void Write(const VAddr vaddr, const T data) {
         ASSERT_MSG(false, "Mapped memory page without a pointer @ %08X", vaddr);
         break;
     case PageType::RasterizerCachedMemory: {
+        std::lock_guard<HLE::ProfiledMutex> lock(HLE::g_mmio_lock);
         RasterizerFlushVirtualRegion(vaddr, sizeof(T), FlushMode::FlushAndInvalidate);
         std::memcpy(GetPointerFromVMA(vaddr), &data, sizeof(T));
         break;
     }
-    case PageType::Special:
+    case PageType::Special: {
+        std::lock_guard<HLE::ProfiledMutex> lock(HLE::g_mmio_lock);
         WriteMMIO<T>(GetMMIOHandler(vaddr), vaddr, data);
         break;
+    }
     case PageType::RasterizerCachedSpecial: {
+        std::lock_guard<HLE::ProfiledMutex> lock(HLE::g_mmio_lock);
         RasterizerFlushVirtualRegion(vaddr, sizeof(T), FlushMode::FlushAndInvalidate);
         WriteMMIO<T>(GetMMIOHandler(vaddr), vaddr, data);
         break;
@@ -274,64 +292,70 @@ std::string ReadCString(VAddr vaddr, std::size_t max_length) {
     return string;
 }
 
-u8* GetPhysicalPointer(PAddr address) {
-    struct MemoryArea {
-        PAddr paddr_base;
-        u32 size;
-    };
-
-    static constexpr MemoryArea memory_areas[] = {
-        {VRAM_PADDR, VRAM_SIZE},
-        {IO_AREA_PADDR, IO_AREA_SIZE},
-        {DSP_RAM_PADDR, DSP_RAM_SIZE},
-        {FCRAM_PADDR, FCRAM_N3DS_SIZE},
-        {N3DS_EXTRA_RAM_PADDR, N3DS_EXTRA_RAM_SIZE},
-    };
-
-    const auto area =
-        std::find_if(std::begin(memory_areas), std::end(memory_areas), [&](const auto& area) {
-            return address >= area.paddr_base && address < area.paddr_base + area.size;
-        });
-
-    if (area == std::end(memory_areas)) {
-        LOG_ERROR(HW_Memory, "unknown GetPhysicalPointer @ 0x%08X", address);
-        return nullptr;
+/// Number of pages of the physical address space covered by the physical page tables
+static constexpr size_t PHYSICAL_PAGE_TABLE_NUM_ENTRIES = FCRAM_N3DS_PADDR_END >> PAGE_BITS;
+
+/**
+ * Host memory backing each physical page, indexed by physical page number. Null for pages that are
+ * not backed by memory, such as MMIO and FCRAM outside of the kernel memory regions.
+ */
+static std::array<u8*, PHYSICAL_PAGE_TABLE_NUM_ENTRIES> physical_page_pointers;
+
+/**
+ * Virtual address each physical page is mapped to by the fixed 1:1 mappings, indexed by physical
+ * page number. Zero for pages with no such mapping. FCRAM pages are relative to LINEAR_HEAP_VADDR,
+ * as the linear heap of the current process may be mapped at NEW_LINEAR_HEAP_VADDR instead.
+ */
+static std::array<VAddr, PHYSICAL_PAGE_TABLE_NUM_ENTRIES> physical_page_vaddrs;
+
+static void MapPhysicalPages(PAddr paddr, u32 size, u8* memory, VAddr vaddr) {
+    for (u32 offset = 0; offset < size; offset += PAGE_SIZE) {
+        const size_t page_index = (paddr + offset) >> PAGE_BITS;
+        physical_page_pointers[page_index] = memory != nullptr ? memory + offset : nullptr;
+        physical_page_vaddrs[page_index] = vaddr + offset;
     }
+}
 
-    if (area->paddr_base == IO_AREA_PADDR) {
-        LOG_ERROR(HW_Memory, "MMIO mappings are not supported yet. phys_addr=0x%08X", address);
-        return nullptr;
+/// Fills in the physical memory areas that do not depend on the kernel when the emulator starts.
+static const struct FixedPhysicalPagesInitializer {
+    FixedPhysicalPagesInitializer() {
+        MapPhysicalPages(VRAM_PADDR, VRAM_SIZE, vram.data(), VRAM_VADDR);
+        MapPhysicalPages(IO_AREA_PADDR, IO_AREA_SIZE, nullptr, IO_AREA_VADDR);
+        MapPhysicalPages(DSP_RAM_PADDR, DSP_RAM_SIZE, AudioCore::GetDspMemory().data(),
+                         DSP_RAM_VADDR);
+        MapPhysicalPages(N3DS_EXTRA_RAM_PADDR, N3DS_EXTRA_RAM_SIZE, n3ds_extra_ram.data(),
+                         N3DS_EXTRA_RAM_VADDR);
+        MapPhysicalPages(FCRAM_PADDR, FCRAM_SIZE, nullptr, LINEAR_HEAP_VADDR);
     }
+} fixed_physical_pages_initializer;
 
-    u32 offset_into_region = address - area->paddr_base;
+void UpdatePhysicalPageTable() {
+    std::fill(physical_page_pointers.begin() + (FCRAM_PADDR >> PAGE_BITS),
+              physical_page_pointers.end(), nullptr);
 
-    u8* target_pointer = nullptr;
-    switch (area->paddr_base) {
-    case VRAM_PADDR:
-        target_pointer = vram.data() + offset_into_region;
-        break;
-    case DSP_RAM_PADDR:
-        target_pointer = AudioCore::GetDspMemory().data() + offset_into_region;
-        break;
-    case FCRAM_PADDR:
-        for (const auto& region : Kernel::memory_regions) {
-            if (offset_into_region >= region.base &&
-                offset_into_region < region.base + region.size) {
-                target_pointer =
-                    region.linear_heap_memory->data() + offset_into_region - region.base;
-                break;
-            }
+    // The linear heap of each region is reserved up front, so it is never relocated
+    for (const auto& region : Kernel::memory_regions) {
+        if (region.linear_heap_memory != nullptr) {
+            MapPhysicalPages(FCRAM_PADDR + region.base, region.size,
+                             region.linear_heap_memory->data(), LINEAR_HEAP_VADDR + region.base);
+        }
+    }
+}
+
+u8* GetPhysicalPointer(PAddr address) {
+    if (address < FCRAM_N3DS_PADDR_END) {
+        u8* page_pointer = physical_page_pointers[address >> PAGE_BITS];
+        if (page_pointer != nullptr) {
+            return page_pointer + (address & PAGE_MASK);
         }
-        ASSERT_MSG(target_pointer != nullptr, "Invalid FCRAM address");
-        break;
-    case N3DS_EXTRA_RAM_PADDR:
-        target_pointer = n3ds_extra_ram.data() + offset_into_region;
-        break;
-    default:
-        UNREACHABLE();
     }
 
-    return target_pointer;
+    if (address >= IO_AREA_PADDR && address < IO_AREA_PADDR_END) {
+        LOG_ERROR(HW_Memory, "MMIO mappings are not supported yet. phys_addr=0x%08X", address);
+    } else {
+        LOG_ERROR(HW_Memory, "unknown GetPhysicalPointer @ 0x%08X", address);
+    }
+    return nullptr;
 }
 
 void RasterizerMarkRegionCached(PAddr start, u32 size, int count_delta) {
@@ -415,6 +439,7 @@ void RasterizerMarkRegionCached(PAddr start, u32 size, int count_delta) {
 
 void RasterizerFlushRegion(PAddr start, u32 size) {
     if (VideoCore::g_renderer != nullptr) {
+        Pica::GPUThread::WaitIdle();
         VideoCore::g_renderer->Rasterizer()->FlushRegion(start, size);
     }
 }
@@ -423,6 +448,7 @@ void RasterizerFlushAndInvalidateRegion(PAddr start, u32 size) {
     // Since pages are unmapped on shutdown after video core is shutdown, the renderer may be
     // null here
     if (VideoCore::g_renderer != nullptr) {
+        Pica::GPUThread::WaitIdle();
         VideoCore::g_renderer->Rasterizer()->FlushAndInvalidateRegion(start, size);
     }
 }
@@ -431,6 +457,7 @@ void RasterizerFlushVirtualRegion(VAddr start, u32 size, FlushMode mode) {
     // Since pages are unmapped on shutdown after video core is shutdown, the renderer may be
     // null here
     if (VideoCore::g_renderer != nullptr) {
+        Pica::GPUThread::WaitIdle();
         VAddr end = start + size;
 
         auto CheckRegion = [&](VAddr region_start, VAddr region_end) {
@@ -478,6 +505,35 @@ u64 Read64(const VAddr addr) {
     return Read<u64_le>(addr);
 }
 
+/**
+ * Returns how many bytes, up to `max_size`, starting at the given offset into a page of type
+ * Memory can be accessed with a single memcpy. The run extends over the following pages as long
+ * as they are backed by contiguous host memory, which is the common case for the pages of a heap.
+ */
+static size_t GetContiguousMemorySize(const PageTable& page_table, size_t page_index,
+                                      size_t page_offset, size_t max_size) {
+    size_t size = PAGE_SIZE - page_offset;
+    const u8* next_pointer = page_table.pointers[page_index] + PAGE_SIZE;
+    while (size < max_size && ++page_index < PAGE_TABLE_NUM_ENTRIES &&
+           page_table.pointers[page_index] == next_pointer) {
+        size += PAGE_SIZE;
+        next_pointer += PAGE_SIZE;
+    }
+    return std::min(size, max_size);
+}
+
+u8* GetContiguousPointer(const Kernel::Process& process, const VAddr vaddr, const size_t size) {
+    auto& page_table = process.vm_manager.page_table;
+    const size_t page_index = vaddr >> PAGE_BITS;
+    const size_t page_offset = vaddr & PAGE_MASK;
+
+    if (size == 0 || page_table.attributes[page_index] != PageType::Memory)
+        return nullptr;
+    if (GetContiguousMemorySize(page_table, page_index, page_offset, size) != size)
+        return nullptr;
+    return page_table.pointers[page_index] + page_offset;
+}
+
 void ReadBlock(const Kernel::Process& process, const VAddr src_addr, void* dest_buffer,
                const size_t size) {
     auto& page_table = process.vm_manager.page_table;
@@ -487,7 +543,7 @@ void ReadBlock(const Kernel::Process& process, const VAddr src_addr, void* dest_
     size_t page_offset = src_addr & PAGE_MASK;
 
     while (remaining_size > 0) {
-        const size_t copy_amount = std::min(PAGE_SIZE - page_offset, remaining_size);
+        size_t copy_amount = std::min(PAGE_SIZE - page_offset, remaining_size);
         const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
 
         switch (page_table.attributes[page_index]) {
@@ -500,6 +556,8 @@ void ReadBlock(const Kernel::Process& process, const VAddr src_addr, void* dest_
         case PageType::Memory: {
             DEBUG_ASSERT(page_table.pointers[page_index]);
 
+            copy_amount =
+                GetContiguousMemorySize(page_table, page_index, page_offset, remaining_size);
             const u8* src_ptr = page_table.pointers[page_index] + page_offset;
             std::memcpy(dest_buffer, src_ptr, copy_amount);
             break;
@@ -528,8 +586,8 @@ void ReadBlock(const Kernel::Process& process, const VAddr src_addr, void* dest_
             UNREACHABLE();
         }
 
-        page_index++;
-        page_offset = 0;
+        page_index += (page_offset + copy_amount) >> PAGE_BITS;
+        page_offset = (page_offset + copy_amount) & PAGE_MASK;
         dest_buffer = static_cast<u8*>(dest_buffer) + copy_amount;
         remaining_size -= copy_amount;
     }
@@ -563,7 +621,7 @@ void WriteBlock(const Kernel::Process& process, const VAddr dest_addr, const voi
     size_t page_offset = dest_addr & PAGE_MASK;
 
     while (remaining_size > 0) {
-        const size_t copy_amount = std::min(PAGE_SIZE - page_offset, remaining_size);
+        size_t copy_amount = std::min(PAGE_SIZE - page_offset, remaining_size);
         const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
 
         switch (page_table.attributes[page_index]) {
@@ -576,6 +634,8 @@ void WriteBlock(const Kernel::Process& process, const VAddr dest_addr, const voi
         case PageType::Memory: {
             DEBUG_ASSERT(page_table.pointers[page_index]);
 
+            copy_amount =
+                GetContiguousMemorySize(page_table, page_index, page_offset, remaining_size);
             u8* dest_ptr = page_table.pointers[page_index] + page_offset;
             std::memcpy(dest_ptr, src_buffer, copy_amount);
             break;
@@ -604,8 +664,8 @@ void WriteBlock(const Kernel::Process& process, const VAddr dest_addr, const voi
             UNREACHABLE();
         }
 
-        page_index++;
-        page_offset = 0;
+        page_index += (page_offset + copy_amount) >> PAGE_BITS;
+        page_offset = (page_offset + copy_amount) & PAGE_MASK;
         src_buffer = static_cast<const u8*>(src_buffer) + copy_amount;
         remaining_size -= copy_amount;
     }
@@ -624,7 +684,7 @@ void ZeroBlock(const Kernel::Process& process, const VAddr dest_addr, const size
     static const std::array<u8, PAGE_SIZE> zeros = {};
 
     while (remaining_size > 0) {
-        const size_t copy_amount = std::min(PAGE_SIZE - page_offset, remaining_size);
+        size_t copy_amount = std::min(PAGE_SIZE - page_offset, remaining_size);
         const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
 
         switch (page_table.attributes[page_index]) {
@@ -636,6 +696,8 @@ void ZeroBlock(const Kernel::Process& process, const VAddr dest_addr, const size
         case PageType::Memory: {
             DEBUG_ASSERT(page_table.pointers[page_index]);
 
+            copy_amount =
+                GetContiguousMemorySize(page_table, page_index, page_offset, remaining_size);
             u8* dest_ptr = page_table.pointers[page_index] + page_offset;
             std::memset(dest_ptr, 0, copy_amount);
             break;
@@ -664,8 +726,8 @@ void ZeroBlock(const Kernel::Process& process, const VAddr dest_addr, const size
             UNREACHABLE();
         }
 
-        page_index++;
-        page_offset = 0;
+        page_index += (page_offset + copy_amount) >> PAGE_BITS;
+        page_offset = (page_offset + copy_amount) & PAGE_MASK;
         remaining_size -= copy_amount;
     }
 }
@@ -681,7 +743,7 @@ void CopyBlock(const Kernel::Process& process, VAddr dest_addr, VAddr src_addr,
     size_t page_offset = src_addr & PAGE_MASK;
 
     while (remaining_size > 0) {
-        const size_t copy_amount = std::min(PAGE_SIZE - page_offset, remaining_size);
+        size_t copy_amount = std::min(PAGE_SIZE - page_offset, remaining_size);
         const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
 
         switch (page_table.attributes[page_index]) {
@@ -693,6 +755,8 @@ void CopyBlock(const Kernel::Process& process, VAddr dest_addr, VAddr src_addr,
         }
         case PageType::Memory: {
             DEBUG_ASSERT(page_table.pointers[page_index]);
+            copy_amount =
+                GetContiguousMemorySize(page_table, page_index, page_offset, remaining_size);
             const u8* src_ptr = page_table.pointers[page_index] + page_offset;
             WriteBlock(process, dest_addr, src_ptr, copy_amount);
             break;
@@ -726,8 +790,8 @@ void CopyBlock(const Kernel::Process& process, VAddr dest_addr, VAddr src_addr,
             UNREACHABLE();
         }
 
-        page_index++;
-        page_offset = 0;
+        page_index += (page_offset + copy_amount) >> PAGE_BITS;
+        page_offset = (page_offset + copy_amount) & PAGE_MASK;
         dest_addr += static_cast<VAddr>(copy_amount);
         src_addr += static_cast<VAddr>(copy_amount);
         remaining_size -= copy_amount;
@@ -739,42 +803,42 @@ void CopyBlock(VAddr dest_addr, VAddr src_addr, const size_t size) {
 }
 
 template <>
-u8 ReadMMIO<u8>(MMIORegionPointer mmio_handler, VAddr addr) {
+u8 ReadMMIO<u8>(const MMIORegionPointer& mmio_handler, VAddr addr) {
     return mmio_handler->Read8(addr);
 }
 
 template <>
-u16 ReadMMIO<u16>(MMIORegionPointer mmio_handler, VAddr addr) {
+u16 ReadMMIO<u16>(const MMIORegionPointer& mmio_handler, VAddr addr) {
     return mmio_handler->Read16(addr);
 }
 
 template <>
-u32 ReadMMIO<u32>(MMIORegionPointer mmio_handler, VAddr addr) {
+u32 ReadMMIO<u32>(const MMIORegionPointer& mmio_handler, VAddr addr) {
     return mmio_handler->Read32(addr);
 }
 
 template <>
-u64 ReadMMIO<u64>(MMIORegionPointer mmio_handler, VAddr addr) {
+u64 ReadMMIO<u64>(const MMIORegionPointer& mmio_handler, VAddr addr) {
     return mmio_handler->Read64(addr);
 }
 
 template <>
-void WriteMMIO<u8>(MMIORegionPointer mmio_handler, VAddr addr, const u8 data) {
+void WriteMMIO<u8>(const MMIORegionPointer& mmio_handler, VAddr addr, const u8 data) {
     mmio_handler->Write8(addr, data);
 }
 
 template <>
-void WriteMMIO<u16>(MMIORegionPointer mmio_handler, VAddr addr, const u16 data) {
+void WriteMMIO<u16>(const MMIORegionPointer& mmio_handler, VAddr addr, const u16 data) {
     mmio_handler->Write16(addr, data);
 }
 
 template <>
-void WriteMMIO<u32>(MMIORegionPointer mmio_handler, VAddr addr, const u32 data) {
+void WriteMMIO<u32>(const MMIORegionPointer& mmio_handler, VAddr addr, const u32 data) {
     mmio_handler->Write32(addr, data);
 }
 
 template <>
-void WriteMMIO<u64>(MMIORegionPointer mmio_handler, VAddr addr, const u64 data) {
+void WriteMMIO<u64>(const MMIORegionPointer& mmio_handler, VAddr addr, const u64 data) {
     mmio_handler->Write64(addr, data);
 }
 
@@ -811,19 +875,20 @@ PAddr VirtualToPhysicalAddress(const VAddr addr) {
 boost::optional<VAddr> PhysicalToVirtualAddress(const PAddr addr) {
     if (addr == 0) {
         return 0;
-    } else if (addr >= VRAM_PADDR && addr < VRAM_PADDR_END) {
-        return addr - VRAM_PADDR + VRAM_VADDR;
-    } else if (addr >= FCRAM_PADDR && addr < FCRAM_PADDR_END) {
-        return addr - FCRAM_PADDR + Kernel::g_current_process->GetLinearHeapAreaAddress();
-    } else if (addr >= DSP_RAM_PADDR && addr < DSP_RAM_PADDR_END) {
-        return addr - DSP_RAM_PADDR + DSP_RAM_VADDR;
-    } else if (addr >= IO_AREA_PADDR && addr < IO_AREA_PADDR_END) {
-        return addr - IO_AREA_PADDR + IO_AREA_VADDR;
-    } else if (addr >= N3DS_EXTRA_RAM_PADDR && addr < N3DS_EXTRA_RAM_PADDR_END) {
-        return addr - N3DS_EXTRA_RAM_PADDR + N3DS_EXTRA_RAM_VADDR;
+    } else if (addr >= FCRAM_N3DS_PADDR_END) {
+        return boost::none;
     }
 
-    return boost::none;
+    const VAddr page_vaddr = physical_page_vaddrs[addr >> PAGE_BITS];
+    if (page_vaddr == 0) {
+        return boost::none;
+    }
+
+    VAddr vaddr = page_vaddr + (addr & PAGE_MASK);
+    if (addr >= FCRAM_PADDR) {
+        vaddr += Kernel::g_current_process->GetLinearHeapAreaAddress() - LINEAR_HEAP_VADDR;
+    }
+    return vaddr;
 }
 
 } // namespace Memory
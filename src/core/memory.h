@@ -42,12 +42,6 @@ enum class PageType {
     RasterizerCachedSpecial,
 };
 
-struct SpecialRegion {
-    VAddr base;
-    u32 size;
-    MMIORegionPointer handler;
-};
-
 /**
  * A (reasonably) fast way of allowing switchable and remappable process address spaces. It loosely
  * mimics the way a real CPU page table works, but instead is optimized for minimal decoding and
@@ -65,7 +59,13 @@ struct PageTable {
      * Contains MMIO handlers that back memory regions whose entries in the `attribute` array is of
      * type `Special`.
      */
-    std::vector<SpecialRegion> special_regions;
+    std::vector<MMIORegionPointer> special_regions;
+
+    /**
+     * Array of indices into `special_regions`, giving the MMIO handler of each page whose entry in
+     * the `attributes` array is of type `Special`. Other entries are unspecified.
+     */
+    std::array<u16, PAGE_TABLE_NUM_ENTRIES> special_region_indices;
 
     /**
      * Array of fine grained page attributes. If it is set to any value other than `Memory`, then
@@ -218,6 +218,13 @@ void CopyBlock(VAddr dest_addr, VAddr src_addr, size_t size);
 
 u8* GetPointer(VAddr virtual_address);
 
+/**
+ * Returns a host pointer to `size` bytes of the memory of a process, if they are all regular memory
+ * backed by contiguous host memory, so that they can be accessed without going through ReadBlock or
+ * WriteBlock. Returns nullptr otherwise, including for memory cached by the rasterizer.
+ */
+u8* GetContiguousPointer(const Kernel::Process& process, VAddr vaddr, size_t size);
+
 std::string ReadCString(VAddr virtual_address, std::size_t max_length);
 
 /**
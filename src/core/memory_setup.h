@@ -29,4 +29,10 @@ void MapMemoryRegion(PageTable& page_table, VAddr base, u32 size, u8* target);
 void MapIoRegion(PageTable& page_table, VAddr base, u32 size, MMIORegionPointer mmio_handler);
 
 void UnmapRegion(PageTable& page_table, VAddr base, u32 size);
+
+/**
+ * Updates the FCRAM pages of the table of host memory backing the physical address space, which
+ * is used by GetPhysicalPointer(). Must be called whenever the kernel memory regions change.
+ */
+void UpdatePhysicalPageTable();
 }
@@ -40,7 +40,8 @@ void PerfStats::EndGameFrame() {
     game_frames += 1;
 }
 
-PerfStats::Results PerfStats::GetAndResetStats(u64 current_system_time_us) {
+PerfStats::Results PerfStats::GetAndResetStats(u64 current_system_time_us,
+                                               const CoreTiming::SliceStats& current_slice_stats) {
     std::lock_guard<std::mutex> lock(object_mutex);
 
     auto now = Clock::now();
@@ -57,9 +58,20 @@ PerfStats::Results PerfStats::GetAndResetStats(u64 current_system_time_us) {
                         static_cast<double>(system_frames);
     results.emulation_speed = system_us_per_second / 1'000'000.0;
 
+    const u64 slices = current_slice_stats.num_slices - reset_point_slice_stats.num_slices;
+    const u64 slice_cycles =
+        current_slice_stats.total_cycles - reset_point_slice_stats.total_cycles;
+    const u64 advance_time_ns =
+        current_slice_stats.advance_time_ns - reset_point_slice_stats.advance_time_ns;
+    results.slices_per_second = static_cast<double>(slices) / interval;
+    results.average_slice_length =
+        slices != 0 ? static_cast<double>(slice_cycles) / static_cast<double>(slices) : 0.0;
+    results.advance_time = static_cast<double>(advance_time_ns) / 1'000'000'000.0 / interval;
+
     // Reset counters
     reset_point = now;
     reset_point_system_us = current_system_time_us;
+    reset_point_slice_stats = current_slice_stats;
     accumulated_frametime = Clock::duration::zero();
     system_frames = 0;
     game_frames = 0;
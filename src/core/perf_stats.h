@@ -7,6 +7,7 @@
 #include <chrono>
 #include <mutex>
 #include "common/common_types.h"
+#include "core/core_timing.h"
 
 namespace Core {
 
@@ -27,13 +28,20 @@ public:
         double frametime;
         /// Ratio of walltime / emulated time elapsed
         double emulation_speed;
+        /// CoreTiming slices per second of walltime
+        double slices_per_second;
+        /// Average length of a CoreTiming slice, in CPU cycles
+        double average_slice_length;
+        /// Ratio of the walltime spent in CoreTiming::Advance()
+        double advance_time;
     };
 
     void BeginSystemFrame();
     void EndSystemFrame();
     void EndGameFrame();
 
-    Results GetAndResetStats(u64 current_system_time_us);
+    Results GetAndResetStats(u64 current_system_time_us,
+                             const CoreTiming::SliceStats& current_slice_stats);
 
     /**
      * Gets the ratio between walltime and the emulated time of the previous system frame. This is
@@ -48,6 +56,8 @@ private:
     Clock::time_point reset_point = Clock::now();
     /// System time when the cumulative counters were reset
     u64 reset_point_system_us = 0;
+    /// CoreTiming slice statistics when the cumulative counters were reset
+    CoreTiming::SliceStats reset_point_slice_stats{};
 
     /// Cumulative duration (excluding v-sync/frame-limiting) of frames since last reset
     Clock::duration accumulated_frametime = Clock::duration::zero();
@@ -85,6 +85,11 @@ struct Values {
 
     // Core
     bool use_cpu_jit;
+    bool use_translation_disk_cache;
+    bool use_idle_loop_skipping;
+    std::string idle_loop_skipping_disabled_titles;
+    bool use_adaptive_slicing;
+    bool use_async_service_requests;
 
     // Data Storage
     bool use_virtual_sd;
@@ -95,6 +100,8 @@ struct Values {
     // Renderer
     bool use_hw_renderer;
     bool use_shader_jit;
+    bool use_gpu_thread;
+    bool use_shader_disk_cache;
     float resolution_factor;
     bool use_vsync;
     bool toggle_framelimit;
@@ -129,6 +136,8 @@ struct Values {
     // Debugging
     bool use_gdbstub;
     u16 gdbstub_port;
+    bool enable_cpu_profiler;
+    u32 cpu_profiler_sample_rate;
 
     // WebService
     bool enable_telemetry;
@@ -0,0 +1,49 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch.hpp>
+#include "common/object_pool.h"
+
+namespace Common {
+
+namespace {
+
+struct TestObject {
+    u64 data[5];
+};
+
+} // Anonymous namespace
+
+TEST_CASE("ObjectPool", "[common]") {
+    ObjectPool<TestObject, 4> pool;
+    REQUIRE(pool.GetCapacity() == 0);
+
+    void* a = pool.Allocate();
+    void* b = pool.Allocate();
+    REQUIRE(pool.GetCapacity() == 4);
+    REQUIRE(pool.GetNumAllocated() == 2);
+    REQUIRE(static_cast<TestObject*>(b) == static_cast<TestObject*>(a) + 1);
+
+    SECTION("reuses the most recently freed slot") {
+        pool.Free(a);
+        pool.Free(b);
+        REQUIRE(pool.GetNumAllocated() == 0);
+        REQUIRE(pool.Allocate() == b);
+        REQUIRE(pool.Allocate() == a);
+        REQUIRE(pool.GetCapacity() == 4);
+    }
+
+    SECTION("adds slabs when full") {
+        void* c = pool.Allocate();
+        void* d = pool.Allocate();
+        void* e = pool.Allocate();
+        REQUIRE(pool.GetCapacity() == 8);
+        REQUIRE(pool.GetNumAllocated() == 5);
+        for (void* object : {a, b, c, d}) {
+            REQUIRE(object != e);
+        }
+    }
+}
+
+} // namespace Common
@@ -0,0 +1,46 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <catch.hpp>
+#include "common/thread_pool.h"
+
+namespace Common {
+
+TEST_CASE("ThreadPool: runs all the submitted tasks", "[common]") {
+    std::atomic<int> sum{0};
+    {
+        ThreadPool pool(4, "ThreadPool test");
+        for (int i = 1; i <= 100; ++i) {
+            pool.Submit([&sum, i] { sum += i; });
+        }
+        pool.WaitIdle();
+        REQUIRE(sum == 5050);
+
+        // The tasks queued when the pool is destroyed still run
+        for (int i = 0; i < 10; ++i) {
+            pool.Submit([&sum] { ++sum; });
+        }
+    }
+    REQUIRE(sum == 5060);
+}
+
+TEST_CASE("ThreadPool: a single worker runs tasks in order", "[common]") {
+    std::mutex mutex;
+    std::vector<int> order;
+    {
+        ThreadPool pool(1, "ThreadPool test");
+        for (int i = 0; i < 10; ++i) {
+            pool.Submit([&, i] {
+                std::lock_guard<std::mutex> lock(mutex);
+                order.push_back(i);
+            });
+        }
+    }
+    REQUIRE(order == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+}
+
+} // namespace Common
@@ -0,0 +1,82 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch.hpp>
+#include "common/thread_queue_list.h"
+
+namespace Common {
+
+namespace {
+
+struct TestThread {
+    unsigned int priority = 0;
+    ThreadQueueListHook<TestThread> hook;
+};
+
+using TestQueue = ThreadQueueList<TestThread, 64, &TestThread::hook>;
+
+} // Anonymous namespace
+
+TEST_CASE("ThreadQueueList", "[common]") {
+    TestQueue queue;
+    TestThread a, b, c, d;
+
+    REQUIRE(queue.get_first() == nullptr);
+    REQUIRE(queue.pop_first() == nullptr);
+
+    queue.push_back(10, &a);
+    queue.push_back(10, &b);
+    queue.push_front(10, &c);
+    queue.push_back(63, &d);
+    REQUIRE(!queue.empty(10));
+    REQUIRE(queue.empty(11));
+    REQUIRE(queue.contains(&b) == 10);
+    REQUIRE(queue.contains(&d) == 63);
+
+    SECTION("pops in priority then FIFO order") {
+        REQUIRE(queue.pop_first() == &c);
+        REQUIRE(queue.pop_first() == &a);
+        REQUIRE(queue.pop_first() == &b);
+        REQUIRE(queue.empty(10));
+        REQUIRE(queue.pop_first() == &d);
+        REQUIRE(queue.pop_first() == nullptr);
+        REQUIRE(queue.contains(&a) == static_cast<unsigned int>(-1));
+    }
+
+    SECTION("only pops strictly better threads") {
+        REQUIRE(queue.pop_first_better(10) == nullptr);
+        REQUIRE(queue.pop_first_better(11) == &c);
+        REQUIRE(queue.get_first() == &a);
+    }
+
+    SECTION("removes from any position") {
+        queue.remove(10, &a);
+        queue.remove(10, &a); // Not queued anymore
+        REQUIRE(queue.pop_first() == &c);
+        queue.remove(10, &b);
+        REQUIRE(queue.empty(10));
+        REQUIRE(queue.get_first() == &d);
+    }
+
+    SECTION("moves and rotates") {
+        queue.move(&d, 63, 0);
+        REQUIRE(queue.empty(63));
+        REQUIRE(queue.get_first() == &d);
+        queue.remove(0, &d);
+        queue.rotate(10);
+        REQUIRE(queue.pop_first() == &a);
+        REQUIRE(queue.pop_first() == &b);
+        REQUIRE(queue.pop_first() == &c);
+    }
+
+    SECTION("clears all levels") {
+        queue.clear();
+        REQUIRE(queue.get_first() == nullptr);
+        REQUIRE(queue.contains(&a) == static_cast<unsigned int>(-1));
+        queue.push_back(5, &a);
+        REQUIRE(queue.pop_first() == &a);
+    }
+}
+
+} // namespace Common
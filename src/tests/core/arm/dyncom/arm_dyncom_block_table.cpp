@@ -0,0 +1,155 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch.hpp>
+#include "core/arm/dyncom/arm_dyncom.h"
+#include "core/arm/dyncom/arm_dyncom_block_table.h"
+#include "core/arm/dyncom/arm_dyncom_trans.h"
+#include "core/core_timing.h"
+#include "tests/core/arm/arm_test_common.h"
+
+namespace ArmTests {
+
+TEST_CASE("BlockTable: insert, lookup and invalidate", "[arm_dyncom]") {
+    BlockTable table;
+
+    REQUIRE(table.Find(0x00100000) == BlockTable::INVALID_OFFSET);
+
+    table.Insert(0x00100000, 0);
+    table.Insert(0x00100002, 16); // Thumb entry points are halfword aligned
+    table.Insert(0x00101FFC, 32);
+    REQUIRE(table.Find(0x00100000) == 0);
+    REQUIRE(table.Find(0x00100002) == 16);
+    REQUIRE(table.Find(0x00101FFC) == 32);
+    REQUIRE(table.Find(0x00100004) == BlockTable::INVALID_OFFSET);
+
+    // Invalidation is page granular: touching one byte of the first page drops its blocks only
+    table.InvalidateRange(0x00100FFF, 1);
+    REQUIRE(table.Find(0x00100000) == BlockTable::INVALID_OFFSET);
+    REQUIRE(table.Find(0x00100002) == BlockTable::INVALID_OFFSET);
+    REQUIRE(table.Find(0x00101FFC) == 32);
+
+    table.Insert(0xFFFFFFFC, 48);
+    table.InvalidateRange(0xFFFFF000, 0x1000);
+    REQUIRE(table.Find(0xFFFFFFFC) == BlockTable::INVALID_OFFSET);
+
+    table.Clear();
+    REQUIRE(table.Find(0x00101FFC) == BlockTable::INVALID_OFFSET);
+}
+
+TEST_CASE("BlockTable: translation cache space and statistics", "[arm_dyncom]") {
+    BlockTable table;
+
+    const u32 offset = table.BeginBlock(0x00100000);
+    trans_cache_buf_top += 64; // Pretend a block was translated
+    table.EndBlock(0x00100000, offset);
+
+    // The next block of the same page goes right after the previous one
+    REQUIRE(table.BeginBlock(0x00100040) == offset + 64);
+
+    REQUIRE(table.Lookup(0x00100000) == offset);
+    REQUIRE(table.Lookup(0x00100004) == BlockTable::INVALID_OFFSET);
+
+    BlockTable::Stats stats = table.TakeStats();
+    REQUIRE(stats.hits == 1);
+    REQUIRE(stats.misses == 1);
+    REQUIRE(stats.flushes == 0);
+
+    table.Clear();
+    stats = table.TakeStats();
+    REQUIRE(stats.hits == 0);
+    REQUIRE(stats.flushes == 1);
+}
+
+TEST_CASE("BlockTable: pages entered through links are not evicted", "[arm_dyncom]") {
+    BlockTable table;
+
+    // Fill the whole translation cache with one chunk per page
+    const auto translate = [&table](u32 page_index) {
+        const u32 addr = page_index << Memory::PAGE_BITS;
+        const u32 offset = table.BeginBlock(addr);
+        trans_cache_buf_top += 64;
+        table.EndBlock(addr, offset);
+    };
+    for (u32 page_index = 0; page_index < TRANS_CACHE_NUM_CHUNKS; ++page_index) {
+        translate(page_index);
+    }
+
+    // Page 0 is dispatched to first, and only entered through links after the other pages
+    REQUIRE(table.Lookup(0) != BlockTable::INVALID_OFFSET);
+    for (u32 page_index = 1; page_index < TRANS_CACHE_NUM_CHUNKS; ++page_index) {
+        REQUIRE(table.Lookup(page_index << Memory::PAGE_BITS) != BlockTable::INVALID_OFFSET);
+    }
+    table.LinkedHit(0);
+    table.LinkedHit(0);
+
+    BlockTable::Stats stats = table.TakeStats();
+    REQUIRE(stats.hits == TRANS_CACHE_NUM_CHUNKS + 2);
+    REQUIRE(stats.evictions == 0);
+
+    // Page 1 is now the least recently entered one
+    translate(TRANS_CACHE_NUM_CHUNKS);
+    stats = table.TakeStats();
+    REQUIRE(stats.evictions == 1);
+    REQUIRE(table.Find(0) != BlockTable::INVALID_OFFSET);
+    REQUIRE(table.Find(1 << Memory::PAGE_BITS) == BlockTable::INVALID_OFFSET);
+    REQUIRE(table.Find(2 << Memory::PAGE_BITS) != BlockTable::INVALID_OFFSET);
+}
+
+TEST_CASE("ARM_DynCom: InvalidateCacheRange retranslates modified code", "[arm_dyncom]") {
+    TestEnvironment test_env(false);
+    test_env.SetMemory32(0, 0xE3A01001); // mov r1, #1
+    test_env.SetMemory32(4, 0xEAFFFFFE); // b +#0
+
+    ARM_DynCom dyncom(USER32MODE);
+
+    dyncom.SetPC(0);
+    dyncom.Step();
+    REQUIRE(dyncom.GetReg(1) == 1);
+
+    test_env.SetMemory32(0, 0xE3A01002); // mov r1, #2
+    dyncom.InvalidateCacheRange(0, 4);
+
+    dyncom.SetPC(0);
+    dyncom.Step();
+    REQUIRE(dyncom.GetReg(1) == 2);
+}
+
+TEST_CASE("ARM_DynCom: block links are broken by invalidation", "[arm_dyncom]") {
+    TestEnvironment test_env(false);
+    test_env.SetMemory32(0x0000, 0xEB0003FE); // bl #0x1000
+    test_env.SetMemory32(0x0004, 0xE2500001); // subs r0, r0, #1
+    test_env.SetMemory32(0x0008, 0x1AFFFFFC); // bne #0
+    test_env.SetMemory32(0x000C, 0xEAFFFFFE); // b +#0
+    test_env.SetMemory32(0x1000, 0xE2811001); // add r1, r1, #1
+    test_env.SetMemory32(0x1004, 0xE12FFF1E); // bx lr
+
+    CoreTiming::Init();
+    ARM_DynCom dyncom(USER32MODE);
+
+    const auto run_loop = [&dyncom] {
+        dyncom.SetPC(0);
+        dyncom.SetReg(0, 100);
+        dyncom.SetReg(1, 0);
+        while (dyncom.GetReg(0) != 0) {
+            CoreTiming::Advance();
+            dyncom.Run();
+        }
+    };
+
+    run_loop();
+    REQUIRE(dyncom.GetReg(1) == 100);
+
+    // Only the callee's page is invalidated, but every link is broken, so the caller's block has
+    // to look the callee up again and link to its new translation
+    test_env.SetMemory32(0x1000, 0xE2811002); // add r1, r1, #2
+    dyncom.InvalidateCacheRange(0x1000, 4);
+
+    run_loop();
+    REQUIRE(dyncom.GetReg(1) == 200);
+
+    CoreTiming::Shutdown();
+}
+
+} // namespace ArmTests
@@ -0,0 +1,79 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch.hpp>
+
+#include <string>
+#include <vector>
+#include "common/file_util.h"
+#include "core/arm/dyncom/arm_dyncom_disk_cache.h"
+#include "core/arm/dyncom/arm_dyncom_interpreter.h"
+#include "core/arm/skyeye_common/armstate.h"
+#include "tests/core/arm/arm_test_common.h"
+
+namespace ArmTests {
+
+TEST_CASE("BlockDiskCache: blocks are kept across runs of the same code", "[arm_dyncom]") {
+    const std::string test_dir = "./block_disk_cache_test/";
+    const std::string path = test_dir + "0004000000033500.bin";
+    FileUtil::DeleteDirRecursively(test_dir);
+
+    {
+        BlockDiskCache cache;
+        REQUIRE(cache.Open(path, 0x1234, 0x00100000, 0x1000).empty());
+        cache.Record(0x00100000, false);
+        cache.Record(0x00100010, true);
+        cache.Record(0x00100000, false); // Already recorded
+        cache.Record(0x00101000, false); // Outside of the code segment
+        REQUIRE(cache.GetNumNewBlocks() == 2);
+        cache.Save();
+    }
+
+    {
+        BlockDiskCache cache;
+        REQUIRE(cache.Open(path, 0x1234, 0x00100000, 0x1000) ==
+                std::vector<u32>{0x00100000, 0x00100011});
+        cache.Record(0x00100010, true); // Loaded from the cache
+        cache.Record(0x00100020, false);
+        REQUIRE(cache.GetNumNewBlocks() == 1);
+        cache.Save();
+    }
+
+    {
+        BlockDiskCache cache;
+        REQUIRE(cache.Open(path, 0x1234, 0x00100000, 0x1000) ==
+                std::vector<u32>{0x00100000, 0x00100011, 0x00100020});
+    }
+
+    // The blocks of other code are discarded
+    {
+        BlockDiskCache cache;
+        REQUIRE(cache.Open(path, 0x5678, 0x00100000, 0x1000).empty());
+    }
+    {
+        BlockDiskCache cache;
+        REQUIRE(cache.Open(path, 0x1234, 0x00100000, 0x1000).empty());
+    }
+
+    FileUtil::DeleteDirRecursively(test_dir);
+}
+
+TEST_CASE("ARM_DynCom: cached blocks are translated ahead of time", "[arm_dyncom]") {
+    TestEnvironment test_env(false);
+    test_env.SetMemory32(0x00, 0xE3A00001); // mov r0, #1
+    test_env.SetMemory32(0x04, 0xEAFFFFFE); // b +#0
+    test_env.SetMemory32(0x10, 0xE7FE2001); // movs r0, #1 (Thumb); b +#0 (Thumb)
+
+    ARMul_State state(USER32MODE);
+    state.Reg[15] = 0x40;
+    InterpreterTranslateBlocks(&state, {0x00, 0x11});
+
+    REQUIRE(state.instruction_cache.Find(0x00) != BlockTable::INVALID_OFFSET);
+    REQUIRE(state.instruction_cache.Find(0x10) != BlockTable::INVALID_OFFSET);
+    REQUIRE(state.instruction_cache.Find(0x04) == BlockTable::INVALID_OFFSET);
+    REQUIRE(state.Reg[15] == 0x40);
+    REQUIRE(state.TFlag == 0);
+}
+
+} // namespace ArmTests
@@ -0,0 +1,192 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch.hpp>
+
+#include <array>
+#include <cstring>
+#include "core/arm/dyncom/arm_dyncom.h"
+#include "core/core_timing.h"
+#include "core/memory.h"
+#include "core/memory_setup.h"
+#include "tests/core/arm/arm_test_common.h"
+
+namespace ArmTests {
+
+// Blocks translated for Run() have their frequent instruction pairs fused, while Step() translates
+// single instructions. Both have to give the same results.
+TEST_CASE("ARM_DynCom: fused instruction pairs", "[arm_dyncom]") {
+    TestEnvironment test_env(false);
+    test_env.SetMemory32(0x00, 0xE3A00064); // mov r0, #100
+    test_env.SetMemory32(0x04, 0xE3A01000); // mov r1, #0
+    test_env.SetMemory32(0x08, 0xE3A02A01); // mov r2, #0x1000
+    test_env.SetMemory32(0x0C, 0xE4923004); // ldr r3, [r2], #4
+    test_env.SetMemory32(0x10, 0xE0811003); // add r1, r1, r3
+    test_env.SetMemory32(0x14, 0xE3A04003); // mov r4, #3
+    test_env.SetMemory32(0x18, 0xE1B05184); // movs r5, r4, lsl #3
+    test_env.SetMemory32(0x1C, 0xE2400001); // sub r0, r0, #1
+    test_env.SetMemory32(0x20, 0xE3500000); // cmp r0, #0
+    test_env.SetMemory32(0x24, 0x1AFFFFF8); // bne #0xC
+    test_env.SetMemory32(0x28, 0xEAFFFFFE); // b +#0
+    for (u32 i = 0; i < 100; ++i) {
+        test_env.SetMemory32(0x1000 + i * 4, i * 3 + 1);
+    }
+
+    CoreTiming::Init();
+
+    ARM_DynCom stepped(USER32MODE);
+    stepped.SetPC(0);
+    while (stepped.GetPC() != 0x28) {
+        stepped.Step();
+    }
+
+    ARM_DynCom run(USER32MODE);
+    run.SetPC(0);
+    while (run.GetPC() != 0x28) {
+        CoreTiming::Advance();
+        run.Run();
+    }
+
+    REQUIRE(run.GetReg(1) == 14950);
+    for (int i = 0; i < 15; ++i) {
+        REQUIRE(run.GetReg(i) == stepped.GetReg(i));
+    }
+    REQUIRE(run.GetCPSR() == stepped.GetCPSR());
+
+    CoreTiming::Shutdown();
+}
+
+// The flags of additions and subtractions are only computed when needed. Instructions that only
+// update some of the flags have to see the ones left unchanged.
+TEST_CASE("ARM_DynCom: lazily evaluated flags", "[arm_dyncom]") {
+    TestEnvironment test_env(false);
+    test_env.SetMemory32(0x00, 0xE3E00000); // mvn r0, #0
+    test_env.SetMemory32(0x04, 0xE2900001); // adds r0, r0, #1
+    test_env.SetMemory32(0x08, 0xE1B01002); // movs r1, r2
+    test_env.SetMemory32(0x0C, 0xE10F3000); // mrs r3, cpsr
+    test_env.SetMemory32(0x10, 0xE3A04102); // mov r4, #0x80000000
+    test_env.SetMemory32(0x14, 0xE0944004); // adds r4, r4, r4
+    test_env.SetMemory32(0x18, 0xE1B05004); // movs r5, r4
+    test_env.SetMemory32(0x1C, 0xE10F6000); // mrs r6, cpsr
+    test_env.SetMemory32(0x20, 0xEAFFFFFE); // b +#0
+
+    CoreTiming::Init();
+
+    ARM_DynCom dyncom(USER32MODE);
+    dyncom.SetPC(0);
+    dyncom.SetReg(2, 5);
+    while (dyncom.GetPC() != 0x20) {
+        CoreTiming::Advance();
+        dyncom.Run();
+    }
+
+    REQUIRE(dyncom.GetReg(3) >> 28 == 0x2); // C from adds
+    REQUIRE(dyncom.GetReg(6) >> 28 == 0x7); // ZCV from adds, Z from movs
+    REQUIRE(dyncom.GetCPSR() >> 28 == 0x7);
+
+    CoreTiming::Shutdown();
+}
+
+// Plain memory is accessed directly by the interpreter, while MMIO pages still go through the
+// memory system.
+TEST_CASE("ARM_DynCom: direct memory accesses", "[arm_dyncom]") {
+    TestEnvironment test_env(false);
+    test_env.SetMemory32(0x00, 0xE3A01A11); // mov r1, #0x11000
+    test_env.SetMemory32(0x04, 0xE5910000); // ldr r0, [r1]
+    test_env.SetMemory32(0x08, 0xE2800001); // add r0, r0, #1
+    test_env.SetMemory32(0x0C, 0xE5810004); // str r0, [r1, #4]
+    test_env.SetMemory32(0x10, 0xE1C100B8); // strh r0, [r1, #8]
+    test_env.SetMemory32(0x14, 0xE5C1000A); // strb r0, [r1, #10]
+    test_env.SetMemory32(0x18, 0xE1C120DC); // ldrd r2, r3, [r1, #12]
+    test_env.SetMemory32(0x1C, 0xE5810FFC); // str r0, [r1, #0xFFC]
+    test_env.SetMemory32(0x20, 0xE2811A01); // add r1, r1, #0x1000
+    test_env.SetMemory32(0x24, 0xE5810000); // str r0, [r1]
+    test_env.SetMemory32(0x28, 0xEAFFFFFE); // b +#0
+
+    alignas(4) std::array<u8, Memory::PAGE_SIZE> page{};
+    const u32 initial[] = {0x12345677, 0, 0, 0xAABBCCDD, 0x11223344};
+    std::memcpy(page.data(), initial, sizeof(initial));
+
+    Memory::PageTable& page_table = *Memory::GetCurrentPageTable();
+    Memory::MapMemoryRegion(page_table, 0x11000, Memory::PAGE_SIZE, page.data());
+
+    CoreTiming::Init();
+
+    ARM_DynCom dyncom(USER32MODE);
+    dyncom.SetPC(0);
+    while (dyncom.GetPC() != 0x28) {
+        CoreTiming::Advance();
+        dyncom.Run();
+    }
+
+    u32 words[4];
+    std::memcpy(words, page.data(), sizeof(words));
+    REQUIRE(dyncom.GetReg(0) == 0x12345678);
+    REQUIRE(words[1] == 0x12345678);
+    REQUIRE(words[2] == 0x00785678);
+    REQUIRE(dyncom.GetReg(2) == 0xAABBCCDD);
+    REQUIRE(dyncom.GetReg(3) == 0x11223344);
+
+    // Only the write to the MMIO page after the mapped one went through the memory system
+    u32 last_word;
+    std::memcpy(&last_word, page.data() + 0xFFC, sizeof(last_word));
+    REQUIRE(last_word == 0x12345678);
+    const auto write_records = test_env.GetWriteRecords();
+    REQUIRE(write_records.size() == 1);
+    REQUIRE(write_records[0] == WriteRecord(32, 0x12000, 0x12345678));
+
+    CoreTiming::Shutdown();
+
+    Memory::UnmapRegion(page_table, 0x11000, Memory::PAGE_SIZE);
+}
+
+// Loops that poll memory are skipped up to the next event once they spin. Loops that make progress
+// are run as usual.
+TEST_CASE("ARM_DynCom: idle loop skipping", "[arm_dyncom]") {
+    TestEnvironment test_env(false);
+    test_env.SetMemory32(0x00, 0xE3A01A01); // mov r1, #0x1000
+    test_env.SetMemory32(0x04, 0xE5910000); // ldr r0, [r1]
+    test_env.SetMemory32(0x08, 0xE3500000); // cmp r0, #0
+    test_env.SetMemory32(0x0C, 0x0AFFFFFC); // beq #0x4
+    test_env.SetMemory32(0x10, 0xE5912004); // ldr r2, [r1, #4]
+    test_env.SetMemory32(0x14, 0xE2833001); // add r3, r3, #1
+    test_env.SetMemory32(0x18, 0xE3520000); // cmp r2, #0
+    test_env.SetMemory32(0x1C, 0x0AFFFFFB); // beq #0x10
+    test_env.SetMemory32(0x20, 0xEAFFFFFE); // b +#0
+
+    CoreTiming::Init();
+
+    ARM_DynCom dyncom(USER32MODE);
+    dyncom.SetIdleLoopSkipping(true);
+    dyncom.SetPC(0);
+
+    // The first iteration of the loop is part of the block at 0x00. The loop is found to spin
+    // after the second iteration of its own block, which starts at 0x04.
+    CoreTiming::Advance();
+    dyncom.Run();
+    REQUIRE(dyncom.GetPC() == 0x04);
+    REQUIRE(dyncom.GetNumSkippedIdleLoops() == 1);
+    REQUIRE(dyncom.GetSkippedIdleCycles() == CoreTiming::GetIdleTicks());
+    REQUIRE(CoreTiming::GetTicks() - CoreTiming::GetIdleTicks() == 10);
+
+    // The second loop counts its iterations
+    test_env.SetMemory32(0x1000, 1);
+    CoreTiming::Advance();
+    dyncom.Run();
+    REQUIRE(dyncom.GetPC() >= 0x10);
+    REQUIRE(dyncom.GetPC() <= 0x1C);
+    REQUIRE(dyncom.GetReg(3) > 1000);
+    REQUIRE(dyncom.GetNumSkippedIdleLoops() == 1);
+
+    test_env.SetMemory32(0x1004, 1);
+    CoreTiming::Advance();
+    dyncom.Run();
+    REQUIRE(dyncom.GetPC() == 0x20);
+    REQUIRE(dyncom.GetNumSkippedIdleLoops() == 2);
+    REQUIRE(dyncom.GetSkippedIdleCycles() == CoreTiming::GetIdleTicks());
+
+    CoreTiming::Shutdown();
+}
+
+} // namespace ArmTests
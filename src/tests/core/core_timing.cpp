@@ -4,9 +4,12 @@
 
 #include <catch.hpp>
 
+#include <algorithm>
 #include <array>
 #include <bitset>
 #include <string>
+#include <tuple>
+#include <vector>
 #include "common/file_util.h"
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -235,3 +238,119 @@ TEST_CASE("CoreTiming[ChainScheduling]", "[core]") {
     REQUIRE(0 == reschedules);
     REQUIRE(MAX_SLICE_LENGTH == CoreTiming::GetDowncount());
 }
+
+namespace UnscheduleTest {
+static std::vector<u64> fired;
+
+static void RecordCallback(u64 userdata, s64 cycles_late) {
+    fired.push_back(userdata);
+}
+} // namespace UnscheduleTest
+
+TEST_CASE("CoreTiming[Unschedule]", "[core]") {
+    using namespace UnscheduleTest;
+
+    ScopeInit guard;
+
+    CoreTiming::EventType* cb_a = CoreTiming::RegisterEvent("callbackA", RecordCallback);
+    CoreTiming::EventType* cb_b = CoreTiming::RegisterEvent("callbackB", RecordCallback);
+
+    // Enter slice 0
+    CoreTiming::Advance();
+
+    // Events of A keep the userdata i, events of B use i + 1000 so they can be told apart.
+    // Every third event of A shares its userdata with the previous one.
+    struct Expected {
+        s64 time;
+        u64 order;
+        u64 userdata;
+    };
+    std::vector<Expected> expected;
+    u32 seed = 1;
+    for (u64 i = 0; i < 300; ++i) {
+        seed = seed * 1103515245 + 12345;
+        const s64 time = (seed >> 8) % 50000;
+        if (i % 5 == 4) {
+            CoreTiming::ScheduleEvent(time, cb_b, i + 1000);
+        } else {
+            const u64 userdata = i % 3 == 2 ? i - 1 : i;
+            CoreTiming::ScheduleEvent(time, cb_a, userdata);
+            if (userdata % 4 != 0)
+                expected.push_back({time, i, userdata});
+        }
+    }
+
+    for (u64 i = 0; i < 300; i += 4) {
+        CoreTiming::UnscheduleEvent(cb_a, i);
+    }
+    CoreTiming::UnscheduleEvent(cb_a, 12345); // Not scheduled
+    CoreTiming::RemoveEvent(cb_b);
+
+    std::sort(expected.begin(), expected.end(), [](const Expected& a, const Expected& b) {
+        return std::tie(a.time, a.order) < std::tie(b.time, b.order);
+    });
+
+    fired.clear();
+    for (int slice = 0; slice < 1000; ++slice) {
+        CoreTiming::AddTicks(CoreTiming::GetDowncount());
+        CoreTiming::Advance();
+    }
+
+    REQUIRE(fired.size() == expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE(fired[i] == expected[i].userdata);
+    }
+    REQUIRE(MAX_SLICE_LENGTH == CoreTiming::GetDowncount());
+}
+
+TEST_CASE("CoreTiming[AdaptiveSlicing]", "[core]") {
+    ScopeInit guard;
+
+    CoreTiming::EventType* cb_a = CoreTiming::RegisterEvent("callbackA", CallbackTemplate<0>);
+    CoreTiming::SetAdaptiveSlicing(true);
+
+    // Enter slice 0
+    CoreTiming::Advance();
+    REQUIRE(MAX_SLICE_LENGTH == CoreTiming::GetDowncount());
+
+    // Slices that run to the maximum length lengthen the next ones, up to 16 times
+    for (int max_slice_length : {2, 4, 8, 16, 16}) {
+        CoreTiming::AddTicks(CoreTiming::GetDowncount());
+        CoreTiming::Advance();
+        REQUIRE(max_slice_length * MAX_SLICE_LENGTH == CoreTiming::GetMaxSliceLength());
+        REQUIRE(max_slice_length * MAX_SLICE_LENGTH == CoreTiming::GetDowncount());
+    }
+
+    // Slices cut short by a reschedule shorten the next ones
+    CoreTiming::AddTicks(100);
+    CoreTiming::Advance();
+    REQUIRE(8 * MAX_SLICE_LENGTH == CoreTiming::GetDowncount());
+
+    // So do events coming from other threads
+    CoreTiming::ScheduleEventThreadsafe(100 * MAX_SLICE_LENGTH, cb_a, CB_IDS[0]);
+    CoreTiming::AddTicks(CoreTiming::GetDowncount());
+    CoreTiming::Advance();
+    REQUIRE(4 * MAX_SLICE_LENGTH == CoreTiming::GetDowncount());
+
+    // Slices that end at an event leave the length alone
+    CoreTiming::ScheduleEvent(1000, cb_a, CB_IDS[1]);
+    REQUIRE(1000 == CoreTiming::GetDowncount());
+    CoreTiming::UnscheduleEvent(cb_a, CB_IDS[1]);
+    CoreTiming::AddTicks(CoreTiming::GetDowncount());
+    CoreTiming::Advance();
+    REQUIRE(4 * MAX_SLICE_LENGTH == CoreTiming::GetMaxSliceLength());
+
+    // Down to 8 times shorter
+    for (int i = 0; i < 8; ++i) {
+        CoreTiming::AddTicks(100);
+        CoreTiming::Advance();
+    }
+    REQUIRE(MAX_SLICE_LENGTH / 8 == CoreTiming::GetDowncount());
+
+    const CoreTiming::SliceStats stats = CoreTiming::GetSliceStats();
+    REQUIRE(stats.num_slices == 17);
+    REQUIRE(stats.total_cycles == CoreTiming::GetTicks());
+
+    CoreTiming::SetAdaptiveSlicing(false);
+    REQUIRE(MAX_SLICE_LENGTH == CoreTiming::GetMaxSliceLength());
+}
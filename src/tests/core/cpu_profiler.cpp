@@ -0,0 +1,52 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch.hpp>
+
+#include <string>
+#include <vector>
+#include "core/cpu_profiler.h"
+
+TEST_CASE("CPUProfiler: symbolized reports", "[core]") {
+    Core::CPUProfiler profiler;
+    profiler.SetSymbols({
+        {0x00100200, 0x100, "Update"}, {0x00100000, 0x80, "Main"}, {0x00100300, 0, "Draw"},
+    });
+
+    for (int i = 0; i < 6; ++i)
+        profiler.AddSample(0x00100210, 0x00100010); // Update, called from Main
+    for (int i = 0; i < 3; ++i)
+        profiler.AddSample(0x00100240, 0x00100010); // Update, called from Main
+    profiler.AddSample(0x00100400, 0x00100220); // Draw (unknown size), called from Update
+    profiler.AddSample(0x00100100, 0x00000000); // Between Main and Update
+    profiler.AddIdleSample();
+    REQUIRE(profiler.GetSampleCount() == 12);
+
+    const std::string report = profiler.GetFlatReport(0x0004000000033500);
+    REQUIRE(report.find("CPU profile of title 0004000000033500") != std::string::npos);
+    REQUIRE(report.find("12 samples, 1 idle (8.33%)") != std::string::npos);
+    REQUIRE(report.find("        9   75.00%  Update\n") != std::string::npos);
+    REQUIRE(report.find("        6   50.00%  0x00100210  Update+0x10\n") != std::string::npos);
+    REQUIRE(report.find("        1    8.33%  0x00100400  Draw+0x100\n") != std::string::npos);
+    REQUIRE(report.find("        1    8.33%  0x00100100  \n") != std::string::npos);
+
+    // Functions are listed before the blocks, hottest first
+    REQUIRE(report.find("Update\n") < report.find("Draw\n"));
+    REQUIRE(report.find("Draw\n") < report.find("Blocks:"));
+
+    REQUIRE(profiler.GetCollapsedStacks() == "0x00000000;0x00100100 1\n"
+                                             "Main;Update 9\n"
+                                             "Update;Draw 1\n"
+                                             "[idle] 1\n");
+}
+
+TEST_CASE("CPUProfiler: reports without symbols", "[core]") {
+    Core::CPUProfiler profiler;
+    profiler.AddSample(0x00100000, 0x00200000);
+
+    const std::string report = profiler.GetFlatReport(0);
+    REQUIRE(report.find("Functions:") == std::string::npos);
+    REQUIRE(report.find("      1  100.00%  0x00100000  \n") != std::string::npos);
+    REQUIRE(profiler.GetCollapsedStacks() == "0x00200000;0x00100000 1\n");
+}
@@ -0,0 +1,42 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch.hpp>
+#include "core/hle/kernel/errors.h"
+#include "core/hle/kernel/event.h"
+#include "core/hle/kernel/handle_table.h"
+#include "core/hle/kernel/server_session.h"
+
+namespace Kernel {
+
+TEST_CASE("HandleTable", "[core][kernel]") {
+    HandleTable handle_table;
+    const size_t num_events = Event::GetNumAllocated();
+
+    Handle handle = handle_table.Create(Event::Create(ResetType::OneShot)).Unwrap();
+    REQUIRE(Event::GetNumAllocated() == num_events + 1);
+    REQUIRE(handle_table.Get<Event>(handle) != nullptr);
+    REQUIRE(handle_table.Get<ServerSession>(handle) == nullptr);
+
+    Handle duplicate = handle_table.Duplicate(handle).Unwrap();
+    REQUIRE(handle_table.GetGeneric(duplicate) == handle_table.GetGeneric(handle));
+
+    REQUIRE(handle_table.Close(handle) == RESULT_SUCCESS);
+    REQUIRE(!handle_table.IsValid(handle));
+    REQUIRE(handle_table.Close(handle) == ERR_INVALID_HANDLE);
+    REQUIRE(Event::GetNumAllocated() == num_events + 1);
+
+    // The freed slot is reused with another generation
+    Handle reused = handle_table.Create(Event::Create(ResetType::OneShot)).Unwrap();
+    REQUIRE(reused != handle);
+    REQUIRE((reused >> 15) == (handle >> 15));
+    REQUIRE(!handle_table.IsValid(handle));
+
+    handle_table.Clear();
+    REQUIRE(!handle_table.IsValid(duplicate));
+    REQUIRE(!handle_table.IsValid(reused));
+    REQUIRE(Event::GetNumAllocated() == num_events);
+}
+
+} // namespace Kernel
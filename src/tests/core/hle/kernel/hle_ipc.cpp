@@ -131,7 +131,9 @@ TEST_CASE("HLERequestContext::PopulateFromIncomingCommandBuffer", "[core][kernel
 
         context.PopulateFromIncomingCommandBuffer(input, *process, handle_table);
 
-        CHECK(context.GetStaticBuffer(0) == *buffer);
+        CHECK(context.GetStaticBuffer(0).ToVector() == *buffer);
+        // The buffer is contiguous, so it is viewed in place
+        CHECK(context.GetStaticBuffer(0).data() == buffer->data());
 
         REQUIRE(process->vm_manager.UnmapRange(target_address, buffer->size()) == RESULT_SUCCESS);
     }
@@ -197,7 +199,7 @@ TEST_CASE("HLERequestContext::PopulateFromIncomingCommandBuffer", "[core][kernel
         CHECK(output[2] == 0xABCDEF00);
         CHECK(context.GetIncomingHandle(output[4]) == a);
         CHECK(output[6] == process->process_id);
-        CHECK(context.GetStaticBuffer(0) == *buffer_static);
+        CHECK(context.GetStaticBuffer(0).ToVector() == *buffer_static);
         std::vector<u8> other_buffer(buffer_mapped->size());
         context.GetMappedBuffer(0).Read(other_buffer.data(), 0, buffer_mapped->size());
         CHECK(other_buffer == *buffer_mapped);
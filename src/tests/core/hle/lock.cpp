@@ -0,0 +1,47 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <thread>
+#include <catch.hpp>
+#include "core/hle/lock.h"
+
+namespace HLE {
+
+static std::atomic<int> num_waits{0};
+
+static void CountingWait(std::recursive_mutex& mutex) {
+    ++num_waits;
+    mutex.lock();
+}
+
+TEST_CASE("ProfiledMutex", "[core][hle]") {
+    ProfiledMutex mutex(CountingWait);
+    num_waits = 0;
+
+    SECTION("is recursive and only waits when contended") {
+        std::lock_guard<ProfiledMutex> outer(mutex);
+        std::lock_guard<ProfiledMutex> inner(mutex);
+        REQUIRE(num_waits == 0);
+    }
+
+    SECTION("waits for the holding thread") {
+        mutex.lock();
+        std::atomic<bool> acquired{false};
+        std::thread waiter([&] {
+            std::lock_guard<ProfiledMutex> lock(mutex);
+            acquired = true;
+        });
+        while (num_waits == 0) {
+            std::this_thread::yield();
+        }
+        REQUIRE(!acquired);
+        mutex.unlock();
+        waiter.join();
+        REQUIRE(acquired);
+        REQUIRE(num_waits == 1);
+    }
+}
+
+} // namespace HLE
@@ -0,0 +1,109 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+#include <catch.hpp>
+#include "core/core_timing.h"
+#include "core/hle/ipc.h"
+#include "core/hle/ipc_helpers.h"
+#include "core/hle/kernel/client_port.h"
+#include "core/hle/kernel/client_session.h"
+#include "core/hle/kernel/hle_ipc.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/kernel/server_session.h"
+#include "core/hle/kernel/thread.h"
+#include "core/hle/service/service.h"
+#include "core/memory.h"
+#include "core/settings.h"
+
+namespace Service {
+
+/// Writes the reply of the test request: two normal words and one static buffer
+static void WriteReply(Kernel::HLERequestContext& ctx, const std::vector<u8>& buffer) {
+    IPC::RequestBuilder rb(ctx, 0x1234, 2, 2);
+    rb.Push(RESULT_SUCCESS);
+    rb.Push<u32>(0xABCDEF00);
+    rb.PushStaticBuffer(buffer, 0);
+}
+
+TEST_CASE("RunAsync", "[core][service]") {
+    CoreTiming::Init();
+    Kernel::Init(0);
+
+    auto process = Kernel::Process::Create(Kernel::CodeSet::Create("", 0));
+    Kernel::g_current_process = process;
+    auto session = std::get<Kernel::SharedPtr<Kernel::ServerSession>>(
+        Kernel::ServerSession::CreateSessionPair());
+    Kernel::HLERequestContext context(std::move(session));
+    context.CommandBuffer()[0] = IPC::MakeHeader(0x1234, 0, 0);
+
+    std::vector<u8> reply_buffer(0x40);
+    std::fill(reply_buffer.begin(), reply_buffer.end(), 0xAB);
+
+    SECTION("runs the request right away when async requests are disabled") {
+        Settings::values.use_async_service_requests = false;
+
+        bool work_done = false;
+        RunAsync(context, "test", [&work_done] { work_done = true; },
+                 [&](Kernel::HLERequestContext& ctx) {
+                     REQUIRE(work_done);
+                     WriteReply(ctx, reply_buffer);
+                 });
+
+        CHECK(!context.IsReplyDeferred());
+        const u32* cmd_buf = context.CommandBuffer();
+        CHECK(cmd_buf[0] == IPC::MakeHeader(0x1234, 2, 2));
+        CHECK(cmd_buf[1] == RESULT_SUCCESS.raw);
+        CHECK(cmd_buf[2] == 0xABCDEF00);
+        CHECK(cmd_buf[3] == IPC::StaticBufferDesc(reply_buffer.size(), 0));
+    }
+
+    SECTION("writes the deferred reply to the command buffer of the thread") {
+        // The thread is only created for its TLS, it doesn't run
+        constexpr VAddr code_address = 0x00100000;
+        auto code = std::make_shared<std::vector<u8>>(Memory::PAGE_SIZE);
+        REQUIRE(process->vm_manager
+                    .MapMemoryBlock(code_address, code, 0, code->size(),
+                                    Kernel::MemoryState::Code)
+                    .Code() == RESULT_SUCCESS);
+        auto thread = Kernel::Thread::Create("test", code_address, THREADPRIO_DEFAULT, 0,
+                                             THREADPROCESSORID_0, Memory::HEAP_VADDR_END,
+                                             process)
+                          .Unwrap();
+
+        // The static buffer the requesting thread receives the buffer in
+        constexpr VAddr target_address = 0x10000000;
+        auto target_buffer = std::make_shared<std::vector<u8>>(Memory::PAGE_SIZE);
+        REQUIRE(process->vm_manager
+                    .MapMemoryBlock(target_address, target_buffer, 0, target_buffer->size(),
+                                    Kernel::MemoryState::Private)
+                    .Code() == RESULT_SUCCESS);
+        const std::array<u32, 2> static_buffer_desc{
+            {IPC::StaticBufferDesc(target_buffer->size(), 0), target_address}};
+        const VAddr cmd_buf_address = thread->GetCommandBufferAddress();
+        Memory::WriteBlock(*process, cmd_buf_address + IPC::COMMAND_BUFFER_LENGTH * sizeof(u32),
+                           static_buffer_desc.data(), sizeof(static_buffer_desc));
+
+        WriteReply(context, reply_buffer);
+        WriteDeferredReply(context, *thread);
+
+        std::array<u32, 5> cmd_buf;
+        Memory::ReadBlock(*process, cmd_buf_address, cmd_buf.data(), sizeof(cmd_buf));
+        CHECK(cmd_buf[0] == IPC::MakeHeader(0x1234, 2, 2));
+        CHECK(cmd_buf[1] == RESULT_SUCCESS.raw);
+        CHECK(cmd_buf[2] == 0xABCDEF00);
+        CHECK(cmd_buf[3] == IPC::StaticBufferDesc(reply_buffer.size(), 0));
+        CHECK(cmd_buf[4] == target_address);
+        CHECK(std::equal(reply_buffer.begin(), reply_buffer.end(), target_buffer->begin()));
+    }
+
+    Kernel::Shutdown();
+    CoreTiming::Shutdown();
+}
+
+} // namespace Service
@@ -3,9 +3,14 @@
 // Refer to the license.txt file included.
 
 #include <catch.hpp>
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <vector>
 #include "core/hle/kernel/memory.h"
 #include "core/hle/kernel/process.h"
 #include "core/memory.h"
+#include "core/memory_setup.h"
 
 TEST_CASE("Memory::IsValidVirtualAddress", "[core][memory]") {
     SECTION("these regions should not be mapped on an empty process") {
@@ -54,3 +59,143 @@ TEST_CASE("Memory::IsValidVirtualAddress", "[core][memory]") {
         CHECK(Memory::IsValidVirtualAddress(*process, Memory::CONFIG_MEMORY_VADDR) == false);
     }
 }
+
+class ValidityTestMMIO : public Memory::MMIORegion {
+public:
+    explicit ValidityTestMMIO(bool valid) : valid(valid) {}
+
+    bool IsValidAddress(VAddr addr) override {
+        return valid;
+    }
+
+    u8 Read8(VAddr addr) override {
+        return 0;
+    }
+    u16 Read16(VAddr addr) override {
+        return 0;
+    }
+    u32 Read32(VAddr addr) override {
+        return 0;
+    }
+    u64 Read64(VAddr addr) override {
+        return 0;
+    }
+    bool ReadBlock(VAddr src_addr, void* dest_buffer, size_t size) override {
+        return false;
+    }
+    void Write8(VAddr addr, u8 data) override {}
+    void Write16(VAddr addr, u16 data) override {}
+    void Write32(VAddr addr, u32 data) override {}
+    void Write64(VAddr addr, u64 data) override {}
+    bool WriteBlock(VAddr dest_addr, const void* src_buffer, size_t size) override {
+        return false;
+    }
+
+private:
+    bool valid;
+};
+
+TEST_CASE("Memory: MMIO handler lookup", "[core][memory]") {
+    auto process = Kernel::Process::Create(Kernel::CodeSet::Create("", 0));
+    auto& page_table = process->vm_manager.page_table;
+    auto valid = std::make_shared<ValidityTestMMIO>(true);
+    auto invalid = std::make_shared<ValidityTestMMIO>(false);
+    constexpr VAddr base = Memory::IO_AREA_VADDR;
+
+    Memory::MapIoRegion(page_table, base, 4 * Memory::PAGE_SIZE, valid);
+    Memory::MapIoRegion(page_table, base + Memory::PAGE_SIZE, Memory::PAGE_SIZE, invalid);
+    CHECK(Memory::IsValidVirtualAddress(*process, base) == true);
+    CHECK(Memory::IsValidVirtualAddress(*process, base + Memory::PAGE_SIZE) == false);
+    CHECK(Memory::IsValidVirtualAddress(*process, base + 2 * Memory::PAGE_SIZE) == true);
+
+    // The latest mapping of a page wins, and handlers are not stored twice
+    Memory::MapIoRegion(page_table, base + Memory::PAGE_SIZE, Memory::PAGE_SIZE, valid);
+    CHECK(Memory::IsValidVirtualAddress(*process, base + Memory::PAGE_SIZE) == true);
+    CHECK(page_table.special_regions.size() == 2);
+
+    Memory::UnmapRegion(page_table, base, 4 * Memory::PAGE_SIZE);
+    CHECK(Memory::IsValidVirtualAddress(*process, base) == false);
+}
+
+TEST_CASE("Memory::GetPhysicalPointer/PhysicalToVirtualAddress", "[core][memory]") {
+    SECTION("fixed memory areas") {
+        u8* vram = Memory::GetPhysicalPointer(Memory::VRAM_PADDR);
+        REQUIRE(vram != nullptr);
+        CHECK(Memory::GetPhysicalPointer(Memory::VRAM_PADDR + 0x1234) == vram + 0x1234);
+        CHECK(Memory::GetPhysicalPointer(Memory::VRAM_PADDR_END) == nullptr);
+        CHECK(Memory::GetPhysicalPointer(Memory::IO_AREA_PADDR) == nullptr);
+        CHECK(Memory::GetPhysicalPointer(Memory::DSP_RAM_PADDR) != nullptr);
+
+        CHECK(Memory::PhysicalToVirtualAddress(Memory::VRAM_PADDR + 0x1234).value_or(0) ==
+              Memory::VRAM_VADDR + 0x1234);
+        CHECK(Memory::PhysicalToVirtualAddress(Memory::IO_AREA_PADDR + 0x10).value_or(0) ==
+              Memory::IO_AREA_VADDR + 0x10);
+        CHECK(Memory::PhysicalToVirtualAddress(Memory::DSP_RAM_PADDR_END - 1).value_or(0) ==
+              Memory::DSP_RAM_VADDR_END - 1);
+        CHECK(!Memory::PhysicalToVirtualAddress(Memory::AXI_WRAM_PADDR));
+        CHECK(!Memory::PhysicalToVirtualAddress(0xF0000000));
+    }
+
+    SECTION("FCRAM follows the kernel memory regions") {
+        CHECK(Memory::GetPhysicalPointer(Memory::FCRAM_PADDR) == nullptr);
+
+        Kernel::MemoryInit(0);
+        const auto& system_region = *Kernel::GetMemoryRegion(Kernel::MemoryRegion::SYSTEM);
+        CHECK(Memory::GetPhysicalPointer(Memory::FCRAM_PADDR + system_region.base + 0x10) ==
+              system_region.linear_heap_memory->data() + 0x10);
+
+        Kernel::g_current_process = Kernel::Process::Create(Kernel::CodeSet::Create("", 0));
+        CHECK(Memory::PhysicalToVirtualAddress(Memory::FCRAM_PADDR + 0x10).value_or(0) ==
+              Memory::LINEAR_HEAP_VADDR + 0x10);
+        Kernel::g_current_process = nullptr;
+
+        Kernel::MemoryShutdown();
+        CHECK(Memory::GetPhysicalPointer(Memory::FCRAM_PADDR + system_region.base) == nullptr);
+    }
+}
+
+TEST_CASE("Memory::ReadBlock/WriteBlock across pages", "[core][memory]") {
+    auto process = Kernel::Process::Create(Kernel::CodeSet::Create("", 0));
+    constexpr VAddr base = Memory::HEAP_VADDR;
+    constexpr u32 size = 4 * Memory::PAGE_SIZE;
+
+    // The first two pages share a block, the next two are backed by separate blocks, so the copies
+    // have to be split where the host memory is not contiguous.
+    auto first_block = std::make_shared<std::vector<u8>>(2 * Memory::PAGE_SIZE);
+    auto third_block = std::make_shared<std::vector<u8>>(Memory::PAGE_SIZE);
+    auto fourth_block = std::make_shared<std::vector<u8>>(Memory::PAGE_SIZE);
+    auto& vm_manager = process->vm_manager;
+    vm_manager.MapMemoryBlock(base, first_block, 0, 2 * Memory::PAGE_SIZE,
+                              Kernel::MemoryState::Private);
+    vm_manager.MapMemoryBlock(base + 2 * Memory::PAGE_SIZE, third_block, 0, Memory::PAGE_SIZE,
+                              Kernel::MemoryState::Private);
+    vm_manager.MapMemoryBlock(base + 3 * Memory::PAGE_SIZE, fourth_block, 0, Memory::PAGE_SIZE,
+                              Kernel::MemoryState::Private);
+
+    std::vector<u8> data(size - 0x20);
+    std::iota(data.begin(), data.end(), u8{1});
+    Memory::WriteBlock(*process, base + 0x10, data.data(), data.size());
+
+    REQUIRE((*first_block)[0x0F] == 0);
+    REQUIRE((*first_block)[0x10] == 1);
+    REQUIRE((*third_block)[0] == static_cast<u8>(2 * Memory::PAGE_SIZE - 0x10 + 1));
+    REQUIRE((*fourth_block)[0] == static_cast<u8>(3 * Memory::PAGE_SIZE - 0x10 + 1));
+
+    std::vector<u8> read_back(data.size());
+    Memory::ReadBlock(*process, base + 0x10, read_back.data(), read_back.size());
+    REQUIRE(read_back == data);
+
+    // From contiguous pages to pages that are not
+    constexpr u32 copy_size = Memory::PAGE_SIZE + 0x100;
+    Memory::CopyBlock(*process, base + 0x2100, base + 0x10, copy_size);
+    Memory::ReadBlock(*process, base + 0x2100, read_back.data(), copy_size);
+    REQUIRE(std::equal(data.begin(), data.begin() + copy_size, read_back.begin()));
+
+    Memory::ZeroBlock(*process, base + 0x800, 2 * Memory::PAGE_SIZE);
+    std::vector<u8> contents(size);
+    Memory::ReadBlock(*process, base, contents.data(), contents.size());
+    REQUIRE(contents[0x7FF] == data[0x7FF - 0x10]);
+    REQUIRE(std::all_of(contents.begin() + 0x800, contents.begin() + 0x2800,
+                        [](u8 value) { return value == 0; }));
+    REQUIRE(contents[0x2800] == data[0x2800 - 0x2100]);
+}
@@ -0,0 +1,51 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <catch.hpp>
+#include "common/common_types.h"
+#include "common/hash.h"
+#include "video_core/shader/shader.h"
+
+using Pica::Shader::ShaderSetup;
+
+static u64 HashFromScratch(const ShaderSetup& setup) {
+    auto copy = std::make_unique<ShaderSetup>();
+    for (unsigned i = 0; i < setup.program_code.size(); ++i) {
+        copy->WriteProgramCode(i, setup.program_code[i]);
+    }
+    for (unsigned i = 0; i < setup.swizzle_data.size(); ++i) {
+        copy->WriteSwizzleData(i, setup.swizzle_data[i]);
+    }
+    return copy->GetProgramHash();
+}
+
+TEST_CASE("ShaderSetup::GetProgramHash", "[video_core][shader]") {
+    auto setup = std::make_unique<ShaderSetup>();
+    const u64 empty_hash = setup->GetProgramHash();
+
+    setup->WriteProgramCode(0, 0);
+    setup->WriteSwizzleData(4095, 0);
+    REQUIRE(setup->GetProgramHash() == empty_hash);
+
+    setup->WriteProgramCode(100, 0x12345678);
+    const u64 code_hash = setup->GetProgramHash();
+    REQUIRE(code_hash != empty_hash);
+    REQUIRE(code_hash == HashFromScratch(*setup));
+
+    SECTION("changes with the swizzle data") {
+        setup->WriteSwizzleData(100, 0x12345678);
+        REQUIRE(setup->GetProgramHash() != code_hash);
+        REQUIRE(setup->GetProgramHash() == HashFromScratch(*setup));
+    }
+
+    SECTION("returns to previous values when the data does") {
+        setup->WriteProgramCode(4095, 1);
+        REQUIRE(setup->GetProgramHash() != code_hash);
+        setup->WriteProgramCode(4095, 0);
+        REQUIRE(setup->GetProgramHash() == code_hash);
+        setup->WriteProgramCode(100, 0);
+        REQUIRE(setup->GetProgramHash() == empty_hash);
+    }
+}
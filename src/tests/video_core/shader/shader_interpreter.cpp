@@ -0,0 +1,344 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <catch.hpp>
+#include <nihstro/shader_bytecode.h>
+#include "common/common_types.h"
+#include "video_core/shader/shader.h"
+#include "video_core/shader/shader_interpreter.h"
+
+using nihstro::Instruction;
+using nihstro::OpCode;
+using Pica::Shader::InterpreterEngine;
+using Pica::Shader::ShaderSetup;
+using Pica::Shader::UnitState;
+
+using CompareOp = Instruction::Common::CompareOpType;
+using CompareOpId = decltype(CompareOp::Equal);
+using FlowOp = Instruction::FlowControlType::Op;
+
+// Register numbers as encoded in source and destination operands
+static constexpr u32 INPUT = 0x00;
+static constexpr u32 TEMP = 0x10;
+static constexpr u32 UNIFORM = 0x20;
+static constexpr u32 OUTPUT = 0x00;
+
+static u32 Op(OpCode::Id op) {
+    return static_cast<u32>(op) << 26;
+}
+
+/// Encodes an arithmetic instruction. Only src1 can be a uniform.
+static u32 Arith(OpCode::Id op, u32 dest, u32 src1, u32 src2, u32 desc, u32 address_index = 0) {
+    return Op(op) | dest << 21 | address_index << 19 | src1 << 12 | src2 << 7 | desc;
+}
+
+/// Encodes an arithmetic instruction with inverted sources. Only src2 can be a uniform.
+static u32 ArithI(OpCode::Id op, u32 dest, u32 src1, u32 src2, u32 desc, u32 address_index = 0) {
+    return Op(op) | dest << 21 | address_index << 19 | src1 << 14 | src2 << 7 | desc;
+}
+
+static u32 Cmp(u32 src1, u32 src2, u32 desc, CompareOpId x, CompareOpId y) {
+    return Op(OpCode::Id::CMP) | static_cast<u32>(x) << 24 | static_cast<u32>(y) << 21 |
+           src1 << 12 | src2 << 7 | desc;
+}
+
+/// Encodes a MAD instruction. Only src2 can be a uniform, or src3 for MADI.
+static u32 Mad(OpCode::Id op, u32 dest, u32 src1, u32 src2, u32 src3, u32 desc,
+               u32 address_index = 0) {
+    const bool inverted = (op == OpCode::Id::MADI);
+    return Op(op) | dest << 24 | address_index << 22 | src1 << 17 |
+           src2 << (inverted ? 12 : 10) | src3 << 5 | desc;
+}
+
+static u32 Flow(OpCode::Id op, u32 dest_offset, u32 num_instructions) {
+    return Op(op) | dest_offset << 10 | num_instructions;
+}
+
+/// Encodes an instruction depending on the conditional codes
+static u32 CondFlow(OpCode::Id op, FlowOp condition, bool refx, bool refy, u32 dest_offset,
+                    u32 num_instructions) {
+    return Flow(op, dest_offset, num_instructions) | refx << 25 | refy << 24 |
+           static_cast<u32>(condition) << 22;
+}
+
+/// Encodes an instruction depending on a bool uniform, or looping over an int uniform
+static u32 UniformFlow(OpCode::Id op, u32 uniform, u32 dest_offset, u32 num_instructions) {
+    return Flow(op, dest_offset, num_instructions) | uniform << 22;
+}
+
+/**
+ * Encodes an operand descriptor.
+ * @param dest_mask Enabled destination components, e.g. "xz"
+ * @param src1 Swizzle of the first source, e.g. "wzyx", or "-wzyx" to negate it
+ */
+static u32 Desc(const char* dest_mask, const char* src1 = "xyzw", const char* src2 = "xyzw",
+                const char* src3 = "xyzw") {
+    auto component = [](char c) -> u32 { return c == 'w' ? 3 : c - 'x'; };
+
+    u32 desc = 0;
+    for (const char* c = dest_mask; *c != '\0'; ++c)
+        desc |= 0x8 >> component(*c);
+
+    const char* sources[] = {src1, src2, src3};
+    const unsigned shifts[] = {4, 13, 22};
+    for (int i = 0; i < 3; ++i) {
+        const char* swizzle = sources[i];
+        if (*swizzle == '-') {
+            desc |= 1 << shifts[i];
+            ++swizzle;
+        }
+        for (int j = 0; j < 4; ++j)
+            desc |= component(swizzle[j]) << (shifts[i] + 1 + 2 * (3 - j));
+    }
+    return desc;
+}
+
+static Pica::float24 F(float value) {
+    return Pica::float24::FromFloat32(value);
+}
+
+static bool SameBits(const Math::Vec4<Pica::float24>& a, const Math::Vec4<Pica::float24>& b) {
+    return std::memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+/// Runs the program on 7 units, one at a time and as a batch, and compares the results
+static void CheckBatchMatchesRun(ShaderSetup& setup, const std::vector<u32>& program,
+                                 const std::vector<u32>& swizzles) {
+    std::copy(program.begin(), program.end(), setup.program_code.begin());
+    std::copy(swizzles.begin(), swizzles.end(), setup.swizzle_data.begin());
+
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float inf = std::numeric_limits<float>::infinity();
+    const std::array<Math::Vec4<Pica::float24>, 7> inputs0{{
+        {F(2.5f), F(-1.f), F(0.f), F(3.f)},
+        {F(-0.75f), F(4.f), F(1.f), F(-2.f)},
+        {F(0.f), F(-0.f), F(inf), F(0.5f)},
+        {F(5.f), F(nan), F(-3.5f), F(1.f)},
+        {F(-4.f), F(2.f), F(2.f), F(-inf)},
+        {F(1.f), F(0.25f), F(-1.f), F(6.f)},
+        {F(3.f), F(-8.f), F(0.125f), F(0.f)},
+    }};
+    const std::array<Math::Vec4<Pica::float24>, 7> inputs1{{
+        {F(0.f), F(1.f), F(nan), F(-1.f)},
+        {F(1.f), F(-inf), F(2.f), F(0.f)},
+        {F(2.f), F(0.5f), F(-0.f), F(inf)},
+        {F(1.f), F(3.f), F(1.f), F(-7.f)},
+        {F(0.f), F(0.f), F(4.f), F(2.f)},
+        {F(2.f), F(nan), F(0.f), F(-0.5f)},
+        {F(1.f), F(1.f), F(-2.f), F(9.f)},
+    }};
+
+    std::vector<UnitState> expected(inputs0.size());
+    std::vector<UnitState> actual(inputs0.size());
+    for (size_t i = 0; i < inputs0.size(); ++i) {
+        for (auto& unit : {&expected[i], &actual[i]}) {
+            std::memset(&unit->registers, 0, sizeof(unit->registers));
+            unit->registers.input[0] = inputs0[i];
+            unit->registers.input[1] = inputs1[i];
+            // Small integers, to use as address offsets
+            unit->registers.input[2] = {F(static_cast<float>(i % 3)),
+                                        F(static_cast<float>(i % 2) - 1.f), F(0.f),
+                                        F(static_cast<float>(i))};
+            std::fill(std::begin(unit->address_registers), std::end(unit->address_registers), 0);
+        }
+    }
+
+    InterpreterEngine engine;
+    engine.SetupBatch(setup, 0);
+    for (auto& unit : expected)
+        engine.Run(setup, unit);
+    engine.RunBatch(setup, actual.data(), static_cast<unsigned>(actual.size()));
+
+    for (size_t i = 0; i < expected.size(); ++i) {
+        INFO("unit " << i);
+        for (int reg = 0; reg < 16; ++reg) {
+            INFO("register " << reg);
+            CHECK(SameBits(expected[i].registers.output[reg], actual[i].registers.output[reg]));
+            CHECK(SameBits(expected[i].registers.temporary[reg],
+                           actual[i].registers.temporary[reg]));
+        }
+        CHECK(expected[i].conditional_code[0] == actual[i].conditional_code[0]);
+        CHECK(expected[i].conditional_code[1] == actual[i].conditional_code[1]);
+        for (int reg = 0; reg < 3; ++reg)
+            CHECK(expected[i].address_registers[reg] == actual[i].address_registers[reg]);
+    }
+}
+
+TEST_CASE("InterpreterEngine::RunBatch", "[video_core][shader]") {
+    using Id = OpCode::Id;
+
+    auto setup = std::make_unique<ShaderSetup>();
+    std::memset(&setup->uniforms, 0, sizeof(setup->uniforms));
+    setup->uniforms.f[0] = {F(0.5f), F(-2.f), F(3.f), F(0.25f)};
+    setup->uniforms.f[1] = {F(std::numeric_limits<float>::infinity()), F(0.f), F(-0.f), F(1.f)};
+    setup->uniforms.f[2] = {F(-1.f), F(-1.f), F(-1.f), F(-1.f)};
+    setup->uniforms.f[3] = {F(10.f), F(20.f), F(30.f), F(40.f)};
+    setup->uniforms.f[4] = {F(100.f), F(200.f), F(300.f), F(400.f)};
+    setup->uniforms.f[5] = {F(1000.f), F(2000.f), F(3000.f), F(4000.f)};
+    setup->uniforms.b[0] = true;
+    setup->uniforms.b[1] = false;
+    setup->uniforms.i[0] = {3, 1, 2, 0};
+
+    SECTION("arithmetic instructions") {
+        const std::vector<u32> swizzles = {
+            Desc("xyzw"),
+            Desc("x"),
+            Desc("y", "wzyx", "-xxyy"),
+            Desc("zw", "-yzwx", "yyxx"),
+            Desc("xyzw", "-wzyx"),
+            Desc("xy", "zwxy", "xyzw", "-wwzz"),
+        };
+        CheckBatchMatchesRun(*setup,
+                             {
+                                 Arith(Id::ADD, TEMP + 0, INPUT + 0, INPUT + 1, 0),
+                                 Arith(Id::MUL, TEMP + 1, UNIFORM + 1, INPUT + 1, 4),
+                                 Arith(Id::DP4, OUTPUT + 0, INPUT + 0, TEMP + 0, 1),
+                                 Arith(Id::DP3, OUTPUT + 0, UNIFORM + 0, INPUT + 1, 2),
+                                 Arith(Id::DPH, OUTPUT + 0, INPUT + 0, INPUT + 1, 3),
+                                 Arith(Id::MAX, TEMP + 2, INPUT + 0, INPUT + 1, 0),
+                                 Arith(Id::MIN, TEMP + 3, INPUT + 1, INPUT + 0, 2),
+                                 Arith(Id::RCP, OUTPUT + 1, INPUT + 0, 0, 1),
+                                 Arith(Id::RSQ, OUTPUT + 1, INPUT + 1, 0, 2),
+                                 Arith(Id::EX2, OUTPUT + 1, INPUT + 0, 0, 3),
+                                 Arith(Id::LG2, OUTPUT + 2, INPUT + 1, 0, 0),
+                                 Arith(Id::FLR, OUTPUT + 3, INPUT + 0, 0, 4),
+                                 Arith(Id::SGE, OUTPUT + 4, INPUT + 0, INPUT + 1, 0),
+                                 Arith(Id::SLT, OUTPUT + 5, INPUT + 1, INPUT + 0, 3),
+                                 ArithI(Id::SGEI, OUTPUT + 6, INPUT + 0, UNIFORM + 0, 0),
+                                 ArithI(Id::SLTI, OUTPUT + 7, INPUT + 1, UNIFORM + 1, 2),
+                                 ArithI(Id::DPHI, OUTPUT + 7, INPUT + 0, UNIFORM + 0, 1),
+                                 Mad(Id::MAD, OUTPUT + 8, INPUT + 0, UNIFORM + 0, INPUT + 1, 5),
+                                 Mad(Id::MADI, OUTPUT + 9, INPUT + 1, INPUT + 0, UNIFORM + 1, 0),
+                                 Arith(Id::MOV, OUTPUT + 10, TEMP + 1, 0, 4),
+                                 Arith(Id::MOV, OUTPUT + 11, TEMP + 2, 0, 0),
+                                 Arith(Id::MOV, OUTPUT + 12, TEMP + 3, 0, 0),
+                                 Cmp(INPUT + 0, INPUT + 1, 0, CompareOp::LessEqual,
+                                     CompareOp::NotEqual),
+                                 Op(Id::END),
+                             },
+                             swizzles);
+    }
+
+    SECTION("divergent IFC") {
+        const std::vector<u32> swizzles = {Desc("xyzw"), Desc("x", "xxxx", "yyyy")};
+        CheckBatchMatchesRun(
+            *setup,
+            {
+                /* 0 */ Cmp(INPUT + 0, INPUT + 1, 0, CompareOp::LessThan, CompareOp::GreaterThan),
+                /* 1 */ CondFlow(Id::IFC, FlowOp::JustX, true, false, 6, 2),
+                /* 2 */ Arith(Id::MUL, OUTPUT + 0, UNIFORM + 3, INPUT + 0, 0),
+                /* 3 */ CondFlow(Id::IFC, FlowOp::JustY, true, false, 5, 0),
+                /* 4 */ Arith(Id::ADD, OUTPUT + 1, UNIFORM + 4, INPUT + 1, 0),
+                /* 5 */ Arith(Id::MOV, OUTPUT + 2, UNIFORM + 5, 0, 0),
+                /* 6 */ Arith(Id::ADD, OUTPUT + 0, UNIFORM + 2, INPUT + 1, 0),
+                /* 7 */ Cmp(INPUT + 1, INPUT + 0, 1, CompareOp::Equal, CompareOp::GreaterEqual),
+                /* 8 */ Arith(Id::MOV, OUTPUT + 3, INPUT + 0, 0, 1),
+                /* 9 */ Op(Id::END),
+            },
+            swizzles);
+    }
+
+    SECTION("loops of different lengths through JMPC") {
+        const std::vector<u32> swizzles = {Desc("xyzw"), Desc("x", "xxxx", "zzzz"),
+                                           Desc("xyzw", "wwww")};
+        CheckBatchMatchesRun(*setup,
+                             {
+                                 /* 0 */ Arith(Id::FLR, TEMP + 0, INPUT + 0, 0, 2),
+                                 /* 1 */ Arith(Id::ADD, TEMP + 0, UNIFORM + 2, TEMP + 0, 0),
+                                 /* 2 */ Arith(Id::ADD, TEMP + 1, UNIFORM + 3, TEMP + 1, 0),
+                                 /* 3 */ Cmp(TEMP + 0, INPUT + 2, 1, CompareOp::GreaterThan,
+                                             CompareOp::GreaterThan),
+                                 /* 4 */ CondFlow(Id::JMPC, FlowOp::JustX, true, false, 1, 0),
+                                 /* 5 */ Arith(Id::MOV, OUTPUT + 0, TEMP + 1, 0, 0),
+                                 /* 6 */ Op(Id::END),
+                             },
+                             swizzles);
+    }
+
+    SECTION("divergent CALLC and END") {
+        const std::vector<u32> swizzles = {Desc("xyzw")};
+        CheckBatchMatchesRun(
+            *setup,
+            {
+                /* 0 */ Cmp(INPUT + 0, INPUT + 1, 0, CompareOp::GreaterEqual, CompareOp::Equal),
+                /* 1 */ CondFlow(Id::CALLC, FlowOp::Or, true, true, 8, 2),
+                /* 2 */ Arith(Id::MOV, OUTPUT + 1, TEMP + 0, 0, 0),
+                /* 3 */ CondFlow(Id::JMPC, FlowOp::And, false, false, 6, 0),
+                /* 4 */ Arith(Id::MOV, OUTPUT + 2, UNIFORM + 4, 0, 0),
+                /* 5 */ Op(Id::END),
+                /* 6 */ Arith(Id::MOV, OUTPUT + 3, UNIFORM + 5, 0, 0),
+                /* 7 */ Op(Id::END),
+                /* 8 */ Arith(Id::MUL, TEMP + 0, INPUT + 0, INPUT + 0, 0),
+                /* 9 */ Flow(Id::CALL, 11, 1),
+                /* 10 */ Op(Id::NOP),
+                /* 11 */ Arith(Id::ADD, TEMP + 0, UNIFORM + 3, TEMP + 0, 0),
+                /* 12 */ Op(Id::END),
+            },
+            swizzles);
+    }
+
+    SECTION("uniform flow control") {
+        const std::vector<u32> swizzles = {Desc("xyzw")};
+        CheckBatchMatchesRun(*setup,
+                             {
+                                 /* 0 */ UniformFlow(Id::IFU, 0, 2, 1),
+                                 /* 1 */ Arith(Id::MOV, OUTPUT + 0, UNIFORM + 3, 0, 0),
+                                 /* 2 */ Arith(Id::MOV, OUTPUT + 1, UNIFORM + 4, 0, 0),
+                                 /* 3 */ UniformFlow(Id::CALLU, 1, 9, 1),
+                                 /* 4 */ UniformFlow(Id::CALLU, 0, 9, 1),
+                                 /* 5 */ UniformFlow(Id::JMPU, 1, 7, 0),
+                                 /* 6 */ Arith(Id::MOV, OUTPUT + 2, UNIFORM + 5, 0, 0),
+                                 /* 7 */ Arith(Id::MOV, OUTPUT + 3, INPUT + 0, 0, 0),
+                                 /* 8 */ Op(Id::END),
+                                 /* 9 */ Arith(Id::ADD, TEMP + 0, INPUT + 1, TEMP + 0, 0),
+                                 /* 10 */ Op(Id::END),
+                             },
+                             swizzles);
+    }
+
+    SECTION("divergent IFC inside a CALLU") {
+        const std::vector<u32> swizzles = {Desc("xyzw"), Desc("x", "xxxx", "yyyy")};
+        CheckBatchMatchesRun(
+            *setup,
+            {
+                /* 0 */ Cmp(INPUT + 0, INPUT + 1, 0, CompareOp::LessThan, CompareOp::GreaterThan),
+                /* 1 */ UniformFlow(Id::CALLU, 0, 4, 5),
+                /* 2 */ Arith(Id::MOV, OUTPUT + 3, INPUT + 0, 0, 0),
+                /* 3 */ Op(Id::END),
+                /* 4 */ CondFlow(Id::IFC, FlowOp::JustX, true, false, 7, 1),
+                /* 5 */ Arith(Id::MUL, OUTPUT + 0, UNIFORM + 3, INPUT + 0, 0),
+                /* 6 */ Arith(Id::ADD, OUTPUT + 1, UNIFORM + 4, INPUT + 1, 0),
+                /* 7 */ Arith(Id::MOV, OUTPUT + 2, UNIFORM + 5, 0, 0),
+                /* 8 */ Arith(Id::ADD, TEMP + 0, INPUT + 1, TEMP + 0, 0),
+            },
+            swizzles);
+    }
+
+    SECTION("LOOP and address registers differing between the units") {
+        const std::vector<u32> swizzles = {Desc("xyzw"), Desc("xy")};
+        CheckBatchMatchesRun(*setup,
+                             {
+                                 /* 0 */ Arith(Id::MOVA, 0, INPUT + 2, 0, 1),
+                                 /* 1 */ Arith(Id::MOV, OUTPUT + 0, UNIFORM + 0, 0, 0, 1),
+                                 /* 2 */ Arith(Id::MOV, OUTPUT + 1, UNIFORM + 3, 0, 0, 2),
+                                 /* 3 */ UniformFlow(Id::LOOP, 0, 4, 0),
+                                 /* 4 */ Arith(Id::ADD, TEMP + 0, UNIFORM + 2, TEMP + 0, 0, 3),
+                                 /* 5 */ Mad(Id::MAD, OUTPUT + 2, INPUT + 0, UNIFORM + 1,
+                                             TEMP + 0, 0, 1),
+                                 /* 6 */ Mad(Id::MADI, OUTPUT + 3, INPUT + 0, INPUT + 1,
+                                             UNIFORM + 2, 0, 2),
+                                 /* 7 */ ArithI(Id::SGEI, OUTPUT + 4, INPUT + 0, UNIFORM + 3,
+                                                0, 1),
+                                 /* 8 */ Op(Id::END),
+                             },
+                             swizzles);
+    }
+}
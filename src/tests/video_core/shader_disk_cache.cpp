@@ -0,0 +1,122 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <catch.hpp>
+#include "common/file_util.h"
+#include "video_core/renderer_opengl/gl_shader_gen.h"
+#include "video_core/shader/shader.h"
+#include "video_core/shader_disk_cache.h"
+#include "video_core/video_core.h"
+
+namespace Pica {
+
+static std::unique_ptr<Shader::ShaderSetup> MakeProgram(u32 seed) {
+    auto setup = std::make_unique<Shader::ShaderSetup>();
+    for (unsigned i = 0; i < 8; ++i) {
+        setup->WriteProgramCode(i, seed + i);
+    }
+    setup->WriteSwizzleData(0, seed);
+    setup->WriteSwizzleData(100, seed + 1);
+    return setup;
+}
+
+static GLShader::PicaShaderConfig MakeFragmentConfig() {
+    GLShader::PicaShaderConfig config;
+    std::memset(&config.state, 0, sizeof(config.state));
+    config.state.alpha_test_func = FramebufferRegs::CompareFunc::GreaterThan;
+    return config;
+}
+
+TEST_CASE("ShaderDiskCache: shaders are kept across runs", "[video_core]") {
+    const std::string test_dir = "./shader_disk_cache_test/";
+    const std::string path = test_dir + "0004000000033500.bin";
+    FileUtil::DeleteDirRecursively(test_dir);
+
+    const auto program = MakeProgram(0x100);
+    const GLShader::PicaShaderConfig config = MakeFragmentConfig();
+
+    {
+        ShaderDiskCache cache;
+        REQUIRE(cache.Open(path) == 0);
+        cache.RecordProgram(*program);
+        cache.RecordFragmentConfig(config);
+        cache.RecordProgram(*MakeProgram(0x100)); // Already recorded
+    }
+
+    {
+        ShaderDiskCache cache;
+        REQUIRE(cache.Open(path) == 2);
+        REQUIRE(cache.GetPrograms().size() == 1);
+        REQUIRE(cache.GetPrograms()[0]->program_code == program->program_code);
+        REQUIRE(cache.GetPrograms()[0]->swizzle_data == program->swizzle_data);
+        REQUIRE(cache.GetFragmentConfigs().size() == 1);
+        REQUIRE(cache.GetFragmentConfigs()[0] == config);
+
+        cache.RecordFragmentConfig(config); // Loaded from the cache
+        cache.RecordProgram(*MakeProgram(0x200));
+    }
+
+    {
+        ShaderDiskCache cache;
+        REQUIRE(cache.Open(path) == 3);
+    }
+
+    // Corrupt the data of the last entry, which is followed by its entry number
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-static_cast<std::streamoff>(sizeof(u32) + 1), std::ios::end);
+        file.put('\x55');
+    }
+    {
+        ShaderDiskCache cache;
+        REQUIRE(cache.Open(path) == 2);
+    }
+    {
+        ShaderDiskCache cache;
+        REQUIRE(cache.Open(path) == 2);
+    }
+
+    FileUtil::DeleteDirRecursively(test_dir);
+}
+
+TEST_CASE("ShaderDiskCache: fragment shaders are generated in the background", "[video_core]") {
+    const std::string test_dir = "./shader_disk_cache_test/";
+    const std::string path = test_dir + "0004000000033500.bin";
+    FileUtil::DeleteDirRecursively(test_dir);
+
+    const GLShader::PicaShaderConfig config = MakeFragmentConfig();
+    {
+        ShaderDiskCache cache;
+        cache.Open(path);
+        cache.RecordFragmentConfig(config);
+    }
+
+    VideoCore::g_hw_renderer_enabled = true;
+    VideoCore::g_shader_jit_enabled = false;
+    {
+        ShaderDiskCache cache;
+        cache.Open(path);
+        cache.StartPrecompiling();
+
+        std::vector<std::pair<GLShader::PicaShaderConfig, std::string>> shaders;
+        for (int i = 0; i < 1000 && shaders.empty(); ++i) {
+            shaders = cache.TakeFragmentShaders();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        REQUIRE(shaders.size() == 1);
+        REQUIRE(shaders[0].first == config);
+        REQUIRE(shaders[0].second == GLShader::GenerateFragmentShader(config));
+        REQUIRE(cache.TakeFragmentShaders().empty());
+    }
+
+    FileUtil::DeleteDirRecursively(test_dir);
+}
+
+} // namespace Pica
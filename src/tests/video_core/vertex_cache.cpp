@@ -0,0 +1,50 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch.hpp>
+#include "common/common_types.h"
+#include "video_core/vertex_cache.h"
+
+namespace Pica {
+
+TEST_CASE("VertexCache", "[video_core]") {
+    VertexCache cache(4);
+    cache.BeginDraw(100);
+
+    REQUIRE(cache.Lookup(100) == nullptr);
+    cache.Insert(100).attr[0].x = float24::FromFloat32(1.f);
+    REQUIRE(cache.Contains(100));
+    REQUIRE(cache.Lookup(100)->attr[0].x.ToFloat32() == 1.f);
+
+    SECTION("maps indices relative to the smallest index of the draw") {
+        for (u32 vertex = 101; vertex < 104; ++vertex) {
+            REQUIRE(cache.GetEntry(vertex) != cache.GetEntry(100));
+            cache.Insert(vertex);
+        }
+        REQUIRE(cache.Contains(100));
+
+        // Wraps around past the size of the cache
+        REQUIRE(cache.GetEntry(104) == cache.GetEntry(100));
+        cache.Insert(104);
+        REQUIRE(!cache.Contains(100));
+        REQUIRE(cache.Contains(104));
+    }
+
+    SECTION("invalidates all entries on a new draw") {
+        cache.BeginDraw(100);
+        REQUIRE(!cache.Contains(100));
+        REQUIRE(cache.Lookup(100) == nullptr);
+    }
+
+    SECTION("counts hits and misses") {
+        cache.Lookup(100);
+        cache.Lookup(101);
+        const VertexCache::Stats stats = cache.TakeStats();
+        REQUIRE(stats.hits == 2);
+        REQUIRE(stats.misses == 2);
+        REQUIRE(cache.TakeStats().hits == 0);
+    }
+}
+
+} // namespace Pica
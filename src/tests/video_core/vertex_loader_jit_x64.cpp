@@ -0,0 +1,104 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstddef>
+#include <catch.hpp>
+#include "common/common_types.h"
+#include "video_core/pica_state.h"
+#include "video_core/regs_pipeline.h"
+#include "video_core/shader/shader.h"
+#include "video_core/vertex_loader.h"
+#include "video_core/vertex_loader_jit_x64.h"
+
+namespace Pica {
+
+using Format = PipelineRegs::VertexAttributeFormat;
+
+struct TestVertex {
+    s8 position[3];
+    u8 texcoord[2];
+    u8 padding;
+    s16 normal[3];
+    float color[4];
+    float fog;
+};
+static_assert(sizeof(TestVertex) == 32, "TestVertex has the layout of the loader below");
+
+static PipelineRegs MakeRegs() {
+    PipelineRegs regs{};
+
+    auto& attributes = regs.vertex_attributes;
+    attributes.format0.Assign(Format::BYTE);
+    attributes.size0.Assign(2);
+    attributes.format1.Assign(Format::UBYTE);
+    attributes.size1.Assign(1);
+    attributes.format2.Assign(Format::SHORT);
+    attributes.size2.Assign(2);
+    attributes.format3.Assign(Format::FLOAT);
+    attributes.size3.Assign(3);
+    attributes.format4.Assign(Format::FLOAT);
+    attributes.size4.Assign(0);
+    attributes.attribute_mask.Assign(1 << 5);
+    attributes.max_attribute_index.Assign(5);
+
+    auto& loader = attributes.attribute_loaders[0];
+    loader.comp0.Assign(0);
+    loader.comp1.Assign(1);
+    loader.comp2.Assign(2);
+    loader.comp3.Assign(3);
+    loader.comp4.Assign(4);
+    loader.byte_count.Assign(sizeof(TestVertex));
+    loader.component_count.Assign(5);
+
+    return regs;
+}
+
+TEST_CASE("VertexLoaderJitX64", "[video_core][vertex_loader]") {
+    const PipelineRegs regs = MakeRegs();
+    const VertexLoader loader(regs);
+    const VertexLoaderJitX64 jit(loader);
+
+    const std::array<TestVertex, 2> vertices = {{
+        {{1, 2, 3}, {4, 5}, 0, {6, 7, 8}, {0.5f, 1.5f, 2.5f, 3.5f}, 4.5f},
+        {{-128, 127, -1}, {255, 128}, 0, {-32768, 32767, -2}, {-1.f, -2.f, -3.f, -4.f}, 7.f},
+    }};
+    const u8* data = reinterpret_cast<const u8*>(vertices.data());
+    const std::array<const u8*, 16> attribute_pointers = {{
+        data + offsetof(TestVertex, position), data + offsetof(TestVertex, texcoord),
+        data + offsetof(TestVertex, normal), data + offsetof(TestVertex, color),
+        data + offsetof(TestVertex, fog),
+    }};
+
+    const float default_attribute[4] = {9.f, 10.f, 11.f, 12.f};
+    for (int i = 0; i < 4; ++i) {
+        g_state.input_default_attributes.attr[5][i] = float24::FromFloat32(default_attribute[i]);
+    }
+
+    Shader::AttributeBuffer input;
+    const auto require_attribute = [&input](int index, float x, float y, float z, float w) {
+        REQUIRE(input.attr[index].x.ToFloat32() == x);
+        REQUIRE(input.attr[index].y.ToFloat32() == y);
+        REQUIRE(input.attr[index].z.ToFloat32() == z);
+        REQUIRE(input.attr[index].w.ToFloat32() == w);
+    };
+
+    jit.LoadVertex(attribute_pointers.data(), 0, input);
+    require_attribute(0, 1.f, 2.f, 3.f, 1.f);
+    require_attribute(1, 4.f, 5.f, 0.f, 1.f);
+    require_attribute(2, 6.f, 7.f, 8.f, 1.f);
+    require_attribute(3, 0.5f, 1.5f, 2.5f, 3.5f);
+    require_attribute(4, 4.5f, 0.f, 0.f, 1.f);
+    require_attribute(5, 9.f, 10.f, 11.f, 12.f);
+
+    jit.LoadVertex(attribute_pointers.data(), 1, input);
+    require_attribute(0, -128.f, 127.f, -1.f, 1.f);
+    require_attribute(1, 255.f, 128.f, 0.f, 1.f);
+    require_attribute(2, -32768.f, 32767.f, -2.f, 1.f);
+    require_attribute(3, -1.f, -2.f, -3.f, -4.f);
+    require_attribute(4, 7.f, 0.f, 0.f, 1.f);
+    require_attribute(5, 9.f, 10.f, 11.f, 12.f);
+}
+
+} // namespace Pica
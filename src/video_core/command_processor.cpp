@@ -2,9 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 #include "common/assert.h"
 #include "common/logging/log.h"
@@ -16,6 +18,7 @@
 #include "core/tracer/recorder.h"
 #include "video_core/command_processor.h"
 #include "video_core/debug_utils/debug_utils.h"
+#include "video_core/gpu_thread.h"
 #include "video_core/pica_state.h"
 #include "video_core/pica_types.h"
 #include "video_core/primitive_assembly.h"
@@ -25,6 +28,7 @@
 #include "video_core/regs_texturing.h"
 #include "video_core/renderer_base.h"
 #include "video_core/shader/shader.h"
+#include "video_core/vertex_cache.h"
 #include "video_core/vertex_loader.h"
 #include "video_core/video_core.h"
 
@@ -38,6 +42,13 @@ static u32 vs_uniform_write_buffer[4];
 static int gs_float_regs_counter = 0;
 static u32 gs_uniform_write_buffer[4];
 
+/// Vertex loaders of the attribute layouts drawn so far, keyed by VertexLoader::HashLayout
+static std::unordered_map<u64, std::unique_ptr<VertexLoader>> vertex_loaders;
+
+/// Number of vertices in the vertex cache, draws with a larger index range may shade some twice
+constexpr size_t VERTEX_CACHE_SIZE = 1024;
+static VertexCache vertex_cache(VERTEX_CACHE_SIZE);
+
 static int default_attr_counter = 0;
 static u32 default_attr_write_buffer[3];
 
@@ -148,7 +159,7 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
     switch (id) {
     // Trigger IRQ
     case PICA_REG_INDEX(trigger_irq):
-        Service::GSP::SignalInterrupt(Service::GSP::InterruptId::P3D);
+        GPUThread::SignalInterrupt(Service::GSP::InterruptId::P3D);
         break;
 
     case PICA_REG_INDEX(pipeline.triangle_topology):
@@ -285,10 +296,14 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
             g_debug_context->OnEvent(DebugContext::Event::IncomingPrimitiveBatch, nullptr);
 
         // Processes information about internal vertex attributes to figure out how a vertex is
-        // loaded.
-        // Later, these can be compiled and cached.
+        // loaded. The loader is reused by the draws with the same attribute layout.
         const u32 base_address = regs.pipeline.vertex_attributes.GetPhysicalBaseAddress();
-        VertexLoader loader(regs.pipeline);
+        std::unique_ptr<VertexLoader>& cached_loader =
+            vertex_loaders[VertexLoader::HashLayout(regs.pipeline)];
+        if (cached_loader == nullptr)
+            cached_loader = std::make_unique<VertexLoader>(regs.pipeline);
+        VertexLoader& loader = *cached_loader;
+        loader.BeginDraw(base_address);
 
         // Load vertices
         bool is_indexed = (id == PICA_REG_INDEX(pipeline.trigger_draw_indexed));
@@ -316,18 +331,7 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
 
         DebugUtils::MemoryAccessTracker memory_accesses;
 
-        // Simple circular-replacement vertex cache
-        // The size has been tuned for optimal balance between hit-rate and the cost of lookup
-        const size_t VERTEX_CACHE_SIZE = 32;
-        std::array<u16, VERTEX_CACHE_SIZE> vertex_cache_ids;
-        std::array<Shader::AttributeBuffer, VERTEX_CACHE_SIZE> vertex_cache;
-        Shader::AttributeBuffer vs_output;
-
-        unsigned int vertex_cache_pos = 0;
-        vertex_cache_ids.fill(-1);
-
         auto* shader_engine = Shader::GetEngine();
-        Shader::UnitState shader_unit;
 
         shader_engine->SetupBatch(g_state.vs, regs.vs.main_offset);
 
@@ -336,61 +340,108 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
         if (g_state.geometry_pipeline.NeedIndexInput())
             ASSERT(is_indexed);
 
-        for (unsigned int index = 0; index < regs.pipeline.num_vertices; ++index) {
+        auto get_vertex = [&](unsigned int index) -> unsigned int {
             // Indexed rendering doesn't use the start offset
-            unsigned int vertex =
-                is_indexed ? (index_u16 ? index_address_16[index] : index_address_8[index])
-                           : (index + regs.pipeline.vertex_offset);
+            return is_indexed ? (index_u16 ? index_address_16[index] : index_address_8[index])
+                              : (index + regs.pipeline.vertex_offset);
+        };
 
-            // -1 is a common special value used for primitive restart. Since it's unknown if
-            // the PICA supports it, and it would mess up the caching, guard against it here.
-            ASSERT(vertex != -1);
+        const unsigned int num_vertices = regs.pipeline.num_vertices;
 
-            bool vertex_cache_hit = false;
+        if (g_state.geometry_pipeline.NeedIndexInput()) {
+            for (unsigned int index = 0; index < num_vertices; ++index) {
+                g_state.geometry_pipeline.SubmitIndex(get_vertex(index));
+            }
+        } else {
+            if (is_indexed && num_vertices != 0) {
+                // Map the index range of the draw to the vertex cache
+                const u32 min_index =
+                    index_u16 ? *std::min_element(index_address_16, index_address_16 + num_vertices)
+                              : *std::min_element(index_address_8, index_address_8 + num_vertices);
+                vertex_cache.BeginDraw(min_index);
+            }
 
-            if (is_indexed) {
-                if (g_state.geometry_pipeline.NeedIndexInput()) {
-                    g_state.geometry_pipeline.SubmitIndex(vertex);
-                    continue;
-                }
+            // The vertices missing the vertex cache are shaded in batches, in one engine
+            // invocation
+            const unsigned int VERTEX_BATCH_SIZE = 8;
+            std::array<Shader::UnitState, VERTEX_BATCH_SIZE> shader_units;
+            std::array<Shader::AttributeBuffer*, VERTEX_BATCH_SIZE> shaded_outputs;
+            std::array<const Shader::AttributeBuffer*, VERTEX_BATCH_SIZE> batch_outputs;
+            // Vertex cache entries holding the outputs of the batch
+            std::array<size_t, VERTEX_BATCH_SIZE> batch_entries;
+            // Outputs of the batch for non-indexed draws, which don't use the vertex cache
+            std::array<Shader::AttributeBuffer, VERTEX_BATCH_SIZE> uncached_outputs;
+
+            unsigned int index = 0;
+            while (index < num_vertices) {
+                unsigned int batch_size = 0;
+                unsigned int num_shaded = 0;
+
+                for (; batch_size < VERTEX_BATCH_SIZE && index < num_vertices; ++index) {
+                    const unsigned int vertex = get_vertex(index);
+
+                    // -1 is a common special value used for primitive restart. Since it's unknown
+                    // if the PICA supports it, and it would mess up the caching, guard against it
+                    // here.
+                    ASSERT(vertex != -1);
+
+                    Shader::AttributeBuffer* output;
+                    if (is_indexed) {
+                        if (g_debug_context && Pica::g_debug_context->recorder) {
+                            int size = index_u16 ? 2 : 1;
+                            memory_accesses.AddAccess(
+                                base_address + index_info.offset + size * index, size);
+                        }
+
+                        // End the batch if the entry of the vertex still holds the output of one
+                        // of its other vertices
+                        const size_t entry = vertex_cache.GetEntry(vertex);
+                        const auto batch_entries_end = batch_entries.begin() + batch_size;
+                        if (!vertex_cache.Contains(vertex) &&
+                            std::find(batch_entries.begin(), batch_entries_end, entry) !=
+                                batch_entries_end)
+                            break;
+                        batch_entries[batch_size] = entry;
+
+                        const Shader::AttributeBuffer* cached_output = vertex_cache.Lookup(vertex);
+                        if (cached_output != nullptr) {
+                            batch_outputs[batch_size++] = cached_output;
+                            continue;
+                        }
+                        output = &vertex_cache.Insert(vertex);
+                    } else {
+                        output = &uncached_outputs[batch_size];
+                    }
+
+                    // Initialize data for the current vertex
+                    Shader::AttributeBuffer input;
+                    loader.LoadVertex(index, vertex, input, memory_accesses);
 
-                if (g_debug_context && Pica::g_debug_context->recorder) {
-                    int size = index_u16 ? 2 : 1;
-                    memory_accesses.AddAccess(base_address + index_info.offset + size * index,
-                                              size);
+                    // Send to vertex shader
+                    if (g_debug_context)
+                        g_debug_context->OnEvent(DebugContext::Event::VertexShaderInvocation,
+                                                 (void*)&input);
+                    shader_units[num_shaded].LoadInput(regs.vs, input);
+                    shaded_outputs[num_shaded++] = output;
+                    batch_outputs[batch_size++] = output;
                 }
 
-                for (unsigned int i = 0; i < VERTEX_CACHE_SIZE; ++i) {
-                    if (vertex == vertex_cache_ids[i]) {
-                        vs_output = vertex_cache[i];
-                        vertex_cache_hit = true;
-                        break;
-                    }
+                shader_engine->RunBatch(g_state.vs, shader_units.data(), num_shaded);
+                for (unsigned int i = 0; i < num_shaded; ++i) {
+                    shader_units[i].WriteOutput(regs.vs, *shaded_outputs[i]);
                 }
-            }
 
-            if (!vertex_cache_hit) {
-                // Initialize data for the current vertex
-                Shader::AttributeBuffer input;
-                loader.LoadVertex(base_address, index, vertex, input, memory_accesses);
-
-                // Send to vertex shader
-                if (g_debug_context)
-                    g_debug_context->OnEvent(DebugContext::Event::VertexShaderInvocation,
-                                             (void*)&input);
-                shader_unit.LoadInput(regs.vs, input);
-                shader_engine->Run(g_state.vs, shader_unit);
-                shader_unit.WriteOutput(regs.vs, vs_output);
-
-                if (is_indexed) {
-                    vertex_cache[vertex_cache_pos] = vs_output;
-                    vertex_cache_ids[vertex_cache_pos] = vertex;
-                    vertex_cache_pos = (vertex_cache_pos + 1) % VERTEX_CACHE_SIZE;
+                // Send to geometry pipeline
+                for (unsigned int i = 0; i < batch_size; ++i) {
+                    g_state.geometry_pipeline.SubmitVertex(*batch_outputs[i]);
                 }
             }
 
-            // Send to geometry pipeline
-            g_state.geometry_pipeline.SubmitVertex(vs_output);
+            if (is_indexed) {
+                const VertexCache::Stats stats = vertex_cache.TakeStats();
+                MICROPROFILE_META_CPU("Vertex Cache Hits", static_cast<int>(stats.hits));
+                MICROPROFILE_META_CPU("Vertex Cache Misses", static_cast<int>(stats.misses));
+            }
         }
 
         for (auto& range : memory_accesses.ranges) {
@@ -446,7 +497,7 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
         if (offset >= 4096) {
             LOG_ERROR(HW_GPU, "Invalid GS program offset %u", offset);
         } else {
-            g_state.gs.program_code[offset] = value;
+            g_state.gs.WriteProgramCode(offset, value);
             offset++;
         }
         break;
@@ -464,7 +515,7 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
         if (offset >= g_state.gs.swizzle_data.size()) {
             LOG_ERROR(HW_GPU, "Invalid GS swizzle pattern offset %u", offset);
         } else {
-            g_state.gs.swizzle_data[offset] = value;
+            g_state.gs.WriteSwizzleData(offset, value);
             offset++;
         }
         break;
@@ -513,9 +564,9 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
         if (offset >= 512) {
             LOG_ERROR(HW_GPU, "Invalid VS program offset %u", offset);
         } else {
-            g_state.vs.program_code[offset] = value;
+            g_state.vs.WriteProgramCode(offset, value);
             if (!g_state.regs.pipeline.gs_unit_exclusive_configuration) {
-                g_state.gs.program_code[offset] = value;
+                g_state.gs.WriteProgramCode(offset, value);
             }
             offset++;
         }
@@ -534,9 +585,9 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
         if (offset >= g_state.vs.swizzle_data.size()) {
             LOG_ERROR(HW_GPU, "Invalid VS swizzle pattern offset %u", offset);
         } else {
-            g_state.vs.swizzle_data[offset] = value;
+            g_state.vs.WriteSwizzleData(offset, value);
             if (!g_state.regs.pipeline.gs_unit_exclusive_configuration) {
-                g_state.gs.swizzle_data[offset] = value;
+                g_state.gs.WriteSwizzleData(offset, value);
             }
             offset++;
         }
@@ -0,0 +1,168 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "common/microprofile.h"
+#include "common/thread.h"
+#include "common/threadsafe_queue.h"
+#include "core/core_timing.h"
+#include "core/hle/service/gsp/gsp.h"
+#include "video_core/command_processor.h"
+#include "video_core/debug_utils/debug_utils.h"
+#include "video_core/gpu_thread.h"
+#include "video_core/renderer_base.h"
+#include "video_core/video_core.h"
+
+MICROPROFILE_DEFINE(GPU_CmdlistProcessing, "GPU", "Cmdlist Processing", MP_RGB(100, 255, 100));
+
+namespace Pica {
+namespace GPUThread {
+
+struct CommandList {
+    const u32* list;
+    u32 size;
+};
+
+static std::unique_ptr<std::thread> gpu_thread;
+static thread_local bool is_gpu_thread = false;
+
+/// Command lists queued by the CPU thread. A null list stops the GPU thread.
+static Common::SPSCQueue<CommandList, false> command_lists;
+/// Number of queued command lists which haven't been processed yet
+static std::atomic<u32> num_pending{0};
+/// Wakes up the GPU thread when command lists are queued
+static Common::Event work_event;
+static std::mutex idle_mutex;
+static std::condition_variable idle_cv;
+
+/// Interrupts signaled on the GPU thread, delivered in order on the CPU thread
+static std::vector<Service::GSP::InterruptId> pending_interrupts;
+static std::mutex interrupt_mutex;
+static CoreTiming::EventType* interrupt_event;
+
+static void ProcessCommandList(const u32* list, u32 size) {
+    MICROPROFILE_SCOPE(GPU_CmdlistProcessing);
+    CommandProcessor::ProcessCommandList(list, size);
+}
+
+static void GPUThreadMain() {
+    Common::SetCurrentThreadName("GPU");
+    MicroProfileOnThreadCreate("GPU");
+    is_gpu_thread = true;
+
+    while (true) {
+        CommandList command_list;
+        while (!command_lists.Pop(command_list)) {
+            work_event.Wait();
+        }
+        if (command_list.list == nullptr)
+            break;
+
+        ProcessCommandList(command_list.list, command_list.size);
+
+        if (--num_pending == 0) {
+            std::lock_guard<std::mutex> lock(idle_mutex);
+            idle_cv.notify_all();
+        }
+    }
+}
+
+static void DeliverInterrupts() {
+    std::vector<Service::GSP::InterruptId> interrupts;
+    {
+        std::lock_guard<std::mutex> lock(interrupt_mutex);
+        interrupts.swap(pending_interrupts);
+    }
+    for (Service::GSP::InterruptId interrupt_id : interrupts) {
+        Service::GSP::SignalInterrupt(interrupt_id);
+    }
+}
+
+/// Returns whether command lists can currently be processed on the GPU thread
+static bool IsAsync() {
+    if (gpu_thread == nullptr || !VideoCore::g_gpu_thread_enabled)
+        return false;
+
+    // The OpenGL rasterizer has to run on the thread owning the context
+    if (VideoCore::g_renderer == nullptr || VideoCore::g_renderer->IsOpenGLRasterizerActive())
+        return false;
+
+    // Traces and breakpoints expect the PICA state to follow the emulated CPU
+    if (g_debug_context) {
+        if (g_debug_context->recorder)
+            return false;
+        const auto& breakpoints = g_debug_context->breakpoints;
+        if (std::any_of(breakpoints.begin(), breakpoints.end(),
+                        [](const auto& breakpoint) { return breakpoint.enabled; }))
+            return false;
+    }
+
+    return true;
+}
+
+void Start() {
+    interrupt_event = CoreTiming::RegisterEvent(
+        "GPUThreadInterrupts", [](u64 userdata, int cycles_late) { DeliverInterrupts(); });
+    num_pending = 0;
+    gpu_thread = std::make_unique<std::thread>(GPUThreadMain);
+}
+
+void Stop() {
+    if (gpu_thread == nullptr)
+        return;
+
+    command_lists.Push(CommandList{nullptr, 0});
+    work_event.Set();
+    gpu_thread->join();
+    gpu_thread.reset();
+
+    // Nobody is left to wait for these
+    std::lock_guard<std::mutex> lock(interrupt_mutex);
+    pending_interrupts.clear();
+}
+
+void SubmitCommandList(const u32* list, u32 size) {
+    if (!IsAsync()) {
+        WaitIdle();
+        ProcessCommandList(list, size);
+        return;
+    }
+
+    ++num_pending;
+    command_lists.Push(CommandList{list, size});
+    work_event.Set();
+}
+
+void WaitIdle() {
+    if (gpu_thread == nullptr || is_gpu_thread)
+        return;
+
+    if (num_pending != 0) {
+        std::unique_lock<std::mutex> lock(idle_mutex);
+        idle_cv.wait(lock, [] { return num_pending == 0; });
+    }
+    DeliverInterrupts();
+}
+
+void SignalInterrupt(Service::GSP::InterruptId interrupt_id) {
+    if (!is_gpu_thread) {
+        Service::GSP::SignalInterrupt(interrupt_id);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(interrupt_mutex);
+    if (pending_interrupts.empty()) {
+        CoreTiming::ScheduleEventThreadsafe(0, interrupt_event, 0);
+    }
+    pending_interrupts.push_back(interrupt_id);
+}
+
+} // namespace GPUThread
+} // namespace Pica
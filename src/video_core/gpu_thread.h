@@ -0,0 +1,59 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "common/common_types.h"
+
+namespace Service {
+namespace GSP {
+enum class InterruptId : u8;
+} // namespace GSP
+} // namespace Service
+
+namespace Pica {
+
+/**
+ * Host thread processing the PICA command lists, so that vertex shading and software rasterization
+ * run in parallel with the emulated CPU.
+ *
+ * Command lists are queued by the CPU thread and processed in order by the GPU thread. Anything
+ * else accessing the PICA state, the rasterizer or the memory written by the GPU must first wait
+ * for the queued lists with WaitIdle: memory fills, display transfers, rasterizer flushes and
+ * invalidations (which GSP cache operations go through before the guest reads GPU output), and the
+ * presentation of frames.
+ *
+ * Interrupts signaled by command lists are delivered on the CPU thread. The guest waits for them
+ * before reusing the memory of a command list, as it does on hardware.
+ *
+ * Command lists are only processed asynchronously with the software rasterizer, as the OpenGL
+ * context belongs to the CPU thread, and neither while a PICA trace is being recorded.
+ */
+namespace GPUThread {
+
+/// Starts the GPU thread
+void Start();
+
+/// Processes the queued command lists and stops the GPU thread
+void Stop();
+
+/**
+ * Processes a command list, on the GPU thread when it is enabled and otherwise right away.
+ * @param list Pointer to the command list.
+ * @param size Size of the command list in bytes.
+ */
+void SubmitCommandList(const u32* list, u32 size);
+
+/**
+ * Blocks until the queued command lists have been processed, and delivers their interrupts. Does
+ * nothing when called from the GPU thread itself.
+ */
+void WaitIdle();
+
+/// Signals a GSP interrupt, from the GPU thread through the CPU thread
+void SignalInterrupt(Service::GSP::InterruptId interrupt_id);
+
+} // namespace GPUThread
+
+} // namespace Pica
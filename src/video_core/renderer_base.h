@@ -47,6 +47,10 @@ public:
         return rasterizer.get();
     }
 
+    bool IsOpenGLRasterizerActive() const {
+        return opengl_rasterizer_active;
+    }
+
     void RefreshRasterizerSetting();
 
 protected:
@@ -22,6 +22,8 @@
 #include "video_core/renderer_opengl/gl_shader_gen.h"
 #include "video_core/renderer_opengl/pica_to_gl.h"
 #include "video_core/renderer_opengl/renderer_opengl.h"
+#include "video_core/shader_disk_cache.h"
+#include "video_core/video_core.h"
 
 MICROPROFILE_DEFINE(OpenGL_Drawing, "OpenGL", "Drawing", MP_RGB(128, 128, 192));
 MICROPROFILE_DEFINE(OpenGL_Blits, "OpenGL", "Blits", MP_RGB(100, 100, 255));
@@ -1195,115 +1197,132 @@ void RasterizerOpenGL::SamplerInfo::SyncWithConfig(
     }
 }
 
-void RasterizerOpenGL::SetShader() {
-    auto config = GLShader::PicaShaderConfig::BuildFromRegs(Pica::g_state.regs);
+RasterizerOpenGL::PicaShader* RasterizerOpenGL::CompileShader(
+    const GLShader::PicaShaderConfig& config, const std::string& fragment_source) {
     std::unique_ptr<PicaShader> shader = std::make_unique<PicaShader>();
 
-    // Find (or generate) the GLSL shader for the current TEV state
-    auto cached_shader = shader_cache.find(config);
-    if (cached_shader != shader_cache.end()) {
-        current_shader = cached_shader->second.get();
+    shader->shader.Create(GLShader::GenerateVertexShader().c_str(), fragment_source.c_str());
 
-        state.draw.shader_program = current_shader->shader.handle;
-        state.Apply();
-    } else {
-        LOG_DEBUG(Render_OpenGL, "Creating new shader");
+    state.draw.shader_program = shader->shader.handle;
+    state.Apply();
 
-        shader->shader.Create(GLShader::GenerateVertexShader().c_str(),
-                              GLShader::GenerateFragmentShader(config).c_str());
+    // Set the texture samplers to correspond to different texture units
+    GLint uniform_tex = glGetUniformLocation(shader->shader.handle, "tex[0]");
+    if (uniform_tex != -1) {
+        glUniform1i(uniform_tex, TextureUnits::PicaTexture(0).id);
+    }
+    uniform_tex = glGetUniformLocation(shader->shader.handle, "tex[1]");
+    if (uniform_tex != -1) {
+        glUniform1i(uniform_tex, TextureUnits::PicaTexture(1).id);
+    }
+    uniform_tex = glGetUniformLocation(shader->shader.handle, "tex[2]");
+    if (uniform_tex != -1) {
+        glUniform1i(uniform_tex, TextureUnits::PicaTexture(2).id);
+    }
 
-        state.draw.shader_program = shader->shader.handle;
-        state.Apply();
+    // Set the texture samplers to correspond to different lookup table texture units
+    GLint uniform_lut = glGetUniformLocation(shader->shader.handle, "lighting_lut");
+    if (uniform_lut != -1) {
+        glUniform1i(uniform_lut, TextureUnits::LightingLUT.id);
+    }
 
-        // Set the texture samplers to correspond to different texture units
-        GLint uniform_tex = glGetUniformLocation(shader->shader.handle, "tex[0]");
-        if (uniform_tex != -1) {
-            glUniform1i(uniform_tex, TextureUnits::PicaTexture(0).id);
-        }
-        uniform_tex = glGetUniformLocation(shader->shader.handle, "tex[1]");
-        if (uniform_tex != -1) {
-            glUniform1i(uniform_tex, TextureUnits::PicaTexture(1).id);
-        }
-        uniform_tex = glGetUniformLocation(shader->shader.handle, "tex[2]");
-        if (uniform_tex != -1) {
-            glUniform1i(uniform_tex, TextureUnits::PicaTexture(2).id);
-        }
+    GLint uniform_fog_lut = glGetUniformLocation(shader->shader.handle, "fog_lut");
+    if (uniform_fog_lut != -1) {
+        glUniform1i(uniform_fog_lut, TextureUnits::FogLUT.id);
+    }
 
-        // Set the texture samplers to correspond to different lookup table texture units
-        GLint uniform_lut = glGetUniformLocation(shader->shader.handle, "lighting_lut");
-        if (uniform_lut != -1) {
-            glUniform1i(uniform_lut, TextureUnits::LightingLUT.id);
-        }
+    GLint uniform_proctex_noise_lut =
+        glGetUniformLocation(shader->shader.handle, "proctex_noise_lut");
+    if (uniform_proctex_noise_lut != -1) {
+        glUniform1i(uniform_proctex_noise_lut, TextureUnits::ProcTexNoiseLUT.id);
+    }
 
-        GLint uniform_fog_lut = glGetUniformLocation(shader->shader.handle, "fog_lut");
-        if (uniform_fog_lut != -1) {
-            glUniform1i(uniform_fog_lut, TextureUnits::FogLUT.id);
-        }
+    GLint uniform_proctex_color_map =
+        glGetUniformLocation(shader->shader.handle, "proctex_color_map");
+    if (uniform_proctex_color_map != -1) {
+        glUniform1i(uniform_proctex_color_map, TextureUnits::ProcTexColorMap.id);
+    }
 
-        GLint uniform_proctex_noise_lut =
-            glGetUniformLocation(shader->shader.handle, "proctex_noise_lut");
-        if (uniform_proctex_noise_lut != -1) {
-            glUniform1i(uniform_proctex_noise_lut, TextureUnits::ProcTexNoiseLUT.id);
-        }
+    GLint uniform_proctex_alpha_map =
+        glGetUniformLocation(shader->shader.handle, "proctex_alpha_map");
+    if (uniform_proctex_alpha_map != -1) {
+        glUniform1i(uniform_proctex_alpha_map, TextureUnits::ProcTexAlphaMap.id);
+    }
 
-        GLint uniform_proctex_color_map =
-            glGetUniformLocation(shader->shader.handle, "proctex_color_map");
-        if (uniform_proctex_color_map != -1) {
-            glUniform1i(uniform_proctex_color_map, TextureUnits::ProcTexColorMap.id);
-        }
+    GLint uniform_proctex_lut = glGetUniformLocation(shader->shader.handle, "proctex_lut");
+    if (uniform_proctex_lut != -1) {
+        glUniform1i(uniform_proctex_lut, TextureUnits::ProcTexLUT.id);
+    }
 
-        GLint uniform_proctex_alpha_map =
-            glGetUniformLocation(shader->shader.handle, "proctex_alpha_map");
-        if (uniform_proctex_alpha_map != -1) {
-            glUniform1i(uniform_proctex_alpha_map, TextureUnits::ProcTexAlphaMap.id);
-        }
+    GLint uniform_proctex_diff_lut =
+        glGetUniformLocation(shader->shader.handle, "proctex_diff_lut");
+    if (uniform_proctex_diff_lut != -1) {
+        glUniform1i(uniform_proctex_diff_lut, TextureUnits::ProcTexDiffLUT.id);
+    }
+
+    GLuint block_index = glGetUniformBlockIndex(shader->shader.handle, "shader_data");
+    if (block_index != GL_INVALID_INDEX) {
+        GLint block_size;
+        glGetActiveUniformBlockiv(shader->shader.handle, block_index, GL_UNIFORM_BLOCK_DATA_SIZE,
+                                  &block_size);
+        ASSERT_MSG(block_size == sizeof(UniformData),
+                   "Uniform block size did not match! Got %d, expected %zu",
+                   static_cast<int>(block_size), sizeof(UniformData));
+        glUniformBlockBinding(shader->shader.handle, block_index, 0);
+    }
+
+    return shader_cache.emplace(config, std::move(shader)).first->second.get();
+}
 
-        GLint uniform_proctex_lut = glGetUniformLocation(shader->shader.handle, "proctex_lut");
-        if (uniform_proctex_lut != -1) {
-            glUniform1i(uniform_proctex_lut, TextureUnits::ProcTexLUT.id);
+void RasterizerOpenGL::SetShader() {
+    // Compile the shaders of the disk cache that are ready, before they are needed
+    if (VideoCore::g_shader_disk_cache != nullptr) {
+        for (const auto& fragment_shader : VideoCore::g_shader_disk_cache->TakeFragmentShaders()) {
+            if (shader_cache.count(fragment_shader.first) == 0) {
+                CompileShader(fragment_shader.first, fragment_shader.second);
+            }
         }
+    }
+
+    auto config = GLShader::PicaShaderConfig::BuildFromRegs(Pica::g_state.regs);
+
+    // Find (or generate) the GLSL shader for the current TEV state
+    auto cached_shader = shader_cache.find(config);
+    if (cached_shader != shader_cache.end()) {
+        current_shader = cached_shader->second.get();
 
-        GLint uniform_proctex_diff_lut =
-            glGetUniformLocation(shader->shader.handle, "proctex_diff_lut");
-        if (uniform_proctex_diff_lut != -1) {
-            glUniform1i(uniform_proctex_diff_lut, TextureUnits::ProcTexDiffLUT.id);
+        state.draw.shader_program = current_shader->shader.handle;
+        state.Apply();
+    } else {
+        LOG_DEBUG(Render_OpenGL, "Creating new shader");
+
+        current_shader = CompileShader(config, GLShader::GenerateFragmentShader(config));
+        if (VideoCore::g_shader_disk_cache != nullptr) {
+            VideoCore::g_shader_disk_cache->RecordFragmentConfig(config);
         }
 
-        current_shader = shader_cache.emplace(config, std::move(shader)).first->second.get();
-
-        GLuint block_index = glGetUniformBlockIndex(current_shader->shader.handle, "shader_data");
-        if (block_index != GL_INVALID_INDEX) {
-            GLint block_size;
-            glGetActiveUniformBlockiv(current_shader->shader.handle, block_index,
-                                      GL_UNIFORM_BLOCK_DATA_SIZE, &block_size);
-            ASSERT_MSG(block_size == sizeof(UniformData),
-                       "Uniform block size did not match! Got %d, expected %zu",
-                       static_cast<int>(block_size), sizeof(UniformData));
-            glUniformBlockBinding(current_shader->shader.handle, block_index, 0);
-
-            // Update uniforms
-            SyncDepthScale();
-            SyncDepthOffset();
-            SyncAlphaTest();
-            SyncCombinerColor();
-            auto& tev_stages = Pica::g_state.regs.texturing.GetTevStages();
-            for (int index = 0; index < tev_stages.size(); ++index)
-                SyncTevConstColor(index, tev_stages[index]);
-
-            SyncGlobalAmbient();
-            for (int light_index = 0; light_index < 8; light_index++) {
-                SyncLightSpecular0(light_index);
-                SyncLightSpecular1(light_index);
-                SyncLightDiffuse(light_index);
-                SyncLightAmbient(light_index);
-                SyncLightPosition(light_index);
-                SyncLightDistanceAttenuationBias(light_index);
-                SyncLightDistanceAttenuationScale(light_index);
-            }
+        // Update uniforms
+        SyncDepthScale();
+        SyncDepthOffset();
+        SyncAlphaTest();
+        SyncCombinerColor();
+        auto& tev_stages = Pica::g_state.regs.texturing.GetTevStages();
+        for (int index = 0; index < tev_stages.size(); ++index)
+            SyncTevConstColor(index, tev_stages[index]);
 
-            SyncFogColor();
-            SyncProcTexNoise();
+        SyncGlobalAmbient();
+        for (int light_index = 0; light_index < 8; light_index++) {
+            SyncLightSpecular0(light_index);
+            SyncLightSpecular1(light_index);
+            SyncLightDiffuse(light_index);
+            SyncLightAmbient(light_index);
+            SyncLightPosition(light_index);
+            SyncLightDistanceAttenuationBias(light_index);
+            SyncLightDistanceAttenuationScale(light_index);
         }
+
+        SyncFogColor();
+        SyncProcTexNoise();
     }
 }
 
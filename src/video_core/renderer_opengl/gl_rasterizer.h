@@ -8,6 +8,7 @@
 #include <cstddef>
 #include <cstring>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 #include <glad/glad.h>
@@ -166,6 +167,10 @@ private:
     /// Syncs the clip coefficients to match the PICA register
     void SyncClipCoef();
 
+    /// Compiles a shader program and adds it to the shader cache
+    PicaShader* CompileShader(const GLShader::PicaShaderConfig& config,
+                              const std::string& fragment_source);
+
     /// Sets the OpenGL shader in accordance with the current PICA register state
     void SetShader();
 
@@ -5,6 +5,7 @@
 #include <cmath>
 #include <cstring>
 #include "common/bit_set.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "video_core/pica_state.h"
@@ -124,6 +125,60 @@ void GSUnitState::ConfigOutput(const ShaderRegs& config) {
     emitter.output_mask = config.output_mask;
 }
 
+constexpr unsigned NUM_CODE_HASH_BLOCKS = MAX_PROGRAM_CODE_LENGTH / PROGRAM_HASH_BLOCK_SIZE;
+constexpr unsigned NUM_SWIZZLE_HASH_BLOCKS = MAX_SWIZZLE_DATA_LENGTH / PROGRAM_HASH_BLOCK_SIZE;
+static_assert(NUM_CODE_HASH_BLOCKS <= 64 && NUM_SWIZZLE_HASH_BLOCKS <= 64,
+              "The valid blocks of each array must fit in a u64");
+
+static u64 AllBlocksMask(unsigned num_blocks) {
+    return num_blocks == 64 ? ~0ULL : (1ULL << num_blocks) - 1;
+}
+
+void ShaderSetup::WriteProgramCode(unsigned offset, u32 value) {
+    // Games commonly upload the same program before every draw, which must not invalidate the hash
+    if (program_code[offset] != value) {
+        program_code[offset] = value;
+        program_hash.valid_code_blocks &= ~(1ULL << (offset / PROGRAM_HASH_BLOCK_SIZE));
+    }
+}
+
+void ShaderSetup::WriteSwizzleData(unsigned offset, u32 value) {
+    if (swizzle_data[offset] != value) {
+        swizzle_data[offset] = value;
+        program_hash.valid_swizzle_blocks &= ~(1ULL << (offset / PROGRAM_HASH_BLOCK_SIZE));
+    }
+}
+
+MICROPROFILE_DEFINE(GPU_ShaderHash, "GPU", "Shader Hashing", MP_RGB(100, 100, 240));
+
+u64 ShaderSetup::GetProgramHash() {
+    const u64 all_code_blocks = AllBlocksMask(NUM_CODE_HASH_BLOCKS);
+    const u64 all_swizzle_blocks = AllBlocksMask(NUM_SWIZZLE_HASH_BLOCKS);
+    if (program_hash.valid_code_blocks == all_code_blocks &&
+        program_hash.valid_swizzle_blocks == all_swizzle_blocks) {
+        return program_hash.hash;
+    }
+
+    MICROPROFILE_SCOPE(GPU_ShaderHash);
+
+    constexpr size_t block_bytes = PROGRAM_HASH_BLOCK_SIZE * sizeof(u32);
+    for (int block : BitSet64(~program_hash.valid_code_blocks & all_code_blocks)) {
+        program_hash.block_hashes[block] = Common::ComputeHash64(
+            &program_code[block * PROGRAM_HASH_BLOCK_SIZE], block_bytes);
+    }
+    for (int block :
+         BitSet64(~program_hash.valid_swizzle_blocks & all_swizzle_blocks)) {
+        program_hash.block_hashes[NUM_CODE_HASH_BLOCKS + block] = Common::ComputeHash64(
+            &swizzle_data[block * PROGRAM_HASH_BLOCK_SIZE], block_bytes);
+    }
+
+    program_hash.valid_code_blocks = all_code_blocks;
+    program_hash.valid_swizzle_blocks = all_swizzle_blocks;
+    program_hash.hash = Common::ComputeHash64(program_hash.block_hashes.data(),
+                                              sizeof(program_hash.block_hashes));
+    return program_hash.hash;
+}
+
 MICROPROFILE_DEFINE(GPU_Shader, "GPU", "Shader", MP_RGB(50, 50, 240));
 
 #ifdef ARCHITECTURE_x86_64
@@ -27,6 +27,8 @@ namespace Shader {
 
 constexpr unsigned MAX_PROGRAM_CODE_LENGTH = 4096;
 constexpr unsigned MAX_SWIZZLE_DATA_LENGTH = 4096;
+/// Number of consecutive words of shader program or swizzle data hashed together
+constexpr unsigned PROGRAM_HASH_BLOCK_SIZE = 64;
 
 struct AttributeBuffer {
     alignas(16) Math::Vec4<float24> attr[16];
@@ -197,6 +199,32 @@ struct ShaderSetup {
     std::array<u32, MAX_PROGRAM_CODE_LENGTH> program_code;
     std::array<u32, MAX_SWIZZLE_DATA_LENGTH> swizzle_data;
 
+    /// Writes a word of program_code, keeping the hash returned by GetProgramHash up to date
+    void WriteProgramCode(unsigned offset, u32 value);
+
+    /// Writes a word of swizzle_data, keeping the hash returned by GetProgramHash up to date
+    void WriteSwizzleData(unsigned offset, u32 value);
+
+    /**
+     * Returns a hash of program_code and swizzle_data. The arrays are hashed in blocks of
+     * PROGRAM_HASH_BLOCK_SIZE words, and only the blocks modified since the last call are hashed
+     * again, so that a program that doesn't change between draws isn't hashed at all.
+     */
+    u64 GetProgramHash();
+
+    struct ProgramHash {
+        /// Hashes of the blocks of program_code, followed by the ones of swizzle_data
+        std::array<u64, (MAX_PROGRAM_CODE_LENGTH + MAX_SWIZZLE_DATA_LENGTH) /
+                            PROGRAM_HASH_BLOCK_SIZE>
+            block_hashes;
+        /// Bit i is set when the hash of block i is up to date. Zeroing the setup, as
+        /// State::Reset does, thus marks all blocks as modified.
+        u64 valid_code_blocks = 0;
+        u64 valid_swizzle_blocks = 0;
+        /// Hash of block_hashes, up to date when all blocks are
+        u64 hash;
+    } program_hash;
+
     /// Data private to ShaderEngines
     struct EngineData {
         unsigned int entry_point;
@@ -222,6 +250,16 @@ public:
      * @param state Shader unit state, must be setup with input data before each shader invocation.
      */
     virtual void Run(const ShaderSetup& setup, UnitState& state) const = 0;
+
+    /**
+     * Runs the currently setup shader on several shader units in a row, which saves the overhead
+     * of separate invocations.
+     *
+     * @param setup Shader engine state, must be setup with SetupBatch on each shader change.
+     * @param states Shader unit states, each setup with input data.
+     * @param count Number of shader units in states.
+     */
+    virtual void RunBatch(const ShaderSetup& setup, UnitState* states, unsigned count) const = 0;
 };
 
 // TODO(yuriks): Remove and make it non-global state somewhere
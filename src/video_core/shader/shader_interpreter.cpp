@@ -18,6 +18,9 @@
 #include "video_core/pica_types.h"
 #include "video_core/shader/shader.h"
 #include "video_core/shader/shader_interpreter.h"
+#ifdef ARCHITECTURE_x86_64
+#include "video_core/shader/shader_interpreter_simd.h"
+#endif // ARCHITECTURE_x86_64
 
 using nihstro::OpCode;
 using nihstro::Instruction;
@@ -29,15 +32,6 @@ namespace Pica {
 
 namespace Shader {
 
-struct CallStackElement {
-    u32 final_address;  // Address upon which we jump to return_address
-    u32 return_address; // Where to jump when leaving scope
-    u8 repeat_counter;  // How often to repeat until this call stack element is removed
-    u8 loop_increment;  // Which value to add to the loop counter after an iteration
-                        // TODO: Should this be a signed value? Does it even matter?
-    u32 loop_address;   // The address where we'll return to after each loop iteration
-};
-
 template <bool Debug>
 static void RunInterpreter(const ShaderSetup& setup, UnitState& state, DebugData<Debug>& debug_data,
                            unsigned offset) {
@@ -683,6 +677,23 @@ void InterpreterEngine::Run(const ShaderSetup& setup, UnitState& state) const {
     RunInterpreter(setup, state, dummy_debug_data, setup.engine_data.entry_point);
 }
 
+void InterpreterEngine::RunBatch(const ShaderSetup& setup, UnitState* states,
+                                 unsigned count) const {
+    MICROPROFILE_SCOPE(GPU_Shader);
+
+#ifdef ARCHITECTURE_x86_64
+    for (unsigned i = 0; i < count; i += SIMD_LANE_COUNT) {
+        RunSimdInterpreter(setup, states + i, std::min(count - i, SIMD_LANE_COUNT),
+                           setup.engine_data.entry_point);
+    }
+#else
+    DebugData<false> dummy_debug_data;
+    for (unsigned i = 0; i < count; ++i) {
+        RunInterpreter(setup, states[i], dummy_debug_data, setup.engine_data.entry_point);
+    }
+#endif // ARCHITECTURE_x86_64
+}
+
 DebugData<true> InterpreterEngine::ProduceDebugInfo(const ShaderSetup& setup,
                                                     const AttributeBuffer& input,
                                                     const ShaderRegs& config) const {
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "common/common_types.h"
 #include "video_core/shader/debug_data.h"
 #include "video_core/shader/shader.h"
 
@@ -11,10 +12,20 @@ namespace Pica {
 
 namespace Shader {
 
+struct CallStackElement {
+    u32 final_address;  // Address upon which we jump to return_address
+    u32 return_address; // Where to jump when leaving scope
+    u8 repeat_counter;  // How often to repeat until this call stack element is removed
+    u8 loop_increment;  // Which value to add to the loop counter after an iteration
+                        // TODO: Should this be a signed value? Does it even matter?
+    u32 loop_address;   // The address where we'll return to after each loop iteration
+};
+
 class InterpreterEngine final : public ShaderEngine {
 public:
     void SetupBatch(ShaderSetup& setup, unsigned int entry_point) override;
     void Run(const ShaderSetup& setup, UnitState& state) const override;
+    void RunBatch(const ShaderSetup& setup, UnitState* states, unsigned count) const override;
 
     /**
      * Produce debug information based on the given shader and input vertex
@@ -0,0 +1,817 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <boost/container/static_vector.hpp>
+#include <emmintrin.h>
+#include <nihstro/shader_bytecode.h>
+#include "common/assert.h"
+#include "common/common_types.h"
+#include "common/logging/log.h"
+#include "common/vector_math.h"
+#include "video_core/pica_types.h"
+#include "video_core/shader/shader.h"
+#include "video_core/shader/shader_interpreter.h"
+#include "video_core/shader/shader_interpreter_simd.h"
+
+using nihstro::OpCode;
+using nihstro::Instruction;
+using nihstro::RegisterType;
+using nihstro::SourceRegister;
+using nihstro::SwizzlePattern;
+
+namespace Pica {
+
+namespace Shader {
+
+static_assert(sizeof(Math::Vec4<float24>) == sizeof(__m128), "Registers can't be loaded with SSE");
+
+/// A register of all the lanes. Component i of the register of lane l is in lane l of c[i].
+struct LaneVec4 {
+    __m128 c[4];
+};
+
+/// Control flow state of the shader unit in a lane
+struct LaneState {
+    // TODO: Is there a maximal size for this?
+    boost::container::static_vector<CallStackElement, 16> call_stack;
+    u32 program_counter;
+    bool conditional_code[2];
+    s32 address_registers[3];
+};
+
+using RegisterFile = Math::Vec4<float24> (UnitState::Registers::*)[16];
+
+/**
+ * A register file of the shader units in structure-of-arrays form. Each register is transposed
+ * from the shader units when it's first used, and only the written ones are transposed back.
+ */
+class LaneRegisterFile {
+public:
+    LaneRegisterFile(UnitState* units, unsigned count, RegisterFile file)
+        : units(units), count(count), file(file) {}
+
+    const LaneVec4& Read(int index) {
+        if (!(loaded & (1 << index)))
+            Load(index);
+        return registers[index];
+    }
+
+    LaneVec4& Write(int index) {
+        if (!(loaded & (1 << index)))
+            Load(index);
+        written |= 1 << index;
+        return registers[index];
+    }
+
+    /// Transposes the written registers back into the shader units
+    void Store() const {
+        for (int i = 0; i < 16; ++i) {
+            if (!(written & (1 << i)))
+                continue;
+
+            __m128 rows[SIMD_LANE_COUNT] = {registers[i].c[0], registers[i].c[1],
+                                            registers[i].c[2], registers[i].c[3]};
+            _MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+            for (unsigned lane = 0; lane < count; ++lane)
+                _mm_store_ps(UnitRegister(lane, i), rows[lane]);
+        }
+    }
+
+private:
+    /// Returns a register of the unit in a lane, or of the first unit for lanes without a unit
+    float* UnitRegister(unsigned lane, int index) const {
+        UnitState& unit = units[(lane < count) ? lane : 0];
+        return reinterpret_cast<float*>(&(unit.registers.*file)[index]);
+    }
+
+    void Load(int index) {
+        __m128 row0 = _mm_load_ps(UnitRegister(0, index));
+        __m128 row1 = _mm_load_ps(UnitRegister(1, index));
+        __m128 row2 = _mm_load_ps(UnitRegister(2, index));
+        __m128 row3 = _mm_load_ps(UnitRegister(3, index));
+        _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+        registers[index] = {{row0, row1, row2, row3}};
+        loaded |= 1 << index;
+    }
+
+    UnitState* units;
+    unsigned count;
+    RegisterFile file;
+    u16 loaded = 0;
+    u16 written = 0;
+    LaneVec4 registers[16];
+};
+
+/// Calls function with the index of each lane whose bit is set in lanes
+template <typename F>
+static void ForEachLane(unsigned lanes, F function) {
+    for (unsigned lane = 0; lane < SIMD_LANE_COUNT; ++lane) {
+        if (lanes & (1 << lane))
+            function(lane);
+    }
+}
+
+/// Returns the index of the first lane whose bit is set in lanes, which must not be 0
+static unsigned FirstLane(unsigned lanes) {
+    unsigned lane = 0;
+    while (!(lanes & (1 << lane)))
+        ++lane;
+    return lane;
+}
+
+/// Returns whether two lanes are at the same point of the program, with the same call stack
+static bool SameControlFlow(const LaneState& a, const LaneState& b) {
+    return a.program_counter == b.program_counter &&
+           a.address_registers[2] == b.address_registers[2] &&
+           a.call_stack.size() == b.call_stack.size() &&
+           std::equal(a.call_stack.begin(), a.call_stack.end(), b.call_stack.begin(),
+                      [](const CallStackElement& x, const CallStackElement& y) {
+                          return x.final_address == y.final_address &&
+                                 x.return_address == y.return_address &&
+                                 x.repeat_counter == y.repeat_counter &&
+                                 x.loop_increment == y.loop_increment &&
+                                 x.loop_address == y.loop_address;
+                      });
+}
+
+/// Returns a mask selecting the lanes whose bit is set in lanes
+static __m128 LaneMask(unsigned lanes) {
+    const __m128i bits = _mm_set_epi32(8, 4, 2, 1);
+    return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(lanes), bits), bits));
+}
+
+/// Returns the lanes of a where mask is set, and those of b elsewhere
+static __m128 Select(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+/// Multiplies like float24::operator*, which gives 0 instead of NaN when multiplying by inf
+static __m128 Mul(__m128 a, __m128 b) {
+    const __m128 result = _mm_mul_ps(a, b);
+    const __m128 nan_result = _mm_cmpunord_ps(result, result);
+    const __m128 nan_input = _mm_cmpunord_ps(a, b);
+    return _mm_andnot_ps(_mm_andnot_ps(nan_input, nan_result), result);
+}
+
+/// Applies a scalar function to each lane, for the operations SSE2 has no instruction for
+template <typename F>
+static __m128 MapLanes(__m128 value, F function) {
+    alignas(16) float lanes[SIMD_LANE_COUNT];
+    _mm_store_ps(lanes, value);
+    for (float& lane : lanes)
+        lane = function(lane);
+    return _mm_load_ps(lanes);
+}
+
+void RunSimdInterpreter(const ShaderSetup& setup, UnitState* states, unsigned count,
+                        unsigned offset) {
+    ASSERT(count > 0 && count <= SIMD_LANE_COUNT);
+
+    // The lanes without a shader unit work on copies of the registers of the first one, and never
+    // become active
+    LaneRegisterFile input(states, count, &UnitState::Registers::input);
+    LaneRegisterFile temporary(states, count, &UnitState::Registers::temporary);
+    LaneRegisterFile output(states, count, &UnitState::Registers::output);
+
+    std::array<LaneState, SIMD_LANE_COUNT> lanes;
+    for (unsigned lane = 0; lane < count; ++lane) {
+        lanes[lane].program_counter = offset;
+        lanes[lane].conditional_code[0] = false;
+        lanes[lane].conditional_code[1] = false;
+        std::copy(std::begin(states[lane].address_registers),
+                  std::end(states[lane].address_registers),
+                  std::begin(lanes[lane].address_registers));
+    }
+    unsigned running_lanes = (1 << count) - 1;
+
+    // While all the running lanes are at the same point of the program with the same call stack,
+    // only the control flow state of the first one is kept up to date
+    bool converged = true;
+
+    // Leaves the scopes of the call stack that end at the program counter of the lane. The loop
+    // counter is updated for all the given lanes.
+    auto leave_scopes = [&lanes](LaneState& lane, unsigned lanes_to_update) {
+        while (!lane.call_stack.empty()) {
+            auto& top = lane.call_stack.back();
+            if (lane.program_counter != top.final_address)
+                break;
+
+            ForEachLane(lanes_to_update,
+                        [&](unsigned l) { lanes[l].address_registers[2] += top.loop_increment; });
+
+            if (top.repeat_counter-- == 0) {
+                lane.program_counter = top.return_address;
+                lane.call_stack.pop_back();
+            } else {
+                lane.program_counter = top.loop_address;
+            }
+        }
+    };
+
+    auto call = [](LaneState& lane, u32 offset, u32 num_instructions, u32 return_offset,
+                   u8 repeat_count, u8 loop_increment) {
+        // -1 to make sure when incrementing the PC we end up at the correct offset
+        lane.program_counter = offset - 1;
+        ASSERT(lane.call_stack.size() < lane.call_stack.capacity());
+        lane.call_stack.push_back(
+            {offset + num_instructions, return_offset, repeat_count, loop_increment, offset});
+    };
+
+    auto evaluate_condition = [](const LaneState& lane,
+                                 Instruction::FlowControlType flow_control) {
+        using Op = Instruction::FlowControlType::Op;
+
+        bool result_x = flow_control.refx.Value() == lane.conditional_code[0];
+        bool result_y = flow_control.refy.Value() == lane.conditional_code[1];
+
+        switch (flow_control.op) {
+        case Op::Or:
+            return result_x || result_y;
+        case Op::And:
+            return result_x && result_y;
+        case Op::JustX:
+            return result_x;
+        case Op::JustY:
+            return result_y;
+        default:
+            UNREACHABLE();
+            return false;
+        }
+    };
+
+    const auto& uniforms = setup.uniforms;
+    const auto& swizzle_data = setup.swizzle_data;
+    const auto& program_code = setup.program_code;
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 sign_bit = _mm_set1_ps(-0.0f);
+
+    // Placeholder for invalid outputs
+    LaneVec4 dummy_register;
+
+    while (running_lanes != 0) {
+        const unsigned first_running_lane = FirstLane(running_lanes);
+        u32 program_counter = std::numeric_limits<u32>::max();
+        unsigned active_lanes = 0;
+        if (converged) {
+            LaneState& lane = lanes[first_running_lane];
+            leave_scopes(lane, running_lanes);
+            program_counter = lane.program_counter;
+            active_lanes = running_lanes;
+        } else {
+            // The lanes at the lowest program counter execute the next instruction, so that lanes
+            // which took different paths through the program join again when the paths do.
+            ForEachLane(running_lanes, [&](unsigned l) {
+                LaneState& lane = lanes[l];
+                leave_scopes(lane, 1 << l);
+
+                if (lane.program_counter < program_counter) {
+                    program_counter = lane.program_counter;
+                    active_lanes = 1 << l;
+                } else if (lane.program_counter == program_counter) {
+                    active_lanes |= 1 << l;
+                }
+            });
+
+            if (active_lanes == running_lanes) {
+                const LaneState& first = lanes[first_running_lane];
+                converged = true;
+                ForEachLane(running_lanes,
+                            [&](unsigned l) { converged &= SameControlFlow(lanes[l], first); });
+            }
+        }
+        const __m128 active_mask = LaneMask(active_lanes);
+
+        const Instruction instr = {program_code[program_counter]};
+        const SwizzlePattern swizzle = {swizzle_data[instr.common.operand_desc_id]};
+
+        // Returns the source register. Uniforms are broadcast to all the lanes of scratch.
+        auto LookupSourceRegister = [&](const SourceRegister& source_reg,
+                                        LaneVec4& scratch) -> const LaneVec4& {
+            switch (source_reg.GetRegisterType()) {
+            case RegisterType::Input:
+                return input.Read(source_reg.GetIndex());
+
+            case RegisterType::Temporary:
+                return temporary.Read(source_reg.GetIndex());
+
+            case RegisterType::FloatUniform: {
+                const auto& uniform = uniforms.f[source_reg.GetIndex()];
+                scratch = {{_mm_set1_ps(uniform.x.ToFloat32()),
+                            _mm_set1_ps(uniform.y.ToFloat32()),
+                            _mm_set1_ps(uniform.z.ToFloat32()),
+                            _mm_set1_ps(uniform.w.ToFloat32())}};
+                return scratch;
+            }
+
+            default:
+                scratch = {{zero, zero, zero, zero}};
+                return scratch;
+            }
+        };
+
+        // Reads the source register, offset by the given address register (if not 0) of each lane
+        auto ReadSourceRegister = [&](SourceRegister source_reg, unsigned address_register_index,
+                                      LaneVec4& scratch) -> const LaneVec4& {
+            if (address_register_index == 0)
+                return LookupSourceRegister(source_reg, scratch);
+
+            // The lanes usually have the same offset, and then read the same register
+            const unsigned first_lane = FirstLane(active_lanes);
+            const int first_offset =
+                lanes[first_lane].address_registers[address_register_index - 1];
+            bool same_offset = true;
+            ForEachLane(active_lanes, [&](unsigned l) {
+                same_offset &= (lanes[l].address_registers[address_register_index - 1] ==
+                                first_offset);
+            });
+            if (same_offset)
+                return LookupSourceRegister(source_reg + first_offset, scratch);
+
+            // The lanes read different registers, which are gathered one lane at a time
+            alignas(16) float values[4][SIMD_LANE_COUNT] = {};
+            ForEachLane(active_lanes, [&](unsigned l) {
+                LaneVec4 lane_scratch;
+                const LaneVec4& lane_reg = LookupSourceRegister(
+                    source_reg + lanes[l].address_registers[address_register_index - 1],
+                    lane_scratch);
+                for (int i = 0; i < 4; ++i) {
+                    alignas(16) float components[SIMD_LANE_COUNT];
+                    _mm_store_ps(components, lane_reg.c[i]);
+                    values[i][l] = components[l];
+                }
+            });
+            scratch = {{_mm_load_ps(values[0]), _mm_load_ps(values[1]), _mm_load_ps(values[2]),
+                        _mm_load_ps(values[3])}};
+            return scratch;
+        };
+
+        // Writes the components enabled in the swizzle pattern to the active lanes of dest
+        auto WriteDestRegister = [&](const SwizzlePattern& swizzle, LaneVec4* dest,
+                                     const __m128 (&result)[4]) {
+            for (int i = 0; i < 4; ++i) {
+                if (!swizzle.DestComponentEnabled(i))
+                    continue;
+
+                dest->c[i] = Select(active_mask, result[i], dest->c[i]);
+            }
+        };
+
+        switch (instr.opcode.Value().GetInfo().type) {
+        case OpCode::Type::Arithmetic: {
+            const bool is_inverted =
+                (0 != (instr.opcode.Value().GetInfo().subtype & OpCode::Info::SrcInversed));
+
+            const unsigned address_register_index = instr.common.address_register_index;
+
+            LaneVec4 scratch1, scratch2;
+            const LaneVec4& src1_ =
+                ReadSourceRegister(instr.common.GetSrc1(is_inverted),
+                                   is_inverted ? 0 : address_register_index, scratch1);
+            const LaneVec4& src2_ =
+                ReadSourceRegister(instr.common.GetSrc2(is_inverted),
+                                   is_inverted ? address_register_index : 0, scratch2);
+
+            const bool negate_src1 = ((bool)swizzle.negate_src1 != false);
+            const bool negate_src2 = ((bool)swizzle.negate_src2 != false);
+
+            __m128 src1[4] = {
+                src1_.c[(int)swizzle.src1_selector_0.Value()],
+                src1_.c[(int)swizzle.src1_selector_1.Value()],
+                src1_.c[(int)swizzle.src1_selector_2.Value()],
+                src1_.c[(int)swizzle.src1_selector_3.Value()],
+            };
+            if (negate_src1) {
+                for (__m128& component : src1)
+                    component = _mm_xor_ps(component, sign_bit);
+            }
+            __m128 src2[4] = {
+                src2_.c[(int)swizzle.src2_selector_0.Value()],
+                src2_.c[(int)swizzle.src2_selector_1.Value()],
+                src2_.c[(int)swizzle.src2_selector_2.Value()],
+                src2_.c[(int)swizzle.src2_selector_3.Value()],
+            };
+            if (negate_src2) {
+                for (__m128& component : src2)
+                    component = _mm_xor_ps(component, sign_bit);
+            }
+
+            LaneVec4* dest =
+                (instr.common.dest.Value() < 0x10)
+                    ? &output.Write(instr.common.dest.Value().GetIndex())
+                    : (instr.common.dest.Value() < 0x20)
+                          ? &temporary.Write(instr.common.dest.Value().GetIndex())
+                          : &dummy_register;
+
+            __m128 result[4];
+            switch (instr.opcode.Value().EffectiveOpCode()) {
+            case OpCode::Id::ADD:
+                for (int i = 0; i < 4; ++i)
+                    result[i] = _mm_add_ps(src1[i], src2[i]);
+                WriteDestRegister(swizzle, dest, result);
+                break;
+
+            case OpCode::Id::MUL:
+                for (int i = 0; i < 4; ++i)
+                    result[i] = Mul(src1[i], src2[i]);
+                WriteDestRegister(swizzle, dest, result);
+                break;
+
+            case OpCode::Id::FLR:
+                for (int i = 0; i < 4; ++i)
+                    result[i] = MapLanes(src1[i], [](float x) { return std::floor(x); });
+                WriteDestRegister(swizzle, dest, result);
+                break;
+
+            // MAXPS and MINPS return the second operand if either is NaN, which matches the NaN
+            // semantics required by hardware (see the interpreter)
+            case OpCode::Id::MAX:
+                for (int i = 0; i < 4; ++i)
+                    result[i] = _mm_max_ps(src1[i], src2[i]);
+                WriteDestRegister(swizzle, dest, result);
+                break;
+
+            case OpCode::Id::MIN:
+                for (int i = 0; i < 4; ++i)
+                    result[i] = _mm_min_ps(src1[i], src2[i]);
+                WriteDestRegister(swizzle, dest, result);
+                break;
+
+            case OpCode::Id::DP3:
+            case OpCode::Id::DP4:
+            case OpCode::Id::DPH:
+            case OpCode::Id::DPHI: {
+                OpCode::Id opcode = instr.opcode.Value().EffectiveOpCode();
+                if (opcode == OpCode::Id::DPH || opcode == OpCode::Id::DPHI)
+                    src1[3] = one;
+
+                int num_components = (opcode == OpCode::Id::DP3) ? 3 : 4;
+                __m128 dot = zero;
+                for (int i = 0; i < num_components; ++i)
+                    dot = _mm_add_ps(dot, Mul(src1[i], src2[i]));
+
+                result[0] = result[1] = result[2] = result[3] = dot;
+                WriteDestRegister(swizzle, dest, result);
+                break;
+            }
+
+            // Reciprocal
+            case OpCode::Id::RCP:
+                result[0] = result[1] = result[2] = result[3] = _mm_div_ps(one, src1[0]);
+                WriteDestRegister(swizzle, dest, result);
+                break;
+
+            // Reciprocal Square Root
+            case OpCode::Id::RSQ:
+                result[0] = result[1] = result[2] = result[3] =
+                    _mm_div_ps(one, _mm_sqrt_ps(src1[0]));
+                WriteDestRegister(swizzle, dest, result);
+                break;
+
+            case OpCode::Id::MOVA: {
+                alignas(16) float values[2][SIMD_LANE_COUNT];
+                _mm_store_ps(values[0], src1[0]);
+                _mm_store_ps(values[1], src1[1]);
+                for (int i = 0; i < 2; ++i) {
+                    if (!swizzle.DestComponentEnabled(i))
+                        continue;
+
+                    // TODO: Figure out how the rounding is done on hardware
+                    ForEachLane(active_lanes, [&](unsigned l) {
+                        lanes[l].address_registers[i] = static_cast<s32>(values[i][l]);
+                    });
+                }
+                break;
+            }
+
+            case OpCode::Id::MOV:
+                WriteDestRegister(swizzle, dest, src1);
+                break;
+
+            case OpCode::Id::SGE:
+            case OpCode::Id::SGEI:
+                for (int i = 0; i < 4; ++i)
+                    result[i] = _mm_and_ps(_mm_cmpge_ps(src1[i], src2[i]), one);
+                WriteDestRegister(swizzle, dest, result);
+                break;
+
+            case OpCode::Id::SLT:
+            case OpCode::Id::SLTI:
+                for (int i = 0; i < 4; ++i)
+                    result[i] = _mm_and_ps(_mm_cmplt_ps(src1[i], src2[i]), one);
+                WriteDestRegister(swizzle, dest, result);
+                break;
+
+            case OpCode::Id::CMP:
+                for (int i = 0; i < 2; ++i) {
+                    // TODO: Can you restrict to one compare via dest masking?
+
+                    auto compare_op = instr.common.compare_op;
+                    auto op = (i == 0) ? compare_op.x.Value() : compare_op.y.Value();
+
+                    __m128 compare_result;
+                    switch (op) {
+                    case Instruction::Common::CompareOpType::Equal:
+                        compare_result = _mm_cmpeq_ps(src1[i], src2[i]);
+                        break;
+
+                    case Instruction::Common::CompareOpType::NotEqual:
+                        compare_result = _mm_cmpneq_ps(src1[i], src2[i]);
+                        break;
+
+                    case Instruction::Common::CompareOpType::LessThan:
+                        compare_result = _mm_cmplt_ps(src1[i], src2[i]);
+                        break;
+
+                    case Instruction::Common::CompareOpType::LessEqual:
+                        compare_result = _mm_cmple_ps(src1[i], src2[i]);
+                        break;
+
+                    case Instruction::Common::CompareOpType::GreaterThan:
+                        compare_result = _mm_cmpgt_ps(src1[i], src2[i]);
+                        break;
+
+                    case Instruction::Common::CompareOpType::GreaterEqual:
+                        compare_result = _mm_cmpge_ps(src1[i], src2[i]);
+                        break;
+
+                    default:
+                        LOG_ERROR(HW_GPU, "Unknown compare mode %x", static_cast<int>(op));
+                        continue;
+                    }
+
+                    const int compare_bits = _mm_movemask_ps(compare_result);
+                    ForEachLane(active_lanes, [&](unsigned l) {
+                        lanes[l].conditional_code[i] = (compare_bits & (1 << l)) != 0;
+                    });
+                }
+                break;
+
+            // EX2 and LG2 only take the first component and write the result to all dest
+            // components
+            case OpCode::Id::EX2:
+                result[0] = result[1] = result[2] = result[3] =
+                    MapLanes(src1[0], [](float x) { return std::exp2(x); });
+                WriteDestRegister(swizzle, dest, result);
+                break;
+
+            case OpCode::Id::LG2:
+                result[0] = result[1] = result[2] = result[3] =
+                    MapLanes(src1[0], [](float x) { return std::log2(x); });
+                WriteDestRegister(swizzle, dest, result);
+                break;
+
+            default:
+                LOG_ERROR(HW_GPU, "Unhandled arithmetic instruction: 0x%02x (%s): 0x%08x",
+                          (int)instr.opcode.Value().EffectiveOpCode(),
+                          instr.opcode.Value().GetInfo().name, instr.hex);
+                DEBUG_ASSERT(false);
+                break;
+            }
+
+            break;
+        }
+
+        case OpCode::Type::MultiplyAdd: {
+            if ((instr.opcode.Value().EffectiveOpCode() == OpCode::Id::MAD) ||
+                (instr.opcode.Value().EffectiveOpCode() == OpCode::Id::MADI)) {
+                const SwizzlePattern& swizzle = *reinterpret_cast<const SwizzlePattern*>(
+                    &swizzle_data[instr.mad.operand_desc_id]);
+
+                bool is_inverted = (instr.opcode.Value().EffectiveOpCode() == OpCode::Id::MADI);
+
+                const unsigned address_register_index = instr.mad.address_register_index;
+
+                LaneVec4 scratch1, scratch2, scratch3;
+                const LaneVec4& src1_ =
+                    ReadSourceRegister(instr.mad.GetSrc1(is_inverted), 0, scratch1);
+                const LaneVec4& src2_ =
+                    ReadSourceRegister(instr.mad.GetSrc2(is_inverted),
+                                       is_inverted ? 0 : address_register_index, scratch2);
+                const LaneVec4& src3_ =
+                    ReadSourceRegister(instr.mad.GetSrc3(is_inverted),
+                                       is_inverted ? address_register_index : 0, scratch3);
+
+                const bool negate_src1 = ((bool)swizzle.negate_src1 != false);
+                const bool negate_src2 = ((bool)swizzle.negate_src2 != false);
+                const bool negate_src3 = ((bool)swizzle.negate_src3 != false);
+
+                __m128 src1[4] = {
+                    src1_.c[(int)swizzle.src1_selector_0.Value()],
+                    src1_.c[(int)swizzle.src1_selector_1.Value()],
+                    src1_.c[(int)swizzle.src1_selector_2.Value()],
+                    src1_.c[(int)swizzle.src1_selector_3.Value()],
+                };
+                if (negate_src1) {
+                    for (__m128& component : src1)
+                        component = _mm_xor_ps(component, sign_bit);
+                }
+                __m128 src2[4] = {
+                    src2_.c[(int)swizzle.src2_selector_0.Value()],
+                    src2_.c[(int)swizzle.src2_selector_1.Value()],
+                    src2_.c[(int)swizzle.src2_selector_2.Value()],
+                    src2_.c[(int)swizzle.src2_selector_3.Value()],
+                };
+                if (negate_src2) {
+                    for (__m128& component : src2)
+                        component = _mm_xor_ps(component, sign_bit);
+                }
+                __m128 src3[4] = {
+                    src3_.c[(int)swizzle.src3_selector_0.Value()],
+                    src3_.c[(int)swizzle.src3_selector_1.Value()],
+                    src3_.c[(int)swizzle.src3_selector_2.Value()],
+                    src3_.c[(int)swizzle.src3_selector_3.Value()],
+                };
+                if (negate_src3) {
+                    for (__m128& component : src3)
+                        component = _mm_xor_ps(component, sign_bit);
+                }
+
+                LaneVec4* dest =
+                    (instr.mad.dest.Value() < 0x10)
+                        ? &output.Write(instr.mad.dest.Value().GetIndex())
+                        : (instr.mad.dest.Value() < 0x20)
+                              ? &temporary.Write(instr.mad.dest.Value().GetIndex())
+                              : &dummy_register;
+
+                __m128 result[4];
+                for (int i = 0; i < 4; ++i)
+                    result[i] = _mm_add_ps(Mul(src1[i], src2[i]), src3[i]);
+                WriteDestRegister(swizzle, dest, result);
+            } else {
+                LOG_ERROR(HW_GPU, "Unhandled multiply-add instruction: 0x%02x (%s): 0x%08x",
+                          (int)instr.opcode.Value().EffectiveOpCode(),
+                          instr.opcode.Value().GetInfo().name, instr.hex);
+            }
+            break;
+        }
+
+        default: {
+            // Handle each instruction on its own, on the control flow state of the given lanes
+            auto execute = [&](LaneState& lane, unsigned lanes_to_update) {
+                switch (instr.opcode.Value()) {
+                case OpCode::Id::END:
+                    running_lanes &= ~lanes_to_update;
+                    break;
+
+                case OpCode::Id::JMPC:
+                    if (evaluate_condition(lane, instr.flow_control)) {
+                        lane.program_counter = instr.flow_control.dest_offset - 1;
+                    }
+                    break;
+
+                case OpCode::Id::JMPU:
+                    if (uniforms.b[instr.flow_control.bool_uniform_id] ==
+                        !(instr.flow_control.num_instructions & 1)) {
+                        lane.program_counter = instr.flow_control.dest_offset - 1;
+                    }
+                    break;
+
+                case OpCode::Id::CALL:
+                    call(lane, instr.flow_control.dest_offset,
+                         instr.flow_control.num_instructions, lane.program_counter + 1, 0, 0);
+                    break;
+
+                case OpCode::Id::CALLU:
+                    if (uniforms.b[instr.flow_control.bool_uniform_id]) {
+                        call(lane, instr.flow_control.dest_offset,
+                             instr.flow_control.num_instructions, lane.program_counter + 1, 0,
+                             0);
+                    }
+                    break;
+
+                case OpCode::Id::CALLC:
+                    if (evaluate_condition(lane, instr.flow_control)) {
+                        call(lane, instr.flow_control.dest_offset,
+                             instr.flow_control.num_instructions, lane.program_counter + 1, 0,
+                             0);
+                    }
+                    break;
+
+                case OpCode::Id::NOP:
+                    break;
+
+                case OpCode::Id::IFU:
+                    if (uniforms.b[instr.flow_control.bool_uniform_id]) {
+                        call(lane, lane.program_counter + 1,
+                             instr.flow_control.dest_offset - lane.program_counter - 1,
+                             instr.flow_control.dest_offset + instr.flow_control.num_instructions,
+                             0, 0);
+                    } else {
+                        call(lane, instr.flow_control.dest_offset,
+                             instr.flow_control.num_instructions,
+                             instr.flow_control.dest_offset + instr.flow_control.num_instructions,
+                             0, 0);
+                    }
+                    break;
+
+                case OpCode::Id::IFC:
+                    // TODO: Do we need to consider swizzlers here?
+                    if (evaluate_condition(lane, instr.flow_control)) {
+                        call(lane, lane.program_counter + 1,
+                             instr.flow_control.dest_offset - lane.program_counter - 1,
+                             instr.flow_control.dest_offset + instr.flow_control.num_instructions,
+                             0, 0);
+                    } else {
+                        call(lane, instr.flow_control.dest_offset,
+                             instr.flow_control.num_instructions,
+                             instr.flow_control.dest_offset + instr.flow_control.num_instructions,
+                             0, 0);
+                    }
+                    break;
+
+                case OpCode::Id::LOOP: {
+                    Math::Vec4<u8> loop_param(uniforms.i[instr.flow_control.int_uniform_id].x,
+                                              uniforms.i[instr.flow_control.int_uniform_id].y,
+                                              uniforms.i[instr.flow_control.int_uniform_id].z,
+                                              uniforms.i[instr.flow_control.int_uniform_id].w);
+                    ForEachLane(lanes_to_update,
+                                [&](unsigned l) { lanes[l].address_registers[2] = loop_param.y; });
+
+                    call(lane, lane.program_counter + 1,
+                         instr.flow_control.dest_offset - lane.program_counter,
+                         instr.flow_control.dest_offset + 1, loop_param.x, loop_param.z);
+                    break;
+                }
+
+                case OpCode::Id::EMIT:
+                    output.Store();
+                    ForEachLane(lanes_to_update, [&](unsigned l) {
+                        GSEmitter* emitter = states[l].emitter_ptr;
+                        ASSERT_MSG(emitter, "Execute EMIT on VS");
+                        emitter->Emit(states[l].registers.output);
+                    });
+                    break;
+
+                case OpCode::Id::SETEMIT:
+                    ForEachLane(lanes_to_update, [&](unsigned l) {
+                        GSEmitter* emitter = states[l].emitter_ptr;
+                        ASSERT_MSG(emitter, "Execute SETEMIT on VS");
+                        emitter->vertex_id = instr.setemit.vertex_id;
+                        emitter->prim_emit = instr.setemit.prim_emit != 0;
+                        emitter->winding = instr.setemit.winding != 0;
+                    });
+                    break;
+
+                default:
+                    LOG_ERROR(HW_GPU, "Unhandled instruction: 0x%02x (%s): 0x%08x",
+                              (int)instr.opcode.Value().EffectiveOpCode(),
+                              instr.opcode.Value().GetInfo().name, instr.hex);
+                    break;
+                }
+            };
+
+            const OpCode::Id opcode = instr.opcode.Value().EffectiveOpCode();
+            if (converged && (opcode == OpCode::Id::JMPC || opcode == OpCode::Id::CALLC ||
+                              opcode == OpCode::Id::IFC)) {
+                // The lanes split up when the condition differs between them
+                const LaneState& first = lanes[first_running_lane];
+                const bool condition = evaluate_condition(first, instr.flow_control);
+                ForEachLane(running_lanes, [&](unsigned l) {
+                    converged &= (evaluate_condition(lanes[l], instr.flow_control) == condition);
+                });
+                if (!converged) {
+                    ForEachLane(running_lanes & ~(1 << first_running_lane), [&](unsigned l) {
+                        lanes[l].program_counter = first.program_counter;
+                        lanes[l].call_stack = first.call_stack;
+                    });
+                }
+            }
+
+            if (converged) {
+                execute(lanes[first_running_lane], active_lanes);
+            } else {
+                ForEachLane(active_lanes, [&](unsigned l) { execute(lanes[l], 1 << l); });
+            }
+            break;
+        }
+        }
+
+        if (converged) {
+            ++lanes[first_running_lane].program_counter;
+        } else {
+            ForEachLane(active_lanes, [&](unsigned l) { ++lanes[l].program_counter; });
+        }
+    }
+
+    temporary.Store();
+    output.Store();
+    for (unsigned lane = 0; lane < count; ++lane) {
+        states[lane].conditional_code[0] = lanes[lane].conditional_code[0];
+        states[lane].conditional_code[1] = lanes[lane].conditional_code[1];
+        std::copy(std::begin(lanes[lane].address_registers),
+                  std::end(lanes[lane].address_registers),
+                  std::begin(states[lane].address_registers));
+    }
+}
+
+} // namespace
+
+} // namespace
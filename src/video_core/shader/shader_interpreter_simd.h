@@ -0,0 +1,32 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "video_core/shader/shader.h"
+
+namespace Pica {
+
+namespace Shader {
+
+/// Number of shader units run by RunSimdInterpreter at once, one in each lane of an SSE register
+constexpr unsigned SIMD_LANE_COUNT = 4;
+
+/**
+ * Runs the shader on up to SIMD_LANE_COUNT shader units at once, with the same results as running
+ * the interpreter on each of them. The registers are kept in structure-of-arrays form, so that each
+ * arithmetic instruction is decoded once and executed on all the units with SSE instructions.
+ * Units taking different paths through the program are run under a lane mask: at each step, the
+ * units at the lowest program counter execute their next instruction, and the others wait.
+ * @param setup Shader engine state
+ * @param states The shader units to run the shader on
+ * @param count Number of shader units, between 1 and SIMD_LANE_COUNT
+ * @param offset Entry point of the shader program
+ */
+void RunSimdInterpreter(const ShaderSetup& setup, UnitState* states, unsigned count,
+                        unsigned offset);
+
+} // namespace
+
+} // namespace
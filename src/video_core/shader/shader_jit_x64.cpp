@@ -2,11 +2,12 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include "common/hash.h"
 #include "common/microprofile.h"
 #include "video_core/shader/shader.h"
 #include "video_core/shader/shader_jit_x64.h"
 #include "video_core/shader/shader_jit_x64_compiler.h"
+#include "video_core/shader_disk_cache.h"
+#include "video_core/video_core.h"
 
 namespace Pica {
 namespace Shader {
@@ -18,16 +19,20 @@ void JitX64Engine::SetupBatch(ShaderSetup& setup, unsigned int entry_point) {
     ASSERT(entry_point < MAX_PROGRAM_CODE_LENGTH);
     setup.engine_data.entry_point = entry_point;
 
-    u64 code_hash = Common::ComputeHash64(&setup.program_code, sizeof(setup.program_code));
-    u64 swizzle_hash = Common::ComputeHash64(&setup.swizzle_data, sizeof(setup.swizzle_data));
-
-    u64 cache_key = code_hash ^ swizzle_hash;
+    u64 cache_key = setup.GetProgramHash();
     auto iter = cache.find(cache_key);
     if (iter != cache.end()) {
         setup.engine_data.cached_shader = iter->second.get();
     } else {
-        auto shader = std::make_unique<JitShader>();
-        shader->Compile(&setup.program_code, &setup.swizzle_data);
+        std::unique_ptr<JitShader> shader;
+        if (VideoCore::g_shader_disk_cache != nullptr) {
+            shader = VideoCore::g_shader_disk_cache->TakeJitProgram(cache_key);
+            VideoCore::g_shader_disk_cache->RecordProgram(setup);
+        }
+        if (shader == nullptr) {
+            shader = std::make_unique<JitShader>();
+            shader->Compile(&setup.program_code, &setup.swizzle_data);
+        }
         setup.engine_data.cached_shader = shader.get();
         cache.emplace_hint(iter, cache_key, std::move(shader));
     }
@@ -44,5 +49,16 @@ void JitX64Engine::Run(const ShaderSetup& setup, UnitState& state) const {
     shader->Run(setup, state, setup.engine_data.entry_point);
 }
 
+void JitX64Engine::RunBatch(const ShaderSetup& setup, UnitState* states, unsigned count) const {
+    ASSERT(setup.engine_data.cached_shader != nullptr);
+
+    MICROPROFILE_SCOPE(GPU_Shader);
+
+    const JitShader* shader = static_cast<const JitShader*>(setup.engine_data.cached_shader);
+    for (unsigned i = 0; i < count; ++i) {
+        shader->Run(setup, states[i], setup.engine_data.entry_point);
+    }
+}
+
 } // namespace Shader
 } // namespace Pica
@@ -21,6 +21,7 @@ public:
 
     void SetupBatch(ShaderSetup& setup, unsigned int entry_point) override;
     void Run(const ShaderSetup& setup, UnitState& state) const override;
+    void RunBatch(const ShaderSetup& setup, UnitState* states, unsigned count) const override;
 
 private:
     std::unordered_map<u64, std::unique_ptr<JitShader>> cache;
@@ -0,0 +1,241 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include "common/assert.h"
+#include "common/file_util.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "video_core/shader_disk_cache.h"
+#ifdef ARCHITECTURE_x86_64
+#include "video_core/shader/shader_jit_x64_compiler.h"
+#endif // ARCHITECTURE_x86_64
+#include "video_core/video_core.h"
+
+namespace Pica {
+
+namespace {
+
+/**
+ * Version of the format of the entries, to be increased whenever it changes. Entries start with a
+ * word holding the version in its upper bits and the EntryType in its lowest byte, followed by the
+ * data of the shader.
+ */
+constexpr u32 FORMAT_VERSION = 1;
+
+enum class EntryType : u8 {
+    /// Length of the program code, followed by the program code and the swizzle data. Trailing zero
+    /// words of both arrays are omitted.
+    Program = 0,
+    /// PicaShaderConfig::State of the fragment shader
+    FragmentConfig = 1,
+};
+
+constexpr size_t FRAGMENT_CONFIG_WORDS =
+    (sizeof(GLShader::PicaShaderConfig::State) + sizeof(u32) - 1) / sizeof(u32);
+
+std::vector<u32> MakeEntry(EntryType type) {
+    return {FORMAT_VERSION << 8 | static_cast<u32>(type)};
+}
+
+u64 HashEntry(const u32* entry, size_t size) {
+    return Common::ComputeHash64(entry, size * sizeof(u32));
+}
+
+template <size_t N>
+size_t TrimTrailingZeros(const std::array<u32, N>& words) {
+    size_t length = N;
+    while (length != 0 && words[length - 1] == 0) {
+        --length;
+    }
+    return length;
+}
+
+/// Decodes the entries of the cache file, and counts the ones that are outdated or corrupted.
+class EntryReader final : public LinearDiskCacheReader<u64, u32> {
+public:
+    void Read(const u64& key, const u32* value, u32 value_size) override {
+        if (value_size == 0 || value[0] >> 8 != FORMAT_VERSION ||
+            key != HashEntry(value, value_size) || !Decode(value, value_size)) {
+            ++num_invalid_entries;
+            return;
+        }
+        entries.emplace_back(value, value + value_size);
+        hashes.push_back(key);
+    }
+
+    std::vector<std::unique_ptr<Shader::ShaderSetup>> programs;
+    std::vector<GLShader::PicaShaderConfig> fragment_configs;
+
+    /// Valid entries as read, to write them back when the file has invalid ones
+    std::vector<std::vector<u32>> entries;
+    std::vector<u64> hashes;
+    u32 num_invalid_entries = 0;
+
+private:
+    bool Decode(const u32* value, u32 value_size) {
+        const u32* data = value + 1;
+        const u32 data_size = value_size - 1;
+
+        switch (static_cast<EntryType>(value[0] & 0xFF)) {
+        case EntryType::Program: {
+            if (data_size == 0)
+                return false;
+            const u32 code_length = data[0];
+            if (code_length > Shader::MAX_PROGRAM_CODE_LENGTH || code_length > data_size - 1)
+                return false;
+            const u32 swizzle_length = data_size - 1 - code_length;
+            if (swizzle_length > Shader::MAX_SWIZZLE_DATA_LENGTH)
+                return false;
+
+            auto setup = std::make_unique<Shader::ShaderSetup>();
+            for (u32 i = 0; i < code_length; ++i) {
+                setup->WriteProgramCode(i, data[1 + i]);
+            }
+            for (u32 i = 0; i < swizzle_length; ++i) {
+                setup->WriteSwizzleData(i, data[1 + code_length + i]);
+            }
+            programs.push_back(std::move(setup));
+            return true;
+        }
+        case EntryType::FragmentConfig: {
+            if (data_size != FRAGMENT_CONFIG_WORDS)
+                return false;
+            GLShader::PicaShaderConfig config;
+            std::memcpy(&config.state, data, sizeof(config.state));
+            fragment_configs.push_back(config);
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+};
+
+} // Anonymous namespace
+
+ShaderDiskCache::ShaderDiskCache() = default;
+
+ShaderDiskCache::~ShaderDiskCache() {
+    stop_precompiling = true;
+    if (precompile_thread.joinable()) {
+        precompile_thread.join();
+    }
+    file.Close();
+}
+
+size_t ShaderDiskCache::Open(const std::string& path) {
+    FileUtil::CreateFullPath(path);
+
+    EntryReader reader;
+    file.OpenAndRead(path.c_str(), reader);
+    is_open = true;
+
+    programs = std::move(reader.programs);
+    fragment_configs = std::move(reader.fragment_configs);
+    known_entries.clear();
+    known_entries.insert(reader.hashes.begin(), reader.hashes.end());
+
+    // Write the valid entries back without the invalid ones
+    if (reader.num_invalid_entries != 0) {
+        LOG_INFO(Render, "Discarding %u outdated or corrupted entries of %s",
+                 reader.num_invalid_entries, path.c_str());
+        file.Close();
+        FileUtil::Delete(path);
+        EntryReader empty_reader;
+        file.OpenAndRead(path.c_str(), empty_reader);
+        for (size_t i = 0; i < reader.entries.size(); ++i) {
+            const std::vector<u32>& entry = reader.entries[i];
+            file.Append(reader.hashes[i], entry.data(), static_cast<u32>(entry.size()));
+        }
+        file.Sync();
+    }
+
+    return programs.size() + fragment_configs.size();
+}
+
+void ShaderDiskCache::StartPrecompiling() {
+    ASSERT(!precompile_thread.joinable());
+    precompile_thread = std::thread(&ShaderDiskCache::Precompile, this);
+}
+
+void ShaderDiskCache::Precompile() {
+#ifdef ARCHITECTURE_x86_64
+    if (VideoCore::g_shader_jit_enabled) {
+        for (const auto& setup : programs) {
+            if (stop_precompiling)
+                return;
+            const u64 program_hash = setup->GetProgramHash();
+            auto shader = std::make_unique<Shader::JitShader>();
+            shader->Compile(&setup->program_code, &setup->swizzle_data);
+            std::lock_guard<std::mutex> lock(precompiled_mutex);
+            precompiled_programs.emplace(program_hash, std::move(shader));
+        }
+    }
+#endif // ARCHITECTURE_x86_64
+
+    if (VideoCore::g_hw_renderer_enabled) {
+        for (const GLShader::PicaShaderConfig& config : fragment_configs) {
+            if (stop_precompiling)
+                return;
+            std::string source = GLShader::GenerateFragmentShader(config);
+            std::lock_guard<std::mutex> lock(precompiled_mutex);
+            precompiled_fragment_shaders.emplace_back(config, std::move(source));
+        }
+    }
+}
+
+void ShaderDiskCache::RecordProgram(const Shader::ShaderSetup& setup) {
+    const size_t code_length = TrimTrailingZeros(setup.program_code);
+    const size_t swizzle_length = TrimTrailingZeros(setup.swizzle_data);
+
+    std::vector<u32> entry = MakeEntry(EntryType::Program);
+    entry.reserve(2 + code_length + swizzle_length);
+    entry.push_back(static_cast<u32>(code_length));
+    entry.insert(entry.end(), setup.program_code.begin(), setup.program_code.begin() + code_length);
+    entry.insert(entry.end(), setup.swizzle_data.begin(),
+                 setup.swizzle_data.begin() + swizzle_length);
+    Append(entry);
+}
+
+void ShaderDiskCache::RecordFragmentConfig(const GLShader::PicaShaderConfig& config) {
+    std::vector<u32> entry = MakeEntry(EntryType::FragmentConfig);
+    entry.resize(1 + FRAGMENT_CONFIG_WORDS);
+    std::memcpy(&entry[1], &config.state, sizeof(config.state));
+    Append(entry);
+}
+
+void ShaderDiskCache::Append(const std::vector<u32>& entry) {
+    const u64 hash = HashEntry(entry.data(), entry.size());
+
+    std::lock_guard<std::mutex> lock(file_mutex);
+    if (!is_open || !known_entries.insert(hash).second)
+        return;
+
+    // Shaders are rarely recorded, so they are written right away to survive crashes
+    file.Append(hash, entry.data(), static_cast<u32>(entry.size()));
+    file.Sync();
+}
+
+#ifdef ARCHITECTURE_x86_64
+std::unique_ptr<Shader::JitShader> ShaderDiskCache::TakeJitProgram(u64 program_hash) {
+    std::lock_guard<std::mutex> lock(precompiled_mutex);
+    auto iter = precompiled_programs.find(program_hash);
+    if (iter == precompiled_programs.end())
+        return nullptr;
+    std::unique_ptr<Shader::JitShader> shader = std::move(iter->second);
+    precompiled_programs.erase(iter);
+    return shader;
+}
+#endif // ARCHITECTURE_x86_64
+
+std::vector<std::pair<GLShader::PicaShaderConfig, std::string>>
+ShaderDiskCache::TakeFragmentShaders() {
+    std::vector<std::pair<GLShader::PicaShaderConfig, std::string>> shaders;
+    std::lock_guard<std::mutex> lock(precompiled_mutex);
+    shaders.swap(precompiled_fragment_shaders);
+    return shaders;
+}
+
+} // namespace Pica
@@ -0,0 +1,110 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "common/common_types.h"
+#include "common/linear_disk_cache.h"
+#include "video_core/renderer_opengl/gl_shader_gen.h"
+#include "video_core/shader/shader.h"
+
+namespace Pica {
+
+namespace Shader {
+class JitShader;
+} // namespace Shader
+
+/**
+ * Persistent record of the shaders a title used, so that they can be compiled when the title boots
+ * instead of when they are first drawn with.
+ *
+ * Two kinds of shaders are recorded: the PICA shader programs compiled by the shader JIT, and the
+ * configurations of the fragment shaders generated by the OpenGL rasterizer. Once the cache is
+ * opened, a background thread compiles the programs and generates the GLSL sources of the
+ * fragment shaders, which the shader JIT and the rasterizer take instead of compiling them again.
+ * The GLSL sources still have to be compiled by the rasterizer, on the thread of its GL context.
+ *
+ * On disk, the cache of each title is a LinearDiskCache holding one entry per shader, keyed by the
+ * hash of the entry. The header of the file holds the revision of the build that wrote it, and
+ * every entry starts with the version of the entry format. Entries of other format versions, or
+ * whose data doesn't match their hash, are discarded when the cache is opened.
+ */
+class ShaderDiskCache final {
+public:
+    ShaderDiskCache();
+    ~ShaderDiskCache();
+
+    /**
+     * Opens a cache file, creating it if needed.
+     * @param path Path of the cache file of the title.
+     * @returns The number of valid shaders in the cache.
+     */
+    size_t Open(const std::string& path);
+
+    /// Starts compiling the shaders of the cache on a background thread
+    void StartPrecompiling();
+
+    /// Adds the shader program of a setup to the cache, unless it is already cached
+    void RecordProgram(const Shader::ShaderSetup& setup);
+
+    /// Adds the configuration of a fragment shader to the cache, unless it is already cached
+    void RecordFragmentConfig(const GLShader::PicaShaderConfig& config);
+
+    /// Returns the shader programs read from the cache file
+    const std::vector<std::unique_ptr<Shader::ShaderSetup>>& GetPrograms() const {
+        return programs;
+    }
+
+    /// Returns the fragment shader configurations read from the cache file
+    const std::vector<GLShader::PicaShaderConfig>& GetFragmentConfigs() const {
+        return fragment_configs;
+    }
+
+#ifdef ARCHITECTURE_x86_64
+    /**
+     * Takes a program compiled by the background thread.
+     * @param program_hash Hash of the program, as returned by ShaderSetup::GetProgramHash.
+     * @returns The compiled program, or nullptr if it hasn't been compiled (yet).
+     */
+    std::unique_ptr<Shader::JitShader> TakeJitProgram(u64 program_hash);
+#endif // ARCHITECTURE_x86_64
+
+    /// Takes the fragment shader sources generated by the background thread since the last call
+    std::vector<std::pair<GLShader::PicaShaderConfig, std::string>> TakeFragmentShaders();
+
+private:
+    void Append(const std::vector<u32>& entry);
+    void Precompile();
+
+    LinearDiskCache<u64, u32> file;
+    bool is_open = false;
+
+    /// Hashes of the entries in the cache file. Guarded by file_mutex along with the file.
+    std::unordered_set<u64> known_entries;
+    std::mutex file_mutex;
+
+    std::vector<std::unique_ptr<Shader::ShaderSetup>> programs;
+    std::vector<GLShader::PicaShaderConfig> fragment_configs;
+
+    std::thread precompile_thread;
+    std::atomic<bool> stop_precompiling{false};
+
+    /// Results of the background thread, guarded by precompiled_mutex
+#ifdef ARCHITECTURE_x86_64
+    std::unordered_map<u64, std::unique_ptr<Shader::JitShader>> precompiled_programs;
+#endif // ARCHITECTURE_x86_64
+    std::vector<std::pair<GLShader::PicaShaderConfig, std::string>> precompiled_fragment_shaders;
+    std::mutex precompiled_mutex;
+};
+
+} // namespace Pica
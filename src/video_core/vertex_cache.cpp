@@ -0,0 +1,25 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "common/assert.h"
+#include "video_core/vertex_cache.h"
+
+namespace Pica {
+
+VertexCache::VertexCache(size_t size) : tags(size, Tag{0, 0}), outputs(size), mask(size - 1) {
+    ASSERT_MSG(size != 0 && (size & mask) == 0, "The vertex cache size must be a power of two");
+}
+
+void VertexCache::BeginDraw(u32 min_index) {
+    base_index = min_index;
+
+    // Draw 0 is never current, so that the initial tags don't match
+    if (++current_draw == 0) {
+        std::fill(tags.begin(), tags.end(), Tag{0, 0});
+        current_draw = 1;
+    }
+}
+
+} // namespace Pica
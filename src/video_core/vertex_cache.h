@@ -0,0 +1,94 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "common/common_types.h"
+#include "video_core/shader/shader.h"
+
+namespace Pica {
+
+/**
+ * Direct-mapped cache of the vertex shader outputs of an indexed draw, so that vertices referenced
+ * several times by the index buffer are only shaded once.
+ *
+ * Vertices are mapped to entries by their index relative to the smallest index of the draw, found
+ * by a prepass over the index buffer. Draws whose index range fits in the cache thus never shade a
+ * vertex twice, and the others only when two of their vertices map to the same entry.
+ */
+class VertexCache {
+public:
+    struct Stats {
+        u64 hits = 0;
+        u64 misses = 0;
+    };
+
+    /// @param size Number of cached vertices, must be a power of two
+    explicit VertexCache(size_t size);
+
+    /**
+     * Invalidates all entries, for a draw whose indices are greater or equal to min_index.
+     */
+    void BeginDraw(u32 min_index);
+
+    /// Returns the entry a vertex maps to
+    size_t GetEntry(u32 vertex) const {
+        return (vertex - base_index) & mask;
+    }
+
+    /// Returns whether the output of a vertex is cached, without counting it as a lookup
+    bool Contains(u32 vertex) const {
+        const size_t entry = GetEntry(vertex);
+        return tags[entry].vertex == vertex && tags[entry].draw == current_draw;
+    }
+
+    /// Returns the cached output of a vertex, or nullptr if it isn't cached
+    const Shader::AttributeBuffer* Lookup(u32 vertex) {
+        if (Contains(vertex)) {
+            ++stats.hits;
+            return &outputs[GetEntry(vertex)];
+        }
+        ++stats.misses;
+        return nullptr;
+    }
+
+    /**
+     * Replaces the entry of a vertex with it, and returns the output to fill in. Lookups of the
+     * vertex succeed right away, before the output is written.
+     */
+    Shader::AttributeBuffer& Insert(u32 vertex) {
+        const size_t entry = GetEntry(vertex);
+        tags[entry] = {vertex, current_draw};
+        return outputs[entry];
+    }
+
+    size_t GetSize() const {
+        return outputs.size();
+    }
+
+    /// Returns and resets the statistics collected since the last call
+    Stats TakeStats() {
+        Stats result = stats;
+        stats = {};
+        return result;
+    }
+
+private:
+    struct Tag {
+        u32 vertex;
+        /// Entries from previous draws are invalid, which avoids clearing the tags on every draw
+        u32 draw;
+    };
+
+    std::vector<Tag> tags;
+    std::vector<Shader::AttributeBuffer> outputs;
+    size_t mask;
+    u32 base_index = 0;
+    u32 current_draw = 0;
+    Stats stats;
+};
+
+} // namespace Pica
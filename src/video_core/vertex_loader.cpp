@@ -1,9 +1,11 @@
+#include <cstddef>
 #include <memory>
 #include <boost/range/algorithm/fill.hpp>
 #include "common/alignment.h"
 #include "common/assert.h"
 #include "common/bit_field.h"
 #include "common/common_types.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/vector_math.h"
 #include "core/memory.h"
@@ -13,9 +15,30 @@
 #include "video_core/regs_pipeline.h"
 #include "video_core/shader/shader.h"
 #include "video_core/vertex_loader.h"
+#include "video_core/video_core.h"
+
+#ifdef ARCHITECTURE_x86_64
+#include "video_core/vertex_loader_jit_x64.h"
+#endif // ARCHITECTURE_x86_64
 
 namespace Pica {
 
+VertexLoader::VertexLoader() = default;
+
+VertexLoader::VertexLoader(const PipelineRegs& regs) {
+    Setup(regs);
+}
+
+VertexLoader::~VertexLoader() = default;
+
+u64 VertexLoader::HashLayout(const PipelineRegs& regs) {
+    // The base address is the first register, and the only one a loader doesn't depend on
+    const auto& attribute_config = regs.vertex_attributes;
+    constexpr size_t layout_offset = sizeof(u32);
+    return Common::ComputeHash64(reinterpret_cast<const u8*>(&attribute_config) + layout_offset,
+                                 sizeof(attribute_config) - layout_offset);
+}
+
 void VertexLoader::Setup(const PipelineRegs& regs) {
     ASSERT_MSG(!is_setup, "VertexLoader is not intended to be setup more than once.");
 
@@ -70,16 +93,51 @@ void VertexLoader::Setup(const PipelineRegs& regs) {
     is_setup = true;
 }
 
-void VertexLoader::LoadVertex(u32 base_address, int index, int vertex,
-                              Shader::AttributeBuffer& input,
-                              DebugUtils::MemoryAccessTracker& memory_accesses) {
+void VertexLoader::BeginDraw(u32 base_address) {
     ASSERT_MSG(is_setup, "A VertexLoader needs to be setup before loading vertices.");
 
+    this->base_address = base_address;
+
+    bool all_arrays_mapped = true;
+    for (int i = 0; i < num_total_attributes; ++i) {
+        if (vertex_attribute_elements[i] != 0) {
+            attribute_pointers[i] =
+                Memory::GetPhysicalPointer(base_address + vertex_attribute_sources[i]);
+            all_arrays_mapped &= attribute_pointers[i] != nullptr;
+        }
+    }
+
+    // The compiled loader doesn't record the memory accesses of traces
+    use_jit = false;
+#ifdef ARCHITECTURE_x86_64
+    if (VideoCore::g_shader_jit_enabled && all_arrays_mapped &&
+        !(g_debug_context && g_debug_context->recorder)) {
+        if (jit == nullptr) {
+            jit = std::make_unique<VertexLoaderJitX64>(*this);
+        }
+        use_jit = true;
+    }
+#endif // ARCHITECTURE_x86_64
+}
+
+void VertexLoader::LoadVertex(int index, int vertex, Shader::AttributeBuffer& input,
+                              DebugUtils::MemoryAccessTracker& memory_accesses) {
+#ifdef ARCHITECTURE_x86_64
+    if (use_jit) {
+        jit->LoadVertex(attribute_pointers.data(), vertex, input);
+        return;
+    }
+#endif // ARCHITECTURE_x86_64
+
     for (int i = 0; i < num_total_attributes; ++i) {
         if (vertex_attribute_elements[i] != 0) {
             // Load per-vertex data from the loader arrays
             u32 source_addr =
                 base_address + vertex_attribute_sources[i] + vertex_attribute_strides[i] * vertex;
+            const u8* source_data =
+                attribute_pointers[i] != nullptr
+                    ? attribute_pointers[i] + vertex_attribute_strides[i] * vertex
+                    : Memory::GetPhysicalPointer(source_addr);
 
             if (g_debug_context && Pica::g_debug_context->recorder) {
                 memory_accesses.AddAccess(
@@ -95,32 +153,28 @@ void VertexLoader::LoadVertex(u32 base_address, int index, int vertex,
 
             switch (vertex_attribute_formats[i]) {
             case PipelineRegs::VertexAttributeFormat::BYTE: {
-                const s8* srcdata =
-                    reinterpret_cast<const s8*>(Memory::GetPhysicalPointer(source_addr));
+                const s8* srcdata = reinterpret_cast<const s8*>(source_data);
                 for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
                     input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
                 }
                 break;
             }
             case PipelineRegs::VertexAttributeFormat::UBYTE: {
-                const u8* srcdata =
-                    reinterpret_cast<const u8*>(Memory::GetPhysicalPointer(source_addr));
+                const u8* srcdata = reinterpret_cast<const u8*>(source_data);
                 for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
                     input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
                 }
                 break;
             }
             case PipelineRegs::VertexAttributeFormat::SHORT: {
-                const s16* srcdata =
-                    reinterpret_cast<const s16*>(Memory::GetPhysicalPointer(source_addr));
+                const s16* srcdata = reinterpret_cast<const s16*>(source_data);
                 for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
                     input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
                 }
                 break;
             }
             case PipelineRegs::VertexAttributeFormat::FLOAT: {
-                const float* srcdata =
-                    reinterpret_cast<const float*>(Memory::GetPhysicalPointer(source_addr));
+                const float* srcdata = reinterpret_cast<const float*>(source_data);
                 for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
                     input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
                 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <memory>
 #include "common/common_types.h"
 #include "video_core/regs_pipeline.h"
 
@@ -14,15 +15,30 @@ namespace Shader {
 struct AttributeBuffer;
 }
 
+class VertexLoaderJitX64;
+
 class VertexLoader {
 public:
-    VertexLoader() = default;
-    explicit VertexLoader(const PipelineRegs& regs) {
-        Setup(regs);
-    }
+    VertexLoader();
+    explicit VertexLoader(const PipelineRegs& regs);
+    ~VertexLoader();
+
+    /**
+     * Returns the hash of the loader registers, without the base address. Draws with the same hash
+     * can share a VertexLoader.
+     */
+    static u64 HashLayout(const PipelineRegs& regs);
 
     void Setup(const PipelineRegs& regs);
-    void LoadVertex(u32 base_address, int index, int vertex, Shader::AttributeBuffer& input,
+
+    /**
+     * Prepares loading the vertices of a draw, resolving the host pointers to its attribute arrays.
+     * Must be called before the vertices of each draw are loaded.
+     * @param base_address Physical address the attribute arrays are relative to.
+     */
+    void BeginDraw(u32 base_address);
+
+    void LoadVertex(int index, int vertex, Shader::AttributeBuffer& input,
                     DebugUtils::MemoryAccessTracker& memory_accesses);
 
     int GetNumTotalAttributes() const {
@@ -37,6 +53,18 @@ private:
     std::array<bool, 16> vertex_attribute_is_default;
     int num_total_attributes = 0;
     bool is_setup = false;
+
+    u32 base_address = 0;
+    /// Host pointers to the first vertex of each attribute array of the current draw
+    std::array<const u8*, 16> attribute_pointers{};
+    /// Whether the vertices of the current draw are loaded with the compiled loader
+    bool use_jit = false;
+
+#ifdef ARCHITECTURE_x86_64
+    friend class VertexLoaderJitX64;
+    /// Compiled on the first draw using it with the shader JIT enabled
+    std::unique_ptr<VertexLoaderJitX64> jit;
+#endif // ARCHITECTURE_x86_64
 };
 
 } // namespace Pica
@@ -0,0 +1,184 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstddef>
+#include <xbyak.h>
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/vector_math.h"
+#include "common/x64/xbyak_abi.h"
+#include "video_core/pica_state.h"
+#include "video_core/pica_types.h"
+#include "video_core/shader/shader.h"
+#include "video_core/vertex_loader.h"
+#include "video_core/vertex_loader_jit_x64.h"
+
+using namespace Common::X64;
+using namespace Xbyak::util;
+using Xbyak::Reg;
+using Xbyak::Reg32;
+using Xbyak::Reg64;
+using Xbyak::Xmm;
+
+namespace Pica {
+
+constexpr size_t MAX_LOADER_SIZE = 4096;
+
+static_assert(sizeof(Math::Vec4<float24>) == 16, "Attributes must fit in one SSE register");
+
+/// Host pointers to the first vertex of each attribute array
+static const Reg ATTRIBUTE_POINTERS = ABI_PARAM1;
+/// Index of the vertex being loaded
+static const Reg32 VERTEX = ABI_PARAM2.cvt32();
+/// Pointer to the AttributeBuffer being filled
+static const Reg INPUT = ABI_PARAM3;
+/// Address of the components of the attribute being loaded
+static const Reg64 SOURCE = rax;
+/// Scratch registers. Like SOURCE, these are caller-saved in both the Windows and SysV ABIs.
+static const Reg64 SCRATCH = r10;
+static const Reg64 SCRATCH2 = r11;
+/// Components of the attribute being loaded
+static const Xmm COMPONENTS = xmm0;
+/// SIMD scratch register
+static const Xmm SCRATCH_XMM = xmm1;
+/// Constant vector of zeros, used to widen unsigned components
+static const Xmm ZERO = xmm2;
+
+static size_t GetComponentSize(PipelineRegs::VertexAttributeFormat format) {
+    switch (format) {
+    case PipelineRegs::VertexAttributeFormat::FLOAT:
+        return 4;
+    case PipelineRegs::VertexAttributeFormat::SHORT:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+VertexLoaderJitX64::VertexLoaderJitX64(const VertexLoader& loader)
+    : Xbyak::CodeGenerator(MAX_LOADER_SIZE) {
+    // Missing components are set to 0.0, which the loads already leave in the upper lanes, except
+    // for w which is set to 1.0
+    align(16);
+    const void* w_one_vector = getCurr();
+    dd(0);
+    dd(0);
+    dd(0);
+    dd(0x3f800000);
+
+    align(16);
+    program = (CompiledLoader*)getCurr();
+
+    pxor(ZERO, ZERO);
+
+    for (int i = 0; i < loader.num_total_attributes; ++i) {
+        const size_t attribute_offset = i * sizeof(Math::Vec4<float24>);
+
+        if (loader.vertex_attribute_elements[i] != 0) {
+            const u32 stride = loader.vertex_attribute_strides[i];
+
+            mov(SOURCE, qword[ATTRIBUTE_POINTERS + i * sizeof(const u8*)]);
+            if (stride != 0) {
+                imul(SCRATCH.cvt32(), VERTEX, stride);
+                add(SOURCE, SCRATCH);
+            }
+
+            Compile_LoadComponents(loader.vertex_attribute_formats[i],
+                                   loader.vertex_attribute_elements[i]);
+            Compile_ConvertComponents(loader.vertex_attribute_formats[i]);
+            if (loader.vertex_attribute_elements[i] < 4) {
+                orps(COMPONENTS, xword[rip + w_one_vector]);
+            }
+            movaps(xword[INPUT + attribute_offset], COMPONENTS);
+        } else if (loader.vertex_attribute_is_default[i]) {
+            // The default attributes can change between draws, so they are read at run time
+            mov(SOURCE, reinterpret_cast<uintptr_t>(&g_state.input_default_attributes.attr[i]));
+            movaps(COMPONENTS, xword[SOURCE]);
+            movaps(xword[INPUT + attribute_offset], COMPONENTS);
+        }
+    }
+
+    ret();
+
+    ready();
+
+    ASSERT_MSG(getSize() <= MAX_LOADER_SIZE,
+               "Compiled a vertex loader that exceeds the allocated size!");
+    LOG_DEBUG(HW_GPU, "Compiled vertex loader size=%lu", getSize());
+}
+
+/**
+ * Loads the raw components of an attribute from SOURCE into the lower bytes of COMPONENTS, zeroing
+ * the rest of the register. Exactly the bytes of the attribute are read, as the attribute can be
+ * the last thing in the memory region of the array.
+ */
+void VertexLoaderJitX64::Compile_LoadComponents(PipelineRegs::VertexAttributeFormat format,
+                                                u32 elements) {
+    switch (elements * GetComponentSize(format)) {
+    case 1:
+        movzx(SCRATCH.cvt32(), byte[SOURCE]);
+        movd(COMPONENTS, SCRATCH.cvt32());
+        break;
+    case 2:
+        movzx(SCRATCH.cvt32(), word[SOURCE]);
+        movd(COMPONENTS, SCRATCH.cvt32());
+        break;
+    case 3:
+        movzx(SCRATCH.cvt32(), word[SOURCE]);
+        movzx(SCRATCH2.cvt32(), byte[SOURCE + 2]);
+        shl(SCRATCH2.cvt32(), 16);
+        or_(SCRATCH.cvt32(), SCRATCH2.cvt32());
+        movd(COMPONENTS, SCRATCH.cvt32());
+        break;
+    case 4:
+        movd(COMPONENTS, dword[SOURCE]);
+        break;
+    case 6:
+        movd(COMPONENTS, dword[SOURCE]);
+        movzx(SCRATCH.cvt32(), word[SOURCE + 4]);
+        movd(SCRATCH_XMM, SCRATCH.cvt32());
+        punpckldq(COMPONENTS, SCRATCH_XMM);
+        break;
+    case 8:
+        movq(COMPONENTS, qword[SOURCE]);
+        break;
+    case 12:
+        movq(COMPONENTS, qword[SOURCE]);
+        movd(SCRATCH_XMM, dword[SOURCE + 8]);
+        punpcklqdq(COMPONENTS, SCRATCH_XMM);
+        break;
+    case 16:
+        movups(COMPONENTS, xword[SOURCE]);
+        break;
+    default:
+        UNREACHABLE();
+    }
+}
+
+/// Widens the components in COMPONENTS to 32 bits and converts them to floats
+void VertexLoaderJitX64::Compile_ConvertComponents(PipelineRegs::VertexAttributeFormat format) {
+    switch (format) {
+    case PipelineRegs::VertexAttributeFormat::BYTE:
+        // Move each byte to the top of its lane, then shift it back down with sign extension
+        punpcklbw(COMPONENTS, COMPONENTS);
+        punpcklwd(COMPONENTS, COMPONENTS);
+        psrad(COMPONENTS, 24);
+        cvtdq2ps(COMPONENTS, COMPONENTS);
+        break;
+    case PipelineRegs::VertexAttributeFormat::UBYTE:
+        punpcklbw(COMPONENTS, ZERO);
+        punpcklwd(COMPONENTS, ZERO);
+        cvtdq2ps(COMPONENTS, COMPONENTS);
+        break;
+    case PipelineRegs::VertexAttributeFormat::SHORT:
+        punpcklwd(COMPONENTS, COMPONENTS);
+        psrad(COMPONENTS, 16);
+        cvtdq2ps(COMPONENTS, COMPONENTS);
+        break;
+    case PipelineRegs::VertexAttributeFormat::FLOAT:
+        break;
+    }
+}
+
+} // namespace Pica
@@ -0,0 +1,49 @@
+// Copyright 2017 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <xbyak.h>
+#include "common/common_types.h"
+#include "video_core/regs_pipeline.h"
+
+namespace Pica {
+
+namespace Shader {
+struct AttributeBuffer;
+}
+
+class VertexLoader;
+
+/**
+ * Loads the vertices of one attribute layout with x86_64 code generated for it: the attribute
+ * strides and formats are baked into the code, and the components of each attribute are converted
+ * and padded with the default values in SSE registers.
+ */
+class VertexLoaderJitX64 : public Xbyak::CodeGenerator {
+public:
+    explicit VertexLoaderJitX64(const VertexLoader& loader);
+
+    /**
+     * Loads the attributes of a vertex.
+     * @param attribute_pointers Host pointers to the first vertex of each attribute array.
+     * @param vertex Index of the vertex in the attribute arrays.
+     * @param input Buffer receiving the attributes.
+     */
+    void LoadVertex(const u8* const* attribute_pointers, u32 vertex,
+                    Shader::AttributeBuffer& input) const {
+        program(attribute_pointers, vertex, &input);
+    }
+
+private:
+    void Compile_LoadComponents(PipelineRegs::VertexAttributeFormat format, u32 elements);
+    void Compile_ConvertComponents(PipelineRegs::VertexAttributeFormat format);
+
+    using CompiledLoader = void(const u8* const* attribute_pointers, u32 vertex,
+                                Shader::AttributeBuffer* input);
+
+    CompiledLoader* program = nullptr;
+};
+
+} // namespace Pica
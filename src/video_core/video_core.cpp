@@ -2,11 +2,16 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cinttypes>
 #include <memory>
+#include "common/file_util.h"
 #include "common/logging/log.h"
+#include "common/string_util.h"
+#include "video_core/gpu_thread.h"
 #include "video_core/pica.h"
 #include "video_core/renderer_base.h"
 #include "video_core/renderer_opengl/renderer_opengl.h"
+#include "video_core/shader_disk_cache.h"
 #include "video_core/video_core.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -16,11 +21,13 @@ namespace VideoCore {
 
 EmuWindow* g_emu_window = nullptr;        ///< Frontend emulator window
 std::unique_ptr<RendererBase> g_renderer; ///< Renderer plugin
+std::unique_ptr<Pica::ShaderDiskCache> g_shader_disk_cache;
 
 std::atomic<bool> g_hw_renderer_enabled;
 std::atomic<bool> g_shader_jit_enabled;
 std::atomic<bool> g_vsync_enabled;
 std::atomic<bool> g_toggle_framelimit_enabled;
+std::atomic<bool> g_gpu_thread_enabled;
 
 /// Initialize the video core
 bool Init(EmuWindow* emu_window) {
@@ -35,11 +42,27 @@ bool Init(EmuWindow* emu_window) {
         LOG_ERROR(Render, "initialization failed !");
         return false;
     }
+    Pica::GPUThread::Start();
     return true;
 }
 
+void LoadShaderDiskCache(u64 program_id) {
+    const std::string path =
+        Common::StringFromFormat("%sshaders/%016" PRIX64 ".bin",
+                                 FileUtil::GetUserPath(D_CACHE_IDX).c_str(), program_id);
+
+    g_shader_disk_cache = std::make_unique<Pica::ShaderDiskCache>();
+    const size_t num_shaders = g_shader_disk_cache->Open(path);
+    g_shader_disk_cache->StartPrecompiling();
+
+    LOG_INFO(Render, "Loaded %zu shaders from the shader disk cache %s", num_shaders,
+             path.c_str());
+}
+
 /// Shutdown the video core
 void Shutdown() {
+    Pica::GPUThread::Stop();
+    g_shader_disk_cache.reset();
     Pica::Shutdown();
 
     g_renderer.reset();
@@ -6,10 +6,15 @@
 
 #include <atomic>
 #include <memory>
+#include "common/common_types.h"
 
 class EmuWindow;
 class RendererBase;
 
+namespace Pica {
+class ShaderDiskCache;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Video Core namespace
 
@@ -17,12 +22,15 @@ namespace VideoCore {
 
 extern std::unique_ptr<RendererBase> g_renderer; ///< Renderer plugin
 extern EmuWindow* g_emu_window;                  ///< Emu window
+/// Shader disk cache of the running title, null when disabled
+extern std::unique_ptr<Pica::ShaderDiskCache> g_shader_disk_cache;
 
 // TODO: Wrap these in a user settings struct along with any other graphics settings (often set from
 // qt ui)
 extern std::atomic<bool> g_hw_renderer_enabled;
 extern std::atomic<bool> g_shader_jit_enabled;
 extern std::atomic<bool> g_toggle_framelimit_enabled;
+extern std::atomic<bool> g_gpu_thread_enabled;
 
 /// Start the video core
 void Start();
@@ -30,6 +38,13 @@ void Start();
 /// Initialize the video core
 bool Init(EmuWindow* emu_window);
 
+/**
+ * Opens the shader disk cache of a title, and starts compiling the shaders it recorded in previous
+ * runs on a background thread.
+ * @param program_id Program ID of the title.
+ */
+void LoadShaderDiskCache(u64 program_id);
+
 /// Shutdown the video core
 void Shutdown();
 